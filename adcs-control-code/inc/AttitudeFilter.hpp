@@ -0,0 +1,134 @@
+/**
+ * @file AttitudeFilter.hpp
+ *
+ * @details Header file for the attitude Kalman filter, which sits between the gyroscope and the
+ * pointing mode controller to filter the sensor noise out of the measured attitude.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+**/
+
+#pragma once
+
+#include "def_interface.hpp"
+
+/**
+* @struct attitude_filter_config
+*
+* @details Settings of the attitude filter.
+*
+* @param enabled        true to filter the gyroscope measurements, false to use them as measured.
+* @param angle_noise    standard deviation of the measured angle of each axis, in rad.
+* @param rate_noise     standard deviation of the measured angular velocity of each axis, in rad/s.
+* @param process_noise  standard deviation of the unmodelled angular acceleration, in rad/s^2.
+*                       Larger values follow manoeuvres faster but filter less.
+**/
+typedef struct {
+    bool  enabled;
+    float angle_noise;
+    float rate_noise;
+    float process_noise;
+} attitude_filter_config;
+
+/**
+* @class AttitudeKalmanFilter
+*
+* @details Kalman filter of the attitude and angular velocity of each axis, with a constant
+* velocity model driven by white noise acceleration. Every axis has the same model and noise, so
+* the axes share one 2x2 covariance and gain, and the state of the three axes is one fixed size
+* 2x3 matrix. An update is a handful of fixed size operations and never allocates.
+**/
+class AttitudeKalmanFilter {
+public:
+    /**
+    * @struct filter_state
+    *
+    * @details Everything the filter carries from one measurement to the next. Saved in a
+    * checkpoint with the controller loop.
+    *
+    * @param initialized   false until the first measurement.
+    * @param time          time of the last measurement.
+    * @param x             estimate of each axis, one column per axis: angle, then angular velocity.
+    * @param P             covariance of the estimate, shared by every axis.
+   **/
+    typedef struct {
+        bool                       initialized;
+        timestamp                  time;
+        Eigen::Matrix<float, 2, 3> x;
+        Eigen::Matrix2f            P;
+    } filter_state;
+
+    /**
+    * @class AttitudeKalmanFilter
+    * @param config [attitude_filter_config], the settings of the filter
+    *
+    * @details Constructor for the filter. The noise variances are computed here once.
+   **/
+    AttitudeKalmanFilter(const attitude_filter_config &config);
+
+    /**
+    * @name enabled
+    * @returns [bool], true if measurements should be filtered
+   **/
+    inline bool enabled() const { return config.enabled; }
+
+    /**
+    * @name reset
+    *
+    * @details Forgets the estimate, the next measurement starts the filter again.
+   **/
+    void reset();
+
+    /**
+    * @name update
+    * @param m [gyro_state], the new gyroscope measurement
+    * @returns [gyro_state], the measurement with the filtered angle and angular velocity
+    *
+    * @details Predicts the estimate forward to the time of the measurement, then corrects it with
+    * the measured angle and angular velocity. The first measurement is taken as is.
+   **/
+    gyro_state update(const gyro_state &m);
+
+    /**
+    * @name get_state
+    * @returns [filter_state], the state of the filter after its last measurement
+   **/
+    inline const filter_state &get_state() const { return state; }
+
+    /**
+    * @name restore_state
+    * @param saved [filter_state], the state to continue from
+   **/
+    inline void restore_state(const filter_state &saved) { state = saved; }
+
+private:
+    /**
+    * @property config [attitude_filter_config]
+    *
+    * @details The settings of the filter.
+   **/
+    const attitude_filter_config config;
+
+    /**
+    * @property R [Eigen::Matrix2f]
+    *
+    * @details The covariance of the measured angle and angular velocity.
+   **/
+    Eigen::Matrix2f R;
+
+    /**
+    * @property q [float]
+    *
+    * @details The variance of the process noise acceleration.
+   **/
+    float q;
+
+    /**
+    * @property state [filter_state]
+    *
+    * @details The current estimate.
+   **/
+    filter_state state;
+};
@@ -0,0 +1,43 @@
+/**
+ * @file ControllerGains.hpp
+ *
+ * @details Header file for the gains of the pointing mode controller, so they can be set from the
+ * config yaml and tuned without rebuilding the controller.
+ *
+ * @authors Justin Paoli, Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+**/
+
+#pragma once
+
+#include <Eigen/Dense>
+
+/**
+* @struct controller_gains
+*
+* @details Gains of the PID controller of the pointing mode controller.
+*
+* @param kp  proportional gain of each axis.
+* @param kd  derivative gain of each axis.
+* @param ki  integral gain of each axis.
+* @param N   filter coefficient of the derivative term.
+**/
+typedef struct {
+    Eigen::Vector3f kp;
+    Eigen::Vector3f kd;
+    Eigen::Vector3f ki;
+    float           N;
+} controller_gains;
+
+/**
+* @name default_controller_gains
+* @returns [controller_gains], the gains the controller was tuned with for the test satellite.
+**/
+inline controller_gains default_controller_gains() {
+    return {Eigen::Vector3f(0.0002, 0.0002, 0.0002),
+            Eigen::Vector3f(0.005544, 0.005775, 0.0052472),
+            Eigen::Vector3f(0.00001, 0.0000096, 0.00001057),
+            1};
+}
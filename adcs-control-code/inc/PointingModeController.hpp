@@ -6,56 +6,133 @@
  * @authors Justin Paoli, Aidan Sheedy
  *
  * Last Edited
- * 2022-11-13
+ * 2026-10-14
 **/
 
 #pragma once
 
-#include <unordered_map>
+#include <vector>
 #include "interface.hpp"
+#include "AttitudeFilter.hpp"
+#include "ControllerGains.hpp"
 
 class PointingModeController {
 public:
+    /**
+    * @struct loop_state
+    *
+    * @details Everything the command loop carries from one cycle to the next. Saved in a
+    * checkpoint so a run can be resumed where it stopped.
+    *
+    * @param started           false until the first measurement of the loop has been taken.
+    * @param initial_attitude  attitude at the start of the loop, the start of the ramp.
+    * @param start             time of the first measurement.
+    * @param prev_time         time of the last measurement.
+    * @param prev_error        error term of the last cycle.
+    * @param prev_derivative   derivative term of the last cycle.
+    * @param prev_integral     integral term of the last cycle.
+    * @param filter            state of the attitude filter.
+   **/
+    typedef struct {
+        bool            started;
+        Eigen::Vector3f initial_attitude;
+        timestamp       start;
+        timestamp       prev_time;
+        Eigen::Vector3f prev_error;
+        Eigen::Vector3f prev_derivative;
+        Eigen::Vector3f prev_integral;
+        AttitudeKalmanFilter::filter_state filter;
+    } loop_state;
+
     /**
     * @class PointingModeController
-    * @param sensors [unordered_map<string, shared_ptr<Sensor>], pointers to the satellite sensors
-    * @param actuators [unordered_map<string, shared_ptr<Actuator>], pointers to the satellite actuators
+    * @param devices [device_registry], pointers to the satellite sensors and actuators
+    * @param timer [ADCS_timer *], the timer used to sleep between cycles
+    * @param filter_config [attitude_filter_config], the settings of the attitude filter applied to
+    * the gyroscope measurements. Optional, measurements are used unfiltered by default.
+    * @param gains [controller_gains], the gains of the PID controller. Optional, see
+    * default_controller_gains.
     *
     * @details Constructor for the pointing mode controller class. Initializes the internal references
     * to the satellite sensors and actuators which will be used to request information from the sensors
-    * and send commands to the actuators.
+    * and send commands to the actuators. The devices must outlive the controller. Everything that only depends on the reaction wheel
+    * configuration, such as the torque allocation matrix, is computed here once.
    **/
-    PointingModeController(
-        std::unordered_map<std::string, std::shared_ptr<Sensor>> sensors,
-        std::unordered_map<std::string, std::shared_ptr<Actuator>> actuators,
-        ADCS_timer *timer
-    );
+    PointingModeController(const device_registry &devices, ADCS_timer *timer,
+                           const attitude_filter_config &filter_config = attitude_filter_config(),
+                           const controller_gains &gains = default_controller_gains());
 
     /**
     * @name begin
     * @param desired_attitue [vector<float>], the desired angle to point at
     * @param ramp_time [timestamp], the time over which to ramp to the new desired attitude
     *
-    * @details Starts the command loop. Should call the update functions once per cycle to get
-    * updated sensor measurements and sent commands to actuators accordingly
+    * @details Starts the command loop and runs it forever, sleeping on the timer between steps.
+    * Should call the update functions once per cycle to get updated sensor measurements and sent
+    * commands to actuators accordingly
    **/
     void begin(Eigen::Vector3f desired_attitude, timestamp ramp_time);
 
-private:
     /**
-    * @property sensors [unordered_map<string, shared_ptr<Sensor>>]
+    * @name resume
+    * @param desired_attitue [vector<float>], the desired angle to point at
+    * @param ramp_time [timestamp], the time over which to ramp to the new desired attitude
+    * @param state [loop_state], the state of the loop to continue from
+    *
+    * @details Continues a command loop from a saved state instead of starting a new one. The
+    * ramp keeps the start time and initial attitude of the saved loop.
+   **/
+    void resume(Eigen::Vector3f desired_attitude, timestamp ramp_time, const loop_state &state);
+
+    /**
+    * @name start
+    * @param desired_attitue [vector<float>], the desired angle to point at
+    * @param ramp_time [timestamp], the time over which to ramp to the new desired attitude
+    *
+    * @details Sets up a new command loop without running it, for a caller that runs the loop one
+    * step at a time, see step.
+   **/
+    void start(Eigen::Vector3f desired_attitude, timestamp ramp_time);
+
+    /**
+    * @name start_from
+    * @param desired_attitue [vector<float>], the desired angle to point at
+    * @param ramp_time [timestamp], the time over which to ramp to the new desired attitude
+    * @param state [loop_state], the state of the loop to continue from
+    *
+    * @details Sets up a command loop from a saved state without running it, see resume and step.
+   **/
+    void start_from(Eigen::Vector3f desired_attitude, timestamp ramp_time, const loop_state &state);
+
+    /**
+    * @name step
+    * @returns [timestamp], the time to sleep before the next step
     *
-    * @details An unordered map containing references to the satellite sensors.
+    * @details Runs the command loop until it has to wait, for the first measurement, the next
+    * cycle, or the gyroscope, and returns how long it waits. The loop never sleeps on the timer
+    * itself, so the caller decides how the time passes: begin sleeps on the timer, and the
+    * simulator advances to the wake time between steps. A step after the wake time continues
+    * where the last one stopped.
+   **/
+    timestamp step();
+
+    /**
+    * @name get_loop_state
+    * @returns [loop_state], the state of the command loop after its last cycle
    **/
-    std::unordered_map<std::string, std::shared_ptr<Sensor>> sensors;
+    loop_state get_loop_state() const;
 
     /**
-    * @property actuators [unordered_map<string, shared_ptr<Actuator>>]
+    * @name set_period
+    * @param period [timestamp], the time between the starts of two cycles, 0 to start a cycle as
+    * soon as the gyroscope is ready
     *
-    * @details An unordered map containing references to the satellite actuators.
+    * @details Sets the rate of the command loop. The cycles are on a fixed grid from the start of
+    * the loop, so the rate does not drift when a measurement is late.
    **/
-    std::unordered_map<std::string, std::shared_ptr<Actuator>> actuators;
+    void set_period(timestamp period);
 
+private:
     /**
     * @property gyro [Gyroscope *]
     *
@@ -64,6 +141,13 @@ private:
    **/
     Gyroscope *gyro;
 
+    /**
+    * @property filter [AttitudeKalmanFilter]
+    *
+    * @details Filters the noise out of the gyroscope measurements, if enabled.
+   **/
+    AttitudeKalmanFilter filter;
+
     /**
     * @property prev_error [Eigen::Vector3f]
     *
@@ -86,25 +170,121 @@ private:
     Eigen::Vector3f prev_integral;
 
     /**
-    * @property A_gen_inv [Eigen::Matrix3Xf]
+    * @property kp, kd, ki [Eigen::Vector3f]
+    *
+    * @details The proportional, derivative and integral gains of each axis, see controller_gains.
+   **/
+    const Eigen::Vector3f kp;
+    const Eigen::Vector3f kd;
+    const Eigen::Vector3f ki;
+
+    /**
+    * @property N [float]
+    *
+    * @details The filter coefficient of the derivative term.
+   **/
+    const float N;
+
+    /**
+    * @property started, initial_attitude, start_time, prev_time
+    *
+    * @details The state of the command loop, see loop_state.
+   **/
+    bool started;
+    Eigen::Vector3f initial_attitude;
+    timestamp start_time;
+    timestamp prev_time;
+
+    /**
+    * @property desired_attitude, ramp_time
+    *
+    * @details The target of the command loop, set when it starts.
+   **/
+    Eigen::Vector3f desired_attitude;
+    timestamp ramp_time;
+
+    /**
+    * @property period [timestamp]
+    *
+    * @details The time between the starts of two cycles, 0 if the loop is not rate limited.
+   **/
+    timestamp period;
+
+    /**
+    * @property reaction_wheels [vector<Reaction_wheel *>]
+    *
+    * @details The reaction wheels, indexed by id. Their order is the order of the rows of
+    * A_gen_inv and of the per wheel vectors below.
+   **/
+    std::vector<Reaction_wheel *> reaction_wheels;
+
+    /**
+    * @property A_gen_inv [Eigen::MatrixX3f]
     *
     * @details The matrix A stores the rotational axes of each reaction wheel, one
     * wheel per column. A_gen_inv is the generalised inverse of the matrix A, which
     * is used to split the desired torques, as calculated by the controller, into
     * individual scalar torques that should be applied by each reaction wheel.
    **/
-    Eigen::Matrix3Xf A_gen_inv;
+    Eigen::MatrixX3f A_gen_inv;
+
+    /**
+    * @property wheel_inertias [Eigen::VectorXf]
+    *
+    * @details The moment of inertia of each reaction wheel.
+   **/
+    Eigen::VectorXf wheel_inertias;
+
+    /**
+    * @property inverse_max_torques [Eigen::VectorXf]
+    *
+    * @details One over the largest torque each reaction wheel can apply, used to find the
+    * most saturated wheel in one pass.
+   **/
+    Eigen::VectorXf inverse_max_torques;
+
+    /**
+    * @property rw_torques [Eigen::VectorXf]
+    *
+    * @details The torque of each reaction wheel, kept between cycles so update does not
+    * allocate.
+   **/
+    Eigen::VectorXf rw_torques;
+
+    /**
+    * @property rw_accelerations [Eigen::VectorXf]
+    *
+    * @details The acceleration of each reaction wheel, read and written for every wheel at once
+    * each cycle, and kept between cycles so update does not allocate.
+   **/
+    Eigen::VectorXf rw_accelerations;
+
+    /**
+    * @property allocate [member function pointer]
+    *
+    * @details The allocate_torques variant for the number of reaction wheels, chosen in the
+    * constructor.
+   **/
+    void (PointingModeController::*allocate)(const Eigen::Vector3f &desired_torque);
 
     ADCS_timer *timer;
 
     /**
     * @name take_updated_measurements
-    * @returns [measurement]
+    * @param m [measurement *], populated with the current attitude if the status is ok
+    * @returns [device_status], not_ready if the gyroscope has not completed its poll delay
     *
     * @details For now just checks the gyroscope to get an updated current attitude
-    * of the satellite.
+    * of the satellite, passed through the attitude filter if it is enabled.
+   **/
+    device_status take_updated_measurements(measurement *m);
+
+    /**
+    * @name time_until_next_cycle
+    * @returns [timestamp], the time until the next cycle of the period after the last
+    * measurement, 0 if it is due or the loop is not rate limited.
    **/
-    measurement take_updated_measurements();
+    timestamp time_until_next_cycle();
 
     /**
     * @name update
@@ -114,4 +294,16 @@ private:
     * reaction wheels.
    **/
     void update(Eigen::Vector3f current_attitude, Eigen::Vector3f desired_attitude, timestamp delta_t);
+
+    /**
+    * @name allocate_torques
+    * @param desired_torque [Eigen::Vector3f], the body torque requested by the PID controller
+    *
+    * @details Splits the desired torque between the reaction wheels, scales the result so no
+    * wheel exceeds its max torque, and commands each wheel. NumWheels is the number of reaction
+    * wheels: 3 and 4 use fixed size matrices and unrolled loops, any other number uses
+    * Eigen::Dynamic.
+   **/
+    template <int NumWheels>
+    void allocate_torques(const Eigen::Vector3f &desired_torque);
 };
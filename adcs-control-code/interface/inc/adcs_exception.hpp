@@ -7,13 +7,14 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-18
+ * 2026-10-14
  *
 **/
 
 #pragma once
 
 #include <exception>
+#include <string>
 
 /**
  * @exception invalid_messagenger_param
@@ -26,9 +27,10 @@ class adcs_exception : public std::exception
         adcs_exception(const char* msg) : msg(msg) {}
         const char* message()
         {
-            return msg;
+            return msg.c_str();
         }
 
     private:
-        const char* msg;
+        /* Copy of the message, so it may be built from a temporary string. */
+        std::string msg;
 };
@@ -9,7 +9,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-18
+ * 2026-10-14
  *
 **/
 
@@ -17,6 +17,7 @@
 #include <string>
 #include <Eigen/Dense>
 #include <iomanip>
+#include <sstream>
 
 #include "adcs_exception.hpp"
 
@@ -41,143 +42,122 @@
 #define INTERFACE SIM_INTERFACE
 
 /********************************************* TYPES *********************************************/
-/**
- * @exception invalid_ui_args
- *
- * @details exception used to indicate that a UI function has received bad arguments from the user.
-**/
-class timestamp_nullptr : public adcs_exception
-{
-    public:
-        timestamp_nullptr(const char* msg) : adcs_exception(msg) {}
-};
-
 /** ADCS specific timestamp definition. All time measurements use this structure.
  *
- * @param milliseconds  number of milliseconds of the timestamp
- * @param seconds       number of seconds of the timestamp. This is rolled-over from milliseconds.
+ * @details time is stored as a single count of ticks, where one tick is one microsecond. This
+ *          allows timesteps below one millisecond, and keeps all arithmetic and comparisons to a
+ *          single integer operation. The 64 bit count does not overflow for any realistic run.
  *
 **/
 class timestamp
 {
     public:
+        /* Number of ticks in one second. */
+        static constexpr uint64_t ticks_per_second      = 1000000;
+
+        /* Number of ticks in one millisecond. */
+        static constexpr uint64_t ticks_per_millisecond = 1000;
+
+        /**
+         * @name timestamp constructor
+         *
+         * @details sets the time from a number of milliseconds and seconds. Both are added
+         *          together, so timestamp(1500, 1) is 2.5 seconds.
+        **/
+        constexpr timestamp(uint32_t milliseconds = 0, uint32_t seconds = 0) :
+            ticks( (uint64_t) milliseconds * ticks_per_millisecond +
+                   (uint64_t) seconds      * ticks_per_second ) {}
+
         /**
          * @name timestamp constructor
          *
-         * @details sets initial values of millisecond and second fields.
+         * @details sets the time from a number of seconds. The time is rounded to the nearest
+         *          tick, negative times are set to 0 and times too large to represent saturate.
         **/
-        timestamp(uint32_t milliseconds = 0, uint32_t seconds = 0) : millisecond(milliseconds), second(seconds)
+        explicit timestamp(float real_person_time) : ticks(seconds_to_ticks(real_person_time)) {}
+
+        /**
+         * @name from_microseconds
+         *
+         * @details creates a timestamp from a number of microseconds.
+         *
+         * @returns the new timestamp.
+        **/
+        static constexpr timestamp from_microseconds(uint64_t microseconds)
         {
-            rebalance_timestamp(&this->millisecond, &this->second);
+            timestamp result;
+            result.ticks = microseconds;
+            return result;
         }
 
-        explicit timestamp(float real_person_time) : millisecond((float)(real_person_time - ((int)real_person_time)) * 1000.0), second(real_person_time){}; // check this conversion later its a bit hacky
         /**
-         * @name milliseconds
+         * @name microseconds
          *
-         * @details millisecond field accessor
+         * @returns the total number of microseconds in the timestamp.
+        **/
+        constexpr uint64_t microseconds() const {return this->ticks;}
+
+        /**
+         * @name milliseconds
          *
-         * @returns millisecond field
+         * @returns the total number of whole milliseconds in the timestamp.
         **/
-        uint32_t milliseconds() {return this->millisecond;}
+        constexpr uint64_t milliseconds() const {return this->ticks / ticks_per_millisecond;}
 
         /**
          * @name seconds
          *
-         * @details second field accessor
+         * @returns the total number of whole seconds in the timestamp.
+        **/
+        constexpr uint64_t seconds() const {return this->ticks / ticks_per_second;}
+
+        /**
+         * @name to_seconds
          *
-         * @returns second field
+         * @returns the timestamp in seconds. This is the conversion used by all physics and
+         *          control calculations.
         **/
-        uint32_t seconds() {return this->second;}
+        constexpr float to_seconds() const {return (float) (this->ticks * (1.0 / ticks_per_second));}
 
         /**
          * @name operator+ overload
          *
-         * @details adds two timestamps. Overflow of milliseconds increments seconds. Overflow of
-         *          seconds is explicitly allowed, the caller should deal with consequences of
-         *          second overflow.
+         * @details adds two timestamps. Overflow is explicitly allowed, the caller should deal with
+         *          consequences of overflow.
          *
          * @returns result of addition.
         **/
-        timestamp operator+(const timestamp& b)
+        constexpr timestamp operator+(const timestamp& b) const
         {
-            timestamp result;
-
-            uint32_t l_millisecond = this->millisecond;
-            uint32_t r_millisecond = b.millisecond;
-            uint32_t l_second = this->second;
-            uint32_t r_second = b.second;
-
-            if (r_second > UINT32_MAX - l_second)
-            {
-                // explicitly allow overflow of the seconds field
-                result.second = (r_second > l_second) ? (r_second - l_second) : (l_second - r_second);
-            }
-            else
-            {
-                result.second = r_second + l_second;
-            }
-
-            uint32_t added_mil = 0;
-            uint32_t added_sec = 0;
-            add_milliseconds(l_millisecond, r_millisecond, &added_mil, &added_sec);
-
-            result.millisecond = added_mil;
-            result.second += added_sec;
-            return result;
+            return from_microseconds(this->ticks + b.ticks);
         }
 
         /**
          * @name operator- overload
          *
-         * @details subtracts two timestamps. Underflow is explicitly allowed, millisecond
-         *          underflow decrements the seconds field.
+         * @details subtracts two timestamps. Underflow is explicitly allowed, the caller should
+         *          deal with consequences of underflow.
          *
-         * @returns result of addition.
+         * @returns result of subtraction.
         **/
-        timestamp operator-(const timestamp& b)
+        constexpr timestamp operator-(const timestamp& b) const
         {
-            timestamp result;
-
-            if (b.second > this->second)
-            {
-                // explicitly allow underflow of the seconds field
-                result.second = UINT32_MAX - (b.second - this->second);
-            }
-            else
-            {
-                result.second = this->second - b.second;
-            }
-
-            if (b.millisecond > this->millisecond)
-            {
-                // underflow milliseconds and decrement seconds by 1. Again, allow seconds to underflow.
-                result.millisecond = UINT32_MAX - (b.millisecond - this->millisecond);
-                result.second = (0 == result.second) ? UINT32_MAX : result.second - 1;
-            }
-            else
-            {
-                result.millisecond = this->millisecond - b.millisecond;
-            }
-
-            rebalance_timestamp(&result.millisecond, &result.second);
-            return result;
+            return from_microseconds(this->ticks - b.ticks);
         }
 
-        explicit operator float() const { return this->millisecond / 1000.0 + (float) this->second; }
+        explicit constexpr operator float() const { return to_seconds(); }
 
         /**
-         * @name operator+ overload
+         * @name operator+= overload
          *
-         * @details adds two timestamps. Overflow of milliseconds increments seconds. Overflow of
-         *          seconds is explicitly allowed, the caller should deal with consequences of
-         *          second overflow.
+         * @details adds a timestamp to this timestamp.
          *
          * @returns result of addition.
         **/
-        timestamp operator+=(const timestamp& b)
+        constexpr timestamp operator+=(const timestamp& b)
         {
-            return *this + b;
+            this->ticks += b.ticks;
+            return *this;
         }
 
         /**
@@ -185,22 +165,12 @@ class timestamp
          *
          * @details Compares two timestamps.
          *
-         * @returns true if the left side is smaller than the right side. If seconds are equal, it
-         *               checks milliseconds.
+         * @returns true if the left side is smaller than the right side.
          *          false if the left side is not smaller than the right.
         **/
-        friend bool operator<(const timestamp& l, const timestamp& r)
+        friend constexpr bool operator<(const timestamp& l, const timestamp& r)
         {
-            bool ret = false;
-            
-            if ( (l.second      < r.second)      ||
-               ( (l.millisecond < r.millisecond) &&
-                 (l.second      <= r.second)     ))
-            {
-                ret = true;
-            }
-
-            return ret;
+            return l.ticks < r.ticks;
         }
 
         /**
@@ -208,11 +178,10 @@ class timestamp
          *
          * @details compares two timestamps.
          *
-         * @returns true if the right side is smaller than the left side. If seconds are equal, it
-         *               checks milliseconds.
+         * @returns true if the right side is smaller than the left side.
          *          false if the right side is not smaller than the left.
         **/
-        friend bool operator>(const timestamp& l, const timestamp& r)
+        friend constexpr bool operator>(const timestamp& l, const timestamp& r)
         {
             return r < l;
         }
@@ -225,7 +194,7 @@ class timestamp
          * @returns true if the left side is smaller or equal to the right side. 
          *          false otherwise.
         **/
-        friend bool operator<=(const timestamp& l, const timestamp& r)
+        friend constexpr bool operator<=(const timestamp& l, const timestamp& r)
         {
             return !(l > r);
         }
@@ -238,7 +207,7 @@ class timestamp
          * @returns true if the right side is smaller or equal to the left side. 
          *          false otherwise.
         **/
-        friend bool operator>=(const timestamp& l, const timestamp& r)
+        friend constexpr bool operator>=(const timestamp& l, const timestamp& r)
         {
             return !(l < r);
         }
@@ -251,15 +220,9 @@ class timestamp
          * @returns true if the both sides are equal.
          *          false otherwise.
         **/
-        friend bool operator==(const timestamp& l, const timestamp& r)
+        friend constexpr bool operator==(const timestamp& l, const timestamp& r)
         {
-            bool ret = false;
-            if ((l.second      == r.second) &&
-                (l.millisecond == r.millisecond))
-            {
-                ret = true;
-            }
-            return ret;
+            return l.ticks == r.ticks;
         }
 
         /**
@@ -270,7 +233,7 @@ class timestamp
          * @returns true if the both sides are not equal.
          *          false otherwise.
         **/
-        friend bool operator!=(const timestamp& l, const timestamp& r)
+        friend constexpr bool operator!=(const timestamp& l, const timestamp& r)
         {
             return !(l==r);
         }
@@ -283,11 +246,11 @@ class timestamp
          * @returns a string of the format:
          *          [mm:ss:msms]
         **/
-        std::string pretty_string()
+        std::string pretty_string() const
         {
-            uint32_t out_sec = (second + millisecond/1000);
-            uint32_t out_mil = millisecond % 1000;
-            uint32_t out_min = out_sec / 60;
+            uint64_t out_mil = milliseconds() % 1000;
+            uint64_t out_sec = seconds();
+            uint64_t out_min = out_sec / 60;
             out_sec %= 60;
 
             std::stringstream formatter;
@@ -299,101 +262,31 @@ class timestamp
 
     private:
         /**
-         * @name    rebalance_timestamp
+         * @name    seconds_to_ticks
          *
-         * @details given milliseconds and seconds fields, restructures the time so that the
-         *          maximum amount of time is in milliseconds as possible.
+         * @details converts a time in seconds to ticks, rounding to the nearest tick.
          *
-         * @param p_milliseconds the milliseconds field to rebalance.
-         * @param p_seconds      the seconds field to rebalance.
-        **/
-        void rebalance_timestamp(uint32_t *p_milliseconds, uint32_t * p_seconds)
-        {
-            if ((nullptr == p_milliseconds) ||
-                (nullptr == p_seconds) )
-            {
-                throw timestamp_nullptr("Pointer in \"rebalance_timestamp\" is null.");
-            }
-
-            uint32_t in_seconds      = *p_seconds;
-            uint32_t in_milliseconds = *p_milliseconds;
-
-            uint32_t out_seconds = 0;
-            uint32_t out_milliseconds = 0;
-
-            uint32_t seconds_to_milliseconds = 0;
-            uint32_t add_out_mil = 0;
-            uint32_t add_out_sec = 0;
-
-            // timestamps always use milliseconds first - if seconds is populated, try and move it to ms.
-            if ((UINT32_MAX / 1000) > in_seconds)
-            {
-                seconds_to_milliseconds = in_seconds * 1000;
-                add_milliseconds(seconds_to_milliseconds, in_milliseconds, &add_out_mil, &add_out_sec); 
-            }
-            else
-            {
-                uint32_t saturation_milliseconds = UINT32_MAX - 1000;
-                out_seconds = in_seconds - saturation_milliseconds / 1000;
-                add_milliseconds(saturation_milliseconds, in_milliseconds, &add_out_mil, &add_out_sec);
-            }
-
-            out_seconds += add_out_sec;
-            out_milliseconds = add_out_mil;
-
-            *p_seconds = out_seconds;
-            *p_milliseconds = out_milliseconds;
-        }
-
-        /**
-         * @name    add_milliseconds
+         * @param real_person_time the time in seconds.
          *
-         * @details adds two millisecond fields such that overflow populates a seconds field. The
-         *          algorithm is such that milliseconds are always favoured, and seconds are only
-         *          populated once milliseconds are full. Upon overflow, the milliseconds field
-         *          will loose 1000 milliseconds and be converted to seconds.
-         *
-         * @param p_milliseconds the milliseconds field to rebalance.
-         * @param p_seconds      the seconds field to rebalance.
+         * @returns the number of ticks, saturated to the range of the tick count.
         **/
-        void add_milliseconds(uint32_t a, uint32_t b, uint32_t *p_out_mil, uint32_t *p_out_sec)
+        static uint64_t seconds_to_ticks(float real_person_time)
         {
-            if ((nullptr == p_out_mil) ||
-                (nullptr == p_out_sec) )
+            double ticks = (double) real_person_time * ticks_per_second + 0.5;
+
+            if (!(0 < ticks))
             {
-                throw timestamp_nullptr("Pointer in \"add_milliseconds\" is null.");
+                return 0;
             }
-
-            uint32_t out_sec = 0;
-            uint32_t out_mil = 0;
-            uint32_t r_millisecond = b;
-            uint32_t l_millisecond = a;
-            // This might not have to be a while loop, but it works for now.
-            while (r_millisecond > UINT32_MAX - l_millisecond)
+            if ((double) UINT64_MAX <= ticks)
             {
-                out_sec++;
-                if (r_millisecond > l_millisecond)
-                {
-                    r_millisecond -= 1000;
-                }
-                else
-                {
-                    l_millisecond -= 1000;
-                }
+                return UINT64_MAX;
             }
-
-            out_mil = r_millisecond + l_millisecond;
-
-            *p_out_mil = out_mil;
-            *p_out_sec = out_sec;
-            return;
+            return (uint64_t) ticks;
         }
 
-        /* the milliseconds of the timestamp. If overflowed, second is incremented. */
-        uint32_t millisecond;
-
-        /* seconds of the timestamp. */
-        uint32_t second;
+        /* number of ticks (microseconds) in the timestamp. */
+        uint64_t ticks;
 };
 
 /**
@@ -437,6 +330,22 @@ typedef struct {
     timestamp   time;
 } actuator_state;
 
+/**
+ * @enum    device_status
+ * 
+ * @details Result of the non-throwing device requests. Only conditions the control code is
+ *          expected to handle in its loop are reported this way, real faults still throw.
+ *
+ * @param ok            the request was completed.
+ * @param not_ready     the device has not completed its required poll delay. Nothing was done.
+ *
+**/
+enum class device_status
+{
+    ok,
+    not_ready
+};
+
 /******************************************* EXCEPTIONS ******************************************/
 /**
  * @exception device_not_ready
@@ -637,6 +546,17 @@ class accelerometer : public Sensor
          * @returns the required measurement if succesful.
         **/
         measurement take_measurement();
+
+        /**
+         * @name    try_take_measurement
+         *
+         * @details takes a measurement if the sensor is ready, without throwing if it is not.
+         *
+         * @param   result populated with the measurement if the status is ok.
+         *
+         * @returns ok, or not_ready if the sensor has not completed its poll delay.
+        **/
+        device_status try_take_measurement(measurement *result);
 };
 
 /**
@@ -658,6 +578,17 @@ class gyroscope : public Sensor
          * @returns the required measurement if succesful.
         **/
         measurement take_measurement();
+
+        /**
+         * @name    try_take_measurement
+         *
+         * @details takes a measurement if the sensor is ready, without throwing if it is not.
+         *
+         * @param   result populated with the measurement if the status is ok.
+         *
+         * @returns ok, or not_ready if the sensor has not completed its poll delay.
+        **/
+        device_status try_take_measurement(measurement *result);
 };
 
 /**
@@ -693,6 +624,18 @@ class Reaction_wheel : public Actuator
         **/
         void set_target_state(actuator_state target_state);
 
+        /**
+         * @name    try_set_target_state
+         *
+         * @details sets the target state if the actuator is ready, without throwing if it is not.
+         *          An invalid target state is still a fault and throws.
+         *
+         * @param   target_state the new state the control code would like to be in.
+         *
+         * @returns ok, or not_ready if the actuator has not completed its poll delay.
+        **/
+        device_status try_set_target_state(actuator_state target_state);
+
         /**
          * @name    get_current_state
          *
@@ -702,5 +645,33 @@ class Reaction_wheel : public Actuator
          * @returns the current state of the actuator
         **/
         actuator_state get_current_state();
+
+        /**
+         * @name    get_current_states
+         *
+         * @details reads the state of every reaction wheel in one request to the driver.
+         *
+         * @param   wheels          every reaction wheel, indexed by id.
+         * @param   velocities      populated with the velocity of each wheel. May be null.
+         * @param   accelerations   populated with the acceleration of each wheel. May be null.
+         *
+         * @returns the time the states were read.
+        **/
+        static timestamp get_current_states(const std::vector<Reaction_wheel *> &wheels, Eigen::VectorXf *velocities, Eigen::VectorXf *accelerations);
+
+        /**
+         * @name    try_set_target_accelerations
+         *
+         * @details sets the target acceleration of every ready reaction wheel in one request to
+         *          the driver. A wheel that is not ready keeps its current acceleration.
+         *
+         * @param   wheels          every reaction wheel, indexed by id.
+         * @param   targets         the target acceleration of each wheel.
+         * @param   accelerations   the current acceleration of each wheel, updated with the targets
+         *                          of the ready wheels.
+         *
+         * @returns ok, or not_ready if any wheel has not completed its poll delay.
+        **/
+        static device_status try_set_target_accelerations(const std::vector<Reaction_wheel *> &wheels, const Eigen::Ref<const Eigen::VectorXf> &targets, Eigen::VectorXf *accelerations);
  };
 #endif
@@ -0,0 +1,73 @@
+/**
+ * @file AttitudeFilter.cpp
+ *
+ * @details Implementation for the attitude Kalman filter
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+**/
+
+#include <algorithm>
+
+#include "AttitudeFilter.hpp"
+
+namespace {
+    // a measurement noise of 0 would make the innovation covariance singular
+    const float min_variance = 1e-12f;
+}
+
+AttitudeKalmanFilter::AttitudeKalmanFilter(const attitude_filter_config &config) :
+    config(config),
+    q(config.process_noise * config.process_noise)
+{
+    R = Eigen::Matrix2f::Zero();
+    R(0, 0) = std::max(config.angle_noise * config.angle_noise, min_variance);
+    R(1, 1) = std::max(config.rate_noise * config.rate_noise, min_variance);
+    this->reset();
+}
+
+void AttitudeKalmanFilter::reset() {
+    state.initialized = false;
+    state.time = timestamp(0, 0);
+    state.x = Eigen::Matrix<float, 2, 3>::Zero();
+    state.P = R;
+}
+
+gyro_state AttitudeKalmanFilter::update(const gyro_state &m) {
+    Eigen::Matrix<float, 2, 3> z;
+    z.row(0) = m.position.transpose();
+    z.row(1) = m.velocity.transpose();
+
+    if (!state.initialized) {
+        state.initialized = true;
+        state.time = m.time_taken;
+        state.x = z;
+        state.P = R;
+        return m;
+    }
+
+    // predict: the angle moves with the angular velocity, which drifts with the process noise
+    const float dt = (m.time_taken - state.time).to_seconds();
+    state.time = m.time_taken;
+    if (0 < dt) {
+        Eigen::Matrix2f F;
+        F << 1, dt,
+             0, 1;
+        Eigen::Matrix2f Q;
+        Q << q * dt * dt * dt * dt / 4, q * dt * dt * dt / 2,
+             q * dt * dt * dt / 2,      q * dt * dt;
+
+        state.x.row(0) += dt * state.x.row(1);
+        state.P = F * state.P * F.transpose() + Q;
+    }
+
+    // correct: every axis shares the covariance, so one gain updates all three
+    const Eigen::Matrix2f K = state.P * (state.P + R).inverse();
+    state.x += K * (z - state.x);
+    state.P = (Eigen::Matrix2f::Identity() - K) * state.P;
+    state.P = 0.5f * (state.P + state.P.transpose());
+
+    return {state.x.row(0).transpose(), state.x.row(1).transpose(), m.acceleration, m.time_taken};
+}
@@ -6,116 +6,219 @@
  * @authors Justin Paoli
  *
  * Last Edited
- * 2022-11-13
+ * 2026-10-14
 **/
 
 #include "PointingModeController.hpp"
 
-PointingModeController::PointingModeController(
-    std::unordered_map<std::string, std::shared_ptr<Sensor>> sensors,
-    std::unordered_map<std::string, std::shared_ptr<Actuator>> actuators,
-    ADCS_timer *timer
-) {
-    this->sensors = sensors;
-    this->actuators = actuators;
+PointingModeController::PointingModeController(const device_registry &devices, ADCS_timer *timer,
+                                               const attitude_filter_config &filter_config,
+                                               const controller_gains &gains) :
+    filter(filter_config),
+    kp(gains.kp),
+    kd(gains.kd),
+    ki(gains.ki),
+    N(gains.N),
+    started(false),
+    initial_attitude(Eigen::Vector3f::Zero()),
+    desired_attitude(Eigen::Vector3f::Zero()),
+    ramp_time(0, 0),
+    period(0, 0)
+{
     this->timer = timer;
+    this->prev_error = Eigen::Vector3f::Zero();
+    this->prev_derivative = Eigen::Vector3f::Zero();
+    this->prev_integral = Eigen::Vector3f::Zero();
 
-    for (const auto &s : sensors) {
-        if (Gyroscope* gyro = dynamic_cast<Gyroscope*>(s.second.get())) {
-            this->gyro = gyro;
-        }
+    if (devices.gyroscopes.empty()) {
+        throw invalid_adcs_param("The pointing mode controller needs a gyroscope.");
+    }
+    this->gyro = devices.gyroscopes.front();
+    this->reaction_wheels = devices.reaction_wheels;
+
+    // the axes never change, so the torque allocation is only computed once
+    const Eigen::Index num_rws = this->reaction_wheels.size();
+    Eigen::Matrix3Xf A(3, num_rws);
+    this->wheel_inertias.resize(num_rws);
+    this->inverse_max_torques.resize(num_rws);
+    this->rw_torques = Eigen::VectorXf::Zero(num_rws);
+    this->rw_accelerations = Eigen::VectorXf::Zero(num_rws);
+
+    for (Eigen::Index i = 0; i < num_rws; i++) {
+        Reaction_wheel* rw = this->reaction_wheels[i];
+        A.col(i) = rw->get_axis_of_rotation();
+        this->wheel_inertias(i) = rw->get_inertia_matrix();
+        this->inverse_max_torques(i) = 1 / (rw->get_max_acceleration() * rw->get_inertia_matrix());
+    }
+
+    this->A_gen_inv = A.transpose() * (A * A.transpose()).inverse();
+
+    // almost every satellite has 3 or 4 wheels, which get their own fixed size allocation
+    switch (num_rws) {
+        case 3:
+            this->allocate = &PointingModeController::allocate_torques<3>;
+            break;
+        case 4:
+            this->allocate = &PointingModeController::allocate_torques<4>;
+            break;
+        default:
+            this->allocate = &PointingModeController::allocate_torques<Eigen::Dynamic>;
+            break;
     }
 }
 
 void PointingModeController::begin(Eigen::Vector3f desired_attitude, timestamp ramp_time) {
-    while (this->gyro->time_until_ready() > 0) {
-        this->timer->sleep(this->gyro->time_until_ready());
+    this->start(desired_attitude, ramp_time);
+    while (true) {
+        this->timer->sleep(this->step());
+    }
+}
+
+void PointingModeController::resume(Eigen::Vector3f desired_attitude, timestamp ramp_time, const loop_state &state) {
+    this->start_from(desired_attitude, ramp_time, state);
+    while (true) {
+        this->timer->sleep(this->step());
     }
+}
+
+void PointingModeController::start(Eigen::Vector3f desired_attitude, timestamp ramp_time) {
+    filter.reset();
 
-    measurement initial_vals = this->take_updated_measurements();
-    Eigen::Vector3f initial_attitude = initial_vals.vec;
-    timestamp start = initial_vals.time_taken;
-    timestamp prev_time = start;
-
-    prev_error = Eigen::Vector3f::Zero();
-    prev_derivative = Eigen::Vector3f::Zero();
-    prev_integral = Eigen::Vector3f::Zero();
-
-    while(true) {
-        try {
-            measurement m = this->take_updated_measurements();
-            timestamp delta_t = m.time_taken - prev_time;
-            timestamp since_start = m.time_taken - start;
-            prev_time = m.time_taken;
-
-            float ramp_factor = since_start < ramp_time ? ((float) since_start / (float) ramp_time) : 1;
-            Eigen::Vector3f ramped_desired_attitude = ramp_factor * (desired_attitude - initial_attitude) + initial_attitude;
-            this->update(m.vec, ramped_desired_attitude, delta_t);
-        } catch (device_not_ready &_e) {
-            this->timer->sleep(this->gyro->time_until_ready());
+    // the loop starts with its first measurement, see step
+    started = false;
+    this->desired_attitude = desired_attitude;
+    this->ramp_time = ramp_time;
+}
+
+void PointingModeController::start_from(Eigen::Vector3f desired_attitude, timestamp ramp_time, const loop_state &state) {
+    if (!state.started) {
+        this->start(desired_attitude, ramp_time);
+        return;
+    }
+
+    started = true;
+    initial_attitude = state.initial_attitude;
+    start_time = state.start;
+    prev_time = state.prev_time;
+    prev_error = state.prev_error;
+    prev_derivative = state.prev_derivative;
+    prev_integral = state.prev_integral;
+    filter.restore_state(state.filter);
+
+    this->desired_attitude = desired_attitude;
+    this->ramp_time = ramp_time;
+}
+
+timestamp PointingModeController::step() {
+    if (!started) {
+        measurement initial_vals;
+        if (device_status::ok != this->take_updated_measurements(&initial_vals)) {
+            return this->gyro->time_until_ready();
         }
+
+        started = true;
+        initial_attitude = initial_vals.vec;
+        start_time = initial_vals.time_taken;
+        prev_time = start_time;
+
+        prev_error = Eigen::Vector3f::Zero();
+        prev_derivative = Eigen::Vector3f::Zero();
+        prev_integral = Eigen::Vector3f::Zero();
+    }
+
+    // one cycle per gyroscope measurement, until the loop has to wait
+    while (true) {
+        const timestamp wait = this->time_until_next_cycle();
+        if (0 < wait) {
+            return wait;
+        }
+
+        measurement m;
+        if (device_status::ok != this->take_updated_measurements(&m)) {
+            return this->gyro->time_until_ready();
+        }
+
+        timestamp delta_t = m.time_taken - prev_time;
+        timestamp since_start = m.time_taken - start_time;
+        prev_time = m.time_taken;
+
+        float ramp_factor = since_start < ramp_time ? (since_start.to_seconds() / ramp_time.to_seconds()) : 1;
+        Eigen::Vector3f ramped_desired_attitude = ramp_factor * (desired_attitude - initial_attitude) + initial_attitude;
+        this->update(m.vec, ramped_desired_attitude, delta_t);
     }
 }
 
-void PointingModeController::update(Eigen::Vector3f current_attitude, Eigen::Vector3f desired_attitude, timestamp delta_t) {
-    Eigen::Vector3f kp(0.0002, 0.0002, 0.0002);
-    Eigen::Vector3f kd(0.005544, 0.005775, 0.0052472);
-    Eigen::Vector3f ki(0.00001, 0.0000096, 0.00001057);
-    float N = 1;
+PointingModeController::loop_state PointingModeController::get_loop_state() const {
+    return {started, initial_attitude, start_time, prev_time, prev_error, prev_derivative, prev_integral, filter.get_state()};
+}
 
+void PointingModeController::set_period(timestamp period) {
+    this->period = period;
+}
+
+timestamp PointingModeController::time_until_next_cycle() {
+    if (0 == this->period) {
+        return timestamp();
+    }
+
+    // the next multiple of the period after the last measurement, counted from the start of the loop
+    const uint64_t cycles = (prev_time - start_time).microseconds() / period.microseconds() + 1;
+    const timestamp next_cycle = start_time + timestamp::from_microseconds(cycles * period.microseconds());
+
+    const timestamp now = this->timer->get_time();
+    return (now < next_cycle) ? (next_cycle - now) : timestamp();
+}
+
+void PointingModeController::update(Eigen::Vector3f current_attitude, Eigen::Vector3f desired_attitude, timestamp delta_t) {
     Eigen::Vector3f cur_error = desired_attitude - current_attitude;
-    Eigen::Vector3f cur_derivative = (N * kd.cwiseProduct(cur_error - prev_error) + prev_derivative) / (1 + N * (float) delta_t);
-    Eigen::Vector3f cur_integral = prev_integral + cur_error * (float) delta_t;
+    const float dt = delta_t.to_seconds();
+    Eigen::Vector3f cur_derivative = (N * kd.cwiseProduct(cur_error - prev_error) + prev_derivative) / (1 + N * dt);
+    Eigen::Vector3f cur_integral = prev_integral + cur_error * dt;
 
     prev_error = cur_error;
     prev_derivative = cur_derivative;
     prev_integral = cur_integral;
 
     Eigen::Vector3f desired_torque = -1 * (kp.cwiseProduct(cur_error) + cur_derivative + ki.cwiseProduct(cur_integral));
-    
-    int num_rws = actuators.size();
-    int i = 0;
-    Eigen::Matrix3Xf A;
-    A.resize(3, num_rws);
-    for (const auto &a : actuators) {
-        if (Reaction_wheel* rw = dynamic_cast<Reaction_wheel*>(a.second.get())) {
-            A.col(i++) << rw->get_axis_of_rotation();
-        }
-    }
 
-    Eigen::VectorXf rw_torques = A.transpose() * (A * A.transpose()).inverse() * desired_torque;
-
-    // Check each torque to make sure it doesn't exceed the max, if it does
-    i = 0;
-    for (const auto &a : actuators) {
-        if (Reaction_wheel* rw = dynamic_cast<Reaction_wheel*>(a.second.get())) {
-            float max_t = rw->get_max_acceleration() * rw->get_inertia_matrix();
-            float rw_t = rw_torques[i++];
-            if (abs(rw_t) >= max_t) {
-                rw_torques = rw_torques * max_t / abs(rw_t) * 0.99;
-            }
-        }
+    (this->*allocate)(desired_torque);
+}
+
+template <int NumWheels>
+void PointingModeController::allocate_torques(const Eigen::Vector3f &desired_torque) {
+    const Eigen::Index num_rws = reaction_wheels.size();
+    if (0 == num_rws) {
+        return;
     }
 
-    i = 0;
-    for (const auto &a : actuators) {
-        if (Reaction_wheel* rw = dynamic_cast<Reaction_wheel*>(a.second.get())) {
-            rw->set_target_state({ 
-                rw_torques.coeff(i, 0) / rw->get_inertia_matrix(), 
-                rw->get_current_state().velocity, 
-                rw->get_current_state().position,
-                this->timer->get_time() 
-            });
-            i++;
-        }
+    Eigen::Map<const Eigen::Matrix<float, NumWheels, 3>> gen_inv(A_gen_inv.data(), num_rws, 3);
+    Eigen::Map<const Eigen::Matrix<float, NumWheels, 1>> inverse_max(inverse_max_torques.data(), num_rws);
+    Eigen::Map<const Eigen::Matrix<float, NumWheels, 1>> inertias(wheel_inertias.data(), num_rws);
+    Eigen::Map<Eigen::Matrix<float, NumWheels, 1>>       torques(rw_torques.data(), num_rws);
+
+    torques.noalias() = gen_inv * desired_torque;
+
+    // If any torque exceeds its max, scale them all so the most saturated wheel is just under its max
+    const float saturation = torques.cwiseAbs().cwiseProduct(inverse_max).maxCoeff();
+    if (saturation >= 1) {
+        torques *= 0.99 / saturation;
     }
+
+    const Eigen::Matrix<float, NumWheels, 1> accelerations = torques.cwiseQuotient(inertias);
+
+    // every wheel is read and commanded at once, a wheel that is not ready yet keeps its last command until the next cycle
+    Reaction_wheel::get_current_states(reaction_wheels, nullptr, &rw_accelerations);
+    Reaction_wheel::try_set_target_accelerations(reaction_wheels, accelerations, &rw_accelerations);
 }
 
-measurement PointingModeController::take_updated_measurements() {
-    try {
-        gyro_state state = this->gyro->take_measurement();
-        return { state.position, state.time_taken };
-    } catch (device_not_ready *e) {
-        throw e;
+device_status PointingModeController::take_updated_measurements(measurement *m) {
+    gyro_state state;
+    const device_status status = this->gyro->try_take_measurement(&state);
+    if (device_status::ok == status) {
+        if (filter.enabled()) {
+            state = filter.update(state);
+        }
+        *m = { state.position, state.time_taken };
     }
+    return status;
 }
@@ -0,0 +1,612 @@
+/**
+ * @file micro_benchmarks.cpp
+ *
+ * @details main file of the micro-benchmarks. Times the kernels the simulation spends its time
+ *          in, each on its own and without the UI loop, through their public calls:
+ *              Simulator::run_task timesteps for each integrator and a range of reaction wheel counts
+ *              PointingModeController::step for a range of reaction wheel counts
+ *              Messenger::format_csv_row for a range of reaction wheel counts
+ *              timestamp arithmetic and comparisons over a range of array sizes
+ *              NoiseStream::add, against drawing each sample with std::normal_distribution
+ *              AttitudeKalmanFilter::update
+ *              EnvironmentTable::sample, against evaluating the environment models directly
+ *
+ *          Each case doubles its iteration count until one batch takes at least the minimum
+ *          time, which also warms it up, then times a few batches and reports the median. For
+ *          Simulator::run_task an op is one timestep, so ops/s is steps/s. For
+ *          PointingModeController::step an op is one controller cycle and the Euler timestep to
+ *          the next one. Results are printed and written as json.
+ *
+ *          usage: ./bin/micro_benchmarks [--min_time ms] [--output path]
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Simulator.hpp"
+#include "Messenger.hpp"
+#include "PointingModeController.hpp"
+#include "AttitudeFilter.hpp"
+#include "SensorNoise.hpp"
+#include "Environment.hpp"
+#include "sim_interface.hpp"
+
+namespace
+{
+    /* Default minimum time of each timed batch, in ms */
+    const uint32_t default_min_time_ms = 100;
+
+    /* Default path of the json results */
+    const char *default_output_path = "output/micro_benchmarks.json";
+
+    /* Reaction wheel counts of the sweeps. 3 and 4 have their own fixed size kernels. */
+    const std::vector<uint32_t> wheel_counts = {3, 4, 6, 8, 16};
+
+    /* Array sizes of the timestamp sweep, from cache resident to main memory */
+    const std::vector<size_t> timestamp_array_sizes = {64, 4096, 1 << 20};
+
+    /* Timestep of every simulated and controller step */
+    const timestamp step_length = timestamp(10, 0);
+
+    /* Timeout of every benchmarked simulation, long enough to never be reached */
+    const timestamp bench_timeout = timestamp(0, 1000000000);
+
+    /**
+     * @name    advance
+     *
+     * @returns the time a number of step_length timesteps after now.
+    **/
+    timestamp advance(timestamp now, uint64_t steps)
+    {
+        return now + timestamp::from_microseconds(steps * step_length.microseconds());
+    }
+
+    /**
+     * @name    do_not_optimize
+     *
+     * @details stops the compiler from removing the computation of value as unused.
+    **/
+    template <typename T>
+    inline void do_not_optimize(const T &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    void print_usage()
+    {
+        std::printf("usage: micro_benchmarks [--min_time ms] [--output path]\n");
+    }
+}
+
+/**
+ * @class   MicroBenchmark
+ *
+ * @details runs every micro-benchmark.
+**/
+class MicroBenchmark
+{
+    public:
+        /**
+         * @name    MicroBenchmark constructor
+         *
+         * @param min_time minimum time of each timed batch.
+        **/
+        MicroBenchmark(std::chrono::nanoseconds min_time) : min_time(min_time) {}
+
+        /**
+         * @name    run
+         *
+         * @details runs every micro-benchmark, printing each result as it finishes.
+        **/
+        void run()
+        {
+            std::printf("%-40s %-28s %14s %16s\n", "benchmark", "parameters", "ns/op", "ops/s");
+
+            this->bench_timestep();
+            this->bench_controller_update();
+            this->bench_append_csv_output();
+            this->bench_timestamp();
+            this->bench_sensor_noise();
+            this->bench_attitude_filter();
+            this->bench_environment();
+        }
+
+        /**
+         * @name    write_json
+         *
+         * @param   path path of the json file. Missing directories are created.
+         *
+         * @returns true if the file was written.
+        **/
+        bool write_json(const std::string &path) const
+        {
+            const std::filesystem::path json_path(path);
+            if (json_path.has_parent_path())
+            {
+                std::filesystem::create_directories(json_path.parent_path());
+            }
+
+            std::ofstream json(path);
+            if (!json)
+            {
+                return false;
+            }
+
+            json << "{\n  \"min_time_ms\": " << std::chrono::duration<double, std::milli>(this->min_time).count() << ",\n";
+            json << "  \"results\": [";
+            for (size_t i = 0; i < this->results.size(); i++)
+            {
+                const result &r = this->results.at(i);
+                json << ((0 == i) ? "\n" : ",\n");
+                json << "    {\"name\": \"" << r.name << "\", \"parameters\": \"" << r.parameters << "\"";
+                json << ", \"iterations\": " << r.iterations;
+                json << ", \"ns_per_op\": " << r.ns_per_op << ", \"min_ns_per_op\": " << r.min_ns_per_op;
+                json << ", \"ops_per_second\": " << (1e9 / r.ns_per_op) << "}";
+            }
+            json << "\n  ]\n}\n";
+
+            return true;
+        }
+
+    private:
+        /**
+         * @struct  result
+         *
+         * @details timing of one benchmark case.
+        **/
+        typedef struct
+        {
+            std::string name;
+            std::string parameters;
+            uint64_t    iterations;
+            double      ns_per_op;
+            double      min_ns_per_op;
+        } result;
+
+        /**
+         * @name    time_batch
+         *
+         * @returns the time taken by op to do a number of iterations.
+        **/
+        template <typename Op>
+        static std::chrono::nanoseconds time_batch(Op &op, uint64_t iterations)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            op(iterations);
+            return std::chrono::steady_clock::now() - start;
+        }
+
+        /**
+         * @name    time
+         *
+         * @details times one benchmark case and records the result.
+         *
+         * @param name          name of the kernel.
+         * @param parameters    parameters of the case, such as the number of wheels.
+         * @param op            callable doing a given number of iterations of the kernel.
+        **/
+        template <typename Op>
+        void time(const std::string &name, const std::string &parameters, Op op)
+        {
+            uint64_t iterations = 1;
+            while ((time_batch(op, iterations) < this->min_time) && (iterations < max_iterations))
+            {
+                iterations *= 2;
+            }
+
+            std::vector<double> ns_per_op;
+            for (uint32_t repetition = 0; repetition < repetitions; repetition++)
+            {
+                ns_per_op.push_back(time_batch(op, iterations).count() / static_cast<double>(iterations));
+            }
+            std::sort(ns_per_op.begin(), ns_per_op.end());
+
+            const result r = {name, parameters, iterations, ns_per_op.at(repetitions / 2), ns_per_op.front()};
+            this->results.push_back(r);
+
+            std::printf("%-40s %-28s %14.2f %16.0f\n", name.c_str(), parameters.c_str(), r.ns_per_op, 1e9 / r.ns_per_op);
+            std::fflush(stdout);
+        }
+
+        /**
+         * @name    make_config
+         *
+         * @returns a spinning satellite with num_wheels reaction wheels. Wheels are spread over
+         *          the body axes and diagonals so any count can produce a torque on every axis.
+        **/
+        static sim_config make_config(uint32_t num_wheels)
+        {
+            sim_config config;
+            config.satellite.theta_b   = Eigen::Vector3f(0.1, -0.2, 0.3);
+            config.satellite.omega_b   = Eigen::Vector3f(0.01, -0.02, 0.005);
+            config.satellite.alpha_b   = Eigen::Vector3f::Zero();
+            config.satellite.inertia_b = Eigen::Vector3f(0.12, 0.15, 0.09).asDiagonal();
+
+            config.accelerometer.measurement = Eigen::Vector3f::Zero();
+            config.accelerometer.position    = Eigen::Vector3f::Zero();
+            config.gyroscope.theta    = Eigen::Vector3f::Zero();
+            config.gyroscope.omega    = Eigen::Vector3f::Zero();
+            config.gyroscope.alpha    = Eigen::Vector3f::Zero();
+            config.gyroscope.position = Eigen::Vector3f::Zero();
+
+            const Eigen::Vector3f axes[] =
+            {
+                Eigen::Vector3f::UnitX(), Eigen::Vector3f::UnitY(), Eigen::Vector3f::UnitZ(),
+                Eigen::Vector3f( 1,  1,  1).normalized(), Eigen::Vector3f(-1,  1,  1).normalized(),
+                Eigen::Vector3f( 1, -1,  1).normalized(), Eigen::Vector3f( 1,  1, -1).normalized()
+            };
+            const uint32_t num_axes = sizeof(axes) / sizeof(axes[0]);
+
+            sim_reaction_wheels &wheels = config.reaction_wheels;
+            wheels.omega            = Eigen::VectorXf::Constant(num_wheels, 10);
+            wheels.alpha            = Eigen::VectorXf::Constant(num_wheels, 0.1);
+            wheels.inertia          = Eigen::VectorXf::Constant(num_wheels, 0.001);
+            wheels.axis_of_rotation = Eigen::Matrix3Xf(3, num_wheels);
+            wheels.position         = Eigen::Matrix3Xf::Zero(3, num_wheels);
+            for (uint32_t i = 0; i < num_wheels; i++)
+            {
+                wheels.axis_of_rotation.col(i) = axes[i % num_axes];
+            }
+
+            return config;
+        }
+
+        /**
+         * @name    silence
+         *
+         * @details silences every output of a messenger, so nothing but the kernel is timed.
+        **/
+        static void silence(Messenger *messenger)
+        {
+            messenger->silence_messages();
+            messenger->silence_sim_prints();
+            messenger->silence_csv();
+        }
+
+        void bench_timestep()
+        {
+            const std::vector<std::pair<IntegratorType, std::string>> integrators =
+            {
+                {IntegratorType::Euler,         "Euler"},
+                {IntegratorType::RK4,           "RK4"},
+                {IntegratorType::DormandPrince, "DormandPrince"}
+            };
+
+            for (const auto &integrator : integrators)
+            {
+                for (uint32_t num_wheels : wheel_counts)
+                {
+                    Messenger messenger;
+                    silence(&messenger);
+
+                    /* The timestep bounds are both step_length, so adaptive integrators keep it too */
+                    Simulator simulator(&messenger);
+                    simulator.init(make_config(num_wheels), bench_timeout, step_length, false, step_length, step_length, integrator.first);
+
+                    /* The task never wakes again, so run_task only takes timesteps */
+                    const std::function<timestamp()> idle = []() { return bench_timeout; };
+                    timestamp now;
+
+                    this->time("Simulator::run_task", integrator.second + " wheels=" + std::to_string(num_wheels), [&](uint64_t iterations)
+                    {
+                        now = advance(now, iterations);
+                        simulator.run_task(idle, now);
+                    });
+                }
+            }
+        }
+
+        void bench_controller_update()
+        {
+            for (uint32_t num_wheels : wheel_counts)
+            {
+                Messenger messenger;
+                silence(&messenger);
+
+                const sim_config config = make_config(num_wheels);
+                Simulator simulator(&messenger);
+                simulator.init(config, bench_timeout, step_length, false, step_length, step_length);
+
+                /* Polling times of 0 keep every device ready, so each cycle commands every wheel */
+                Gyroscope gyro(timestamp(0, 0), &simulator, Eigen::Vector3f::Zero(), 0);
+
+                actuator_state max_vals = {1000, 10000, std::numeric_limits<float>::max(), timestamp(0, 3600)};
+                actuator_state min_vals = {-1000, -10000, -std::numeric_limits<float>::max(), timestamp(0, 0)};
+                std::vector<Reaction_wheel> wheels;
+                wheels.reserve(num_wheels);
+                for (uint32_t i = 0; i < num_wheels; i++)
+                {
+                    actuator_state initial_vals = {0, config.reaction_wheels.omega(i), 0, timestamp(0, 0)};
+                    wheels.emplace_back(timestamp(0, 0), &simulator, Eigen::Vector3f::Zero(), max_vals, min_vals, initial_vals,
+                                        config.reaction_wheels.axis_of_rotation.col(i), config.reaction_wheels.inertia(i), i);
+                }
+
+                device_registry devices;
+                devices.gyroscopes.push_back(&gyro);
+                for (Reaction_wheel &wheel : wheels)
+                {
+                    devices.reaction_wheels.push_back(&wheel);
+                }
+
+                ADCS_timer timer(&simulator);
+                PointingModeController controller(devices, &timer);
+
+                /* One cycle every timestep, run by the simulator like in a simulation */
+                controller.set_period(step_length);
+                controller.start(Eigen::Vector3f(0.5, 0.5, 0.5), timestamp(0, 0));
+                const std::function<timestamp()> task = [&controller]() { return controller.step(); };
+                timestamp now;
+
+                this->time("PointingModeController::step", "wheels=" + std::to_string(num_wheels), [&](uint64_t iterations)
+                {
+                    now = advance(now, iterations);
+                    simulator.run_task(task, now);
+                });
+            }
+        }
+
+        void bench_append_csv_output()
+        {
+            for (uint32_t num_wheels : {0u, 3u, 4u, 8u, 16u})
+            {
+                std::vector<float> wheel_values(2 * num_wheels);
+                telemetry_sample sample = {};
+                sample.rw_omega            = wheel_values.data();
+                sample.rw_alpha            = wheel_values.data() + num_wheels;
+                sample.time                = timestamp(0, 0);
+                sample.timestep            = step_length;
+                sample.num_reaction_wheels = num_wheels;
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    sample.theta_b[axis]       = 0.1234567f * (axis + 1);
+                    sample.omega_b[axis]       = -0.0012345f * (axis + 1);
+                    sample.alpha_b[axis]       = 0.0000123f * (axis + 1);
+                    sample.accelerometer[axis] = 9.80665f * axis;
+                }
+                for (uint32_t i = 0; i < num_wheels; i++)
+                {
+                    sample.rw_omega[i] = 123.456f + i;
+                    sample.rw_alpha[i] = -0.789f * i;
+                }
+
+                std::stringstream csv;
+                this->time("Messenger::format_csv_row", "wheels=" + std::to_string(num_wheels), [&](uint64_t iterations)
+                {
+                    /* Empty the buffer now and then, as the writer thread does when it flushes */
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        if (0 == (i % csv_rows_per_flush))
+                        {
+                            csv.str("");
+                        }
+                        sample.time += step_length;
+                        Messenger::format_csv_row(sample, csv);
+                    }
+                    do_not_optimize(csv);
+                });
+            }
+        }
+
+        void bench_timestamp()
+        {
+            std::mt19937_64 generator(0);
+            std::uniform_int_distribution<uint64_t> microseconds(0, uint64_t(1) << 40);
+
+            for (size_t size : timestamp_array_sizes)
+            {
+                std::vector<timestamp> a(size);
+                std::vector<timestamp> b(size);
+                std::vector<timestamp> out(size);
+                for (size_t i = 0; i < size; i++)
+                {
+                    a.at(i) = timestamp::from_microseconds(microseconds(generator));
+                    b.at(i) = timestamp::from_microseconds(microseconds(generator));
+                }
+
+                /* Sizes are powers of two, so the index wraps with a mask */
+                const size_t mask = size - 1;
+                const std::string parameters = "array=" + std::to_string(size);
+
+                this->time("timestamp::operator+", parameters, [&](uint64_t iterations)
+                {
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        out[i & mask] = a[i & mask] + b[i & mask];
+                    }
+                    do_not_optimize(out.data());
+                });
+
+                this->time("timestamp::operator-", parameters, [&](uint64_t iterations)
+                {
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        out[i & mask] = a[i & mask] - b[i & mask];
+                    }
+                    do_not_optimize(out.data());
+                });
+
+                this->time("timestamp::operator+=", parameters, [&](uint64_t iterations)
+                {
+                    timestamp sum;
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        sum += a[i & mask];
+                    }
+                    do_not_optimize(sum);
+                });
+
+                this->time("timestamp::operator<", parameters, [&](uint64_t iterations)
+                {
+                    uint64_t count = 0;
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        count += (a[i & mask] < b[i & mask]);
+                    }
+                    do_not_optimize(count);
+                });
+
+                this->time("timestamp::operator==", parameters, [&](uint64_t iterations)
+                {
+                    uint64_t count = 0;
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        count += (a[i & mask] == b[(i + 1) & mask]);
+                    }
+                    do_not_optimize(count);
+                });
+            }
+        }
+
+        void bench_sensor_noise()
+        {
+            NoiseStream noise;
+            noise.reset(0, 0, 0.001f);
+            Eigen::Vector3f measurement = Eigen::Vector3f::Zero();
+
+            this->time("NoiseStream::add", "3 samples", [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    noise.add(&measurement);
+                }
+                do_not_optimize(measurement);
+            });
+
+            /* What the noise would cost if each measurement drew its own samples */
+            std::mt19937_64 generator(0);
+            std::normal_distribution<float> normal(0, 0.001f);
+            this->time("std::normal_distribution", "3 samples", [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    measurement += Eigen::Vector3f(normal(generator), normal(generator), normal(generator));
+                }
+                do_not_optimize(measurement);
+            });
+        }
+
+        void bench_attitude_filter()
+        {
+            AttitudeKalmanFilter filter({true, 0.001f, 0.0005f, 0.001f});
+            gyro_state m = {Eigen::Vector3f(0.1, -0.2, 0.3), Eigen::Vector3f(0.01, -0.02, 0.005), Eigen::Vector3f::Zero(), timestamp(0, 0)};
+            gyro_state filtered = m;
+
+            this->time("AttitudeKalmanFilter::update", "", [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    m.time_taken += step_length;
+                    m.position   += m.velocity * step_length.to_seconds();
+                    filtered = filter.update(m);
+                }
+                do_not_optimize(filtered.position);
+            });
+        }
+
+        void bench_environment()
+        {
+            const environment_config config = {true, 500e3, 97.4 * M_PI / 180, 0, 0, 0, timestamp(0, 10), ""};
+            const timestamp duration(0, 6000);
+            std::shared_ptr<const EnvironmentTable> table = EnvironmentTable::build(config, duration);
+            environment_sample sample = {};
+
+            this->time("EnvironmentTable::sample", "10 s grid", [&](uint64_t iterations)
+            {
+                uint64_t t = 0;
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    t = (t + step_length.microseconds()) % duration.microseconds();
+                    sample = table->sample(timestamp::from_microseconds(t));
+                }
+                do_not_optimize(sample.magnetic_field);
+            });
+
+            /* What every timestep would pay without the table */
+            this->time("EnvironmentModels::evaluate", "", [&](uint64_t iterations)
+            {
+                uint64_t t = 0;
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    t = (t + step_length.microseconds()) % duration.microseconds();
+                    sample = EnvironmentModels::evaluate(config, timestamp::from_microseconds(t));
+                }
+                do_not_optimize(sample.magnetic_field);
+            });
+        }
+
+        /* Number of timed batches of each case, the median is reported */
+        static constexpr uint32_t repetitions = 5;
+
+        /* Upper limit of the iterations of one batch */
+        static constexpr uint64_t max_iterations = uint64_t(1) << 34;
+
+        /* Csv rows appended between each flush of the buffer */
+        static constexpr uint64_t csv_rows_per_flush = 4096;
+
+        /* Minimum time of each timed batch */
+        const std::chrono::nanoseconds min_time;
+
+        /* Every result, in the order they were run */
+        std::vector<result> results;
+};
+
+int main(int argc, char **argv) {
+    uint32_t    min_time_ms = default_min_time_ms;
+    std::string output_path = default_output_path;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if ((i + 1) >= argc) {
+            print_usage();
+            return 1;
+        }
+
+        try {
+            if (("--min_time" == arg) || ("-t" == arg)) {
+                min_time_ms = std::stoul(argv[++i]);
+            } else if (("--output" == arg) || ("-o" == arg)) {
+                output_path = argv[++i];
+            } else {
+                print_usage();
+                return 1;
+            }
+        } catch (std::logic_error &e) {
+            print_usage();
+            return 1;
+        }
+    }
+
+    try {
+        const std::chrono::milliseconds min_time(min_time_ms);
+        MicroBenchmark benchmark(min_time);
+        benchmark.run();
+
+        if (!benchmark.write_json(output_path)) {
+            std::printf("Could not open %s for writing.\n", output_path.c_str());
+            return 1;
+        }
+        std::printf("Results written to %s\n", output_path.c_str());
+    } catch (adcs_exception &e) {
+        std::printf("%s\n", e.message());
+        return 1;
+    }
+
+    return 0;
+}
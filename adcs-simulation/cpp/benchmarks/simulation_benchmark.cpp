@@ -0,0 +1,78 @@
+/**
+ * @file simulation_benchmark.cpp
+ *
+ * @details main file of the simulation benchmark. Runs the performance tests and writes the
+ *          timing of each phase as json. Run from the same directory as the simulator so the
+ *          unit_tests paths resolve.
+ *
+ *          usage: ./bin/benchmark [--warmup N] [--iterations N] [--output path]
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+    /* Default number of untimed runs of each scenario */
+    const uint32_t default_warmup_iterations = 2;
+
+    /* Default number of timed runs of each scenario */
+    const uint32_t default_iterations = 10;
+
+    void print_usage()
+    {
+        std::printf("usage: benchmark [--warmup N] [--iterations N] [--output path]\n");
+    }
+}
+
+int main(int argc, char **argv) {
+    uint32_t    warmup_iterations = default_warmup_iterations;
+    uint32_t    iterations        = default_iterations;
+    std::string output_path       = Benchmark::get_default_output_path();
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if ((i + 1) >= argc) {
+            print_usage();
+            return 1;
+        }
+
+        try {
+            if (("--warmup" == arg) || ("-w" == arg)) {
+                warmup_iterations = std::stoul(argv[++i]);
+            } else if (("--iterations" == arg) || ("-i" == arg)) {
+                iterations = std::stoul(argv[++i]);
+            } else if (("--output" == arg) || ("-o" == arg)) {
+                output_path = argv[++i];
+            } else {
+                print_usage();
+                return 1;
+            }
+        } catch (std::logic_error &e) {
+            print_usage();
+            return 1;
+        }
+    }
+
+    Messenger messenger;
+    try {
+        Benchmark benchmark(&messenger, warmup_iterations, iterations);
+        benchmark.add_perf_tests();
+        benchmark.run();
+        benchmark.write_json(output_path);
+    } catch (adcs_exception &e) {
+        messenger.send_error(e.message());
+        return 1;
+    }
+
+    return 0;
+}
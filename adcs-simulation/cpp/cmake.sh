@@ -1,4 +1,6 @@
 #!/bin/bash
+# usage: ./cmake.sh [clean | Release | RelWithDebInfo | Debug] [extra cmake arguments]
+# Builds Release if no build type is given, eg ./cmake.sh Release -DADCS_LTO=ON -DADCS_NATIVE=ON
 
 #### clean ####
 makefile=./Makefile
@@ -30,7 +32,14 @@ fi
 
 #### build ####
 
+build_type=Release
+if [[ "$1" == "Release" || "$1" == "RelWithDebInfo" || "$1" == "Debug" ]]
+then
+    build_type=$1
+    shift
+fi
+
 if [[ "$1" != "clean" ]]
 then
-    cmake . -Wno-dev
+    cmake . -Wno-dev -DCMAKE_BUILD_TYPE=$build_type "$@"
 fi
@@ -0,0 +1,323 @@
+/**
+ * @file    BatchRunner.hpp
+ *
+ * @details This file describes the headless batch runner. A sweep yaml names a base config yaml,
+ *          an optional exit yaml, and a list of parameters to vary. Every run samples the
+ *          parameters, then runs its own Simulator and controller on a thread pool. One summary
+ *          row is written per run.
+ *
+ *          Sweep yaml format:
+ *              BaseConfig: [string], path to the config yaml every run starts from
+ *              ExitConfig: [string], path to the exit yaml. Optional, runs have no controller
+ *                          if it is not provided.
+ *              Runs: [int], number of runs
+ *              Seed: [int], seed of the random parameters. Optional, default 0
+ *              Threads: [int], number of worker threads. Optional, default is one per core
+ *              SettleTolerance: [float], error in rad under which the satellite counts as settled.
+ *                               Optional, default is the RequiredAccuracy from the exit yaml
+ *              SameNoise: [bool], every run draws the same sensor noise, eg to compare controller
+ *                         gains on equal terms. Optional, default FALSE
+ *              Output: [string], path of the summary csv, "none" to not write one. Optional
+ *              Checkpoint: [string], path of a checkpoint every run resumes from, eg one converged
+ *                          prefix shared by the whole sweep. It must come from the base config.
+ *                          Optional, runs start from the initial state if it is not provided.
+ *              Parameters: list of
+ *                  Path: [string], dot separated key in the config yaml, eg Satellite.Velocity.
+ *                        Prefix with "Exit." to vary the exit yaml instead.
+ *                  Distribution: Uniform (Min, Max), Normal (Mean, StdDev) or Values (Values)
+ *                  Scale: [bool], multiply the base value by the sample instead of replacing it.
+ *                         Optional, default FALSE
+ *
+ *          If the base config has an Environment section, its table is built, or mapped, once
+ *          and shared read-only by every run, unless a parameter varies the Environment or the
+ *          Timeout, in which case each run loads its own.
+ *
+ *          Min, Max, Mean and StdDev may be scalars or have the same shape as the value they
+ *          replace, in which case each element is sampled separately. Values are used in turn,
+ *          run i getting Values[i % size].
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "Messenger.hpp"
+#include "Checkpoint.hpp"
+#include "Environment.hpp"
+
+/**
+ * @class   RunSummarySink
+ *
+ * @details telemetry sink that keeps the statistics of one run for the batch summary.
+**/
+class RunSummarySink : public TelemetrySink
+{
+    public:
+        /**
+         * @name    RunSummarySink constructor
+         *
+         * @param desired_position  attitude the controller is trying to reach.
+         * @param settle_tolerance  error in rad under which the satellite counts as settled.
+         * @param max_wheel_speeds  largest angular velocity of each reaction wheel, by id.
+        **/
+        RunSummarySink(const Eigen::Vector3f &desired_position, float settle_tolerance, const Eigen::VectorXf &max_wheel_speeds) :
+            desired_position(desired_position), settle_tolerance(settle_tolerance), max_wheel_speeds(max_wheel_speeds) {}
+
+        void on_simulation_state(const sim_state_view &state);
+
+        /* true if the error was within the tolerance at the end of the run. */
+        inline bool settled() const { return !out_of_tolerance; }
+
+        /* time after which the error stayed within the tolerance. */
+        inline timestamp settle_time() const { return settled_since; }
+
+        /* largest absolute error of any axis at the end of the run, in rad. */
+        inline float final_error() const { return last_error; }
+
+        /* largest absolute velocity of any reaction wheel during the run. */
+        inline float peak_wheel_speed() const { return peak_speed; }
+
+        /* largest absolute velocity of any reaction wheel during the run, as a fraction of its max. */
+        inline float peak_wheel_saturation() const { return peak_saturation; }
+
+        /* furthest any axis went past the desired position, away from where it started, in rad. */
+        inline float overshoot() const { return max_overshoot; }
+
+        /* simulation time at the end of the run. */
+        inline timestamp end_time() const { return last_time; }
+
+    private:
+        const Eigen::Vector3f desired_position;
+        const float           settle_tolerance;
+        const Eigen::VectorXf max_wheel_speeds;
+
+        bool            started          = false;
+        Eigen::Vector3f initial_side     = Eigen::Vector3f::Zero();
+        bool            out_of_tolerance = false;
+        timestamp       settled_since    = 0;
+        timestamp       last_time        = 0;
+        float           last_error       = 0;
+        float           peak_speed       = 0;
+        float           peak_saturation  = 0;
+        float           max_overshoot    = 0;
+};
+
+/**
+ * @class   BatchRunner
+ *
+ * @details loads a sweep yaml and runs every simulation it describes.
+**/
+class BatchRunner
+{
+    public:
+        /**
+         * @name    BatchRunner constructor
+         *
+         * @param sweep_yaml_path   path to the sweep yaml.
+         * @param messenger         messenger used to report progress. Runs use their own.
+         *
+         * @exception invalid_batch_spec the sweep yaml is missing or invalid.
+        **/
+        BatchRunner(const std::string &sweep_yaml_path, Messenger *messenger);
+
+        /**
+         * @name    BatchRunner constructor
+         *
+         * @details runs a sweep built in memory, eg by the gain tuner.
+         *
+         * @param sweep     the sweep, in the format of a sweep yaml.
+         * @param messenger messenger used to report progress. Runs use their own.
+         *
+         * @exception invalid_batch_spec the sweep is invalid.
+        **/
+        BatchRunner(const YAML::Node &sweep, Messenger *messenger);
+
+        /**
+         * @struct  run_result
+         *
+         * @details summary of one run.
+        **/
+        typedef struct
+        {
+            bool               completed;
+            std::string        error;
+            std::vector<float> parameter_values;
+            bool               settled;
+            float              settle_time;
+            float              final_error;
+            float              overshoot;
+            float              peak_wheel_speed;
+            float              peak_wheel_saturation;
+            float              end_time;
+            uint64_t           wall_time_ms;
+        } run_result;
+
+        /**
+         * @name    run
+         *
+         * @details runs every simulation of the sweep and writes the summary csv.
+        **/
+        void run();
+
+        /**
+         * @name    get_default_output_path
+         *
+         * @returns the summary csv path used if the sweep yaml does not provide one.
+        **/
+        inline static std::string get_default_output_path()
+        {
+            return "output/batch_summary.csv";
+        }
+
+        /**
+         * @name    get_results
+         *
+         * @returns the summary of every run of the last call to run, indexed by run.
+        **/
+        inline const std::vector<run_result> &get_results() const { return this->results; }
+
+    private:
+        /**
+        * @details enum class for the distribution a parameter is sampled from.
+        */
+        enum class Distribution{
+            Uniform,
+            Normal,
+            Values
+        };
+
+        /**
+         * @struct  sweep_parameter
+         *
+         * @details one parameter of the sweep, as read from the sweep yaml.
+        **/
+        typedef struct
+        {
+            std::string              name;
+            std::vector<std::string> keys;
+            bool                     in_exit_config;
+            Distribution             distribution;
+            YAML::Node               first;
+            YAML::Node               second;
+            bool                     scale;
+        } sweep_parameter;
+
+        /**
+         * @name    worker
+         *
+         * @details body of each worker thread. Takes runs in order until none are left.
+        **/
+        void worker();
+
+        /**
+         * @name    run_one
+         *
+         * @details samples the parameters of one run, then runs it. Any exception fails only this
+         *          run, and is reported in its error.
+         *
+         * @param   run_index index of the run.
+         *
+         * @returns the summary of the run.
+        **/
+        run_result run_one(uint32_t run_index);
+
+        /**
+         * @name    sample_parameters
+         *
+         * @details creates the config and exit yaml documents of a run.
+         *
+         * @param   run_index   index of the run.
+         * @param   config      populated with the config yaml of the run.
+         * @param   exit        populated with the exit yaml of the run.
+         * @param   values      populated with every sampled value, flattened.
+        **/
+        void sample_parameters(uint32_t run_index, YAML::Node *config, YAML::Node *exit, std::vector<float> *values);
+
+        /**
+         * @name    write_summary
+         *
+         * @details writes one row per run to the summary csv.
+        **/
+        void write_summary();
+
+        /* Messenger used to report progress */
+        Messenger *messenger;
+
+        /* Parsed base config yaml */
+        YAML::Node base_config;
+
+        /* Parsed exit yaml. Null if there is no exit yaml. */
+        YAML::Node base_exit;
+
+        /* Parameters of the sweep */
+        std::vector<sweep_parameter> parameters;
+
+        /* Names of the flattened parameter columns of the summary */
+        std::vector<std::string> parameter_columns;
+
+        /* Number of runs */
+        uint32_t num_runs = 0;
+
+        /* Seed of the random parameters */
+        uint64_t seed = 0;
+
+        /* Number of worker threads */
+        uint32_t num_threads = 0;
+
+        /* Every run draws the noise of run 0 */
+        bool same_noise = false;
+
+        /* Error under which a run counts as settled, negative to use the exit yaml */
+        float settle_tolerance = -1;
+
+        /* Path of the summary csv, empty to not write one */
+        std::string output_path;
+
+        /* Checkpoint every run resumes from, read once and shared. Null to start from the beginning. */
+        std::shared_ptr<const sim_checkpoint> checkpoint;
+
+        /* Environment table shared by every run, null if the runs have none or load their own. */
+        std::shared_ptr<const EnvironmentTable> environment;
+
+        /* Results of every run, indexed by run */
+        std::vector<run_result> results;
+
+        /* Index of the next run to start */
+        std::atomic<uint32_t> next_run{0};
+
+        /* Number of runs finished, only changed with progress_mutex held */
+        std::atomic<uint32_t> finished_runs{0};
+
+        /* Guards finished_runs for progress_changed */
+        std::mutex progress_mutex;
+
+        /* Signalled by the workers after each finished run */
+        std::condition_variable progress_changed;
+
+        /* Guards the yaml documents shared by the workers, as yaml-cpp nodes are not thread safe */
+        std::mutex yaml_mutex;
+};
+
+/**
+ * @exception invalid_batch_spec
+ *
+ * @details exception used to indicate that the sweep yaml is not valid.
+**/
+class invalid_batch_spec : public adcs_exception
+{
+    public:
+        invalid_batch_spec(const char* msg) : adcs_exception(msg) {}
+};
@@ -0,0 +1,200 @@
+/**
+ * @file    Benchmark.hpp
+ *
+ * @details This file describes the simulation benchmark. Each scenario is a config yaml and an
+ *          exit yaml that are run a number of times after some untimed warm-up runs. Every run is
+ *          split into setup, physics, controller and I/O time with the steady clock, and the
+ *          median, 95th percentile and standard deviation of each phase are reported. Results are
+ *          written as json so they can be compared between commits.
+ *
+ *          Phases:
+ *              setup:      parsing the yamls and building the simulator, devices and controller
+ *              physics:    integrating the dynamics
+ *              controller: the control code, ie. everything else inside the run
+ *              io:         handing telemetry to the Messenger and flushing it to the output file
+ *              total:      the whole run
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "CommonStructs.hpp"
+#include "Messenger.hpp"
+
+/**
+ * @class   Benchmark
+ *
+ * @details runs every scenario added to it and summarizes the time spent in each phase.
+**/
+class Benchmark
+{
+    public:
+        /**
+         * @name    Benchmark constructor
+         *
+         * @param messenger         messenger used to report progress. Runs use their own.
+         * @param warmup_iterations number of untimed runs of each scenario before timing it.
+         * @param iterations        number of timed runs of each scenario.
+         *
+         * @exception invalid_benchmark_args iterations is 0.
+        **/
+        Benchmark(Messenger *messenger, uint32_t warmup_iterations, uint32_t iterations);
+
+        /**
+         * @name    add_scenario
+         *
+         * @param name          short name of the scenario, used as its key in the results.
+         * @param description   what the scenario simulates.
+         * @param config_path   path to the config yaml.
+         * @param exit_path     path to the exit yaml, empty to run without a controller.
+        **/
+        void add_scenario(const std::string &name, const std::string &description, const std::string &config_path, const std::string &exit_path);
+
+        /**
+         * @name    add_perf_tests
+         *
+         * @details adds the three performance tests in unit_tests/performance.
+        **/
+        void add_perf_tests();
+
+        /**
+         * @name    run
+         *
+         * @details runs every scenario and prints a summary of each. The output directory is
+         *          cleared before and after, as every run writes its own csv.
+         *
+         * @exception invalid_benchmark_args no scenarios have been added, or one cannot be loaded.
+        **/
+        void run();
+
+        /**
+         * @name    write_json
+         *
+         * @details writes the results of the last run as json.
+         *
+         * @param   path path of the json file. Missing directories are created.
+        **/
+        void write_json(const std::string &path) const;
+
+        /**
+         * @name    get_default_output_path
+         *
+         * @returns the json path used if none is provided.
+        **/
+        inline static std::string get_default_output_path()
+        {
+            return "output/benchmark.json";
+        }
+
+    private:
+        /**
+         * @struct  scenario
+         *
+         * @details one scenario and the timing of each of its timed runs.
+        **/
+        typedef struct
+        {
+            std::string               name;
+            std::string               description;
+            std::string               config_path;
+            std::string               exit_path;
+            std::vector<phase_timing> samples;
+        } scenario;
+
+        /**
+         * @struct  phase_stats
+         *
+         * @details summary of one phase over every timed run, in ms.
+        **/
+        typedef struct
+        {
+            double median;
+            double p95;
+            double mean;
+            double stddev;
+            double min;
+            double max;
+        } phase_stats;
+
+        /**
+         * @name    time_run
+         *
+         * @details runs a scenario once with a silent Messenger.
+         *
+         * @param   run_scenario the scenario to run.
+         *
+         * @returns the time spent in each phase.
+        **/
+        phase_timing time_run(const scenario &run_scenario);
+
+        /**
+         * @name    phase_samples
+         *
+         * @param   run_scenario a scenario that has been run.
+         * @param   phase        name of the phase, as listed in the file description.
+         *
+         * @returns the time of the phase in each timed run, in ms.
+        **/
+        static std::vector<double> phase_samples(const scenario &run_scenario, const std::string &phase);
+
+        /**
+         * @name    summarize
+         *
+         * @param   samples times of one phase, in ms.
+         *
+         * @returns the median, 95th percentile (nearest rank), mean, sample standard deviation,
+         *          minimum and maximum of the samples.
+        **/
+        static phase_stats summarize(std::vector<double> samples);
+
+        /* Messenger used to report progress */
+        Messenger *messenger;
+
+        /* Number of untimed runs of each scenario */
+        const uint32_t warmup_iterations;
+
+        /* Number of timed runs of each scenario */
+        const uint32_t iterations;
+
+        /* Every scenario, in the order they were added */
+        std::vector<scenario> scenarios;
+
+        /* Name of each phase, in the order they are reported */
+        const std::vector<std::string> phase_names = {"setup", "physics", "controller", "io", "total"};
+
+        /* Csv print rate of every run, in ms. Matches the rate used to tune the perf tests. */
+        const uint32_t csv_print_rate = 1000;
+
+        /* path to the perfomance test config yaml file (without the number or file extension) */
+        const std::string perf_test_config_yaml_path = "unit_tests/performance/perf_test_config_";
+
+        /* path to the perfomance test exit yaml file (without the number or file extension) */
+        const std::string perf_test_exit_yaml_path = "unit_tests/performance/perf_test_exit_";
+
+        /* Description of each performance test */
+        const std::vector<std::string> perf_test_descriptions =
+        {
+            "No initial velocity, requested postion = stationary",
+            "Some initial velocity, requested postion = stationary",
+            "No initial velocity, requested position = moved"
+        };
+};
+
+/**
+ * @exception invalid_benchmark_args
+ *
+ * @details exception used to indicate that the benchmark was given invalid arguments.
+**/
+class invalid_benchmark_args : public adcs_exception
+{
+    public:
+        invalid_benchmark_args(const char* msg) : adcs_exception(msg) {}
+};
@@ -0,0 +1,130 @@
+/**
+ * @file Checkpoint.hpp
+ *
+ * @details header file for simulation checkpoints. A checkpoint holds everything needed to
+ *          continue a run exactly where it stopped: the simulator state and clock, the poll time
+ *          of every device and the state of the controller loop. The simulator settings, devices
+ *          and exit conditions still come from the config and exit yamls the run is resumed with.
+ *
+ *          File layout (all values little-endian, as written by the host; times are uint64_t
+ *          microseconds and matrices are column-major):
+ *              char[8]   magic "ADCSCKP" followed by a null byte
+ *              uint32_t  format version
+ *              uint64_t  simulation time
+ *              uint64_t  timestep length
+ *              float32   error estimate of the last timestep
+ *              uint32_t  number of scheduled events, then a time per event
+ *              uint64_t[3] samples drawn from the gyroscope angle, gyroscope rate and
+ *                        accelerometer noise
+ *              float32[3] satellite theta_b, omega_b, alpha_b, then float32[9] inertia_b
+ *              float32[3] accelerometer measurement and position
+ *              float32[3] gyroscope theta, omega, alpha and position
+ *              uint32_t  number of reaction wheels n
+ *              float32[n] wheel omega, alpha and inertia, then float32[3n] axis_of_rotation and position
+ *              for gyroscopes, accelerometers and reaction wheels in turn:
+ *                  uint32_t  number of devices, then the last poll time of each device, by id
+ *              uint8_t   1 if the controller state follows, 0 otherwise
+ *              uint8_t   1 if the controller loop has started
+ *              float32[3] initial attitude, then the loop start time and last measurement time
+ *              float32[3] previous error, derivative and integral terms
+ *              uint8_t   1 if the attitude filter has started, then the time of its last measurement
+ *              float32[6] attitude filter estimate, then float32[4] its covariance
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "adcs_exception.hpp"
+#include "Simulator.hpp"
+#include "PointingModeController.hpp"
+
+/**
+ * @struct  sim_checkpoint
+ *
+ * @details contents of a checkpoint.
+ *
+ * @param simulator             state of the simulator.
+ * @param gyroscope_polls       last poll time of each gyroscope, by id.
+ * @param accelerometer_polls   last poll time of each accelerometer, by id.
+ * @param reaction_wheel_polls  last poll time of each reaction wheel, by id.
+ * @param has_controller        true if the run had the pointing mode controller.
+ * @param controller            state of the controller loop, if has_controller.
+**/
+typedef struct
+{
+    simulator_state                    simulator;
+    std::vector<timestamp>             gyroscope_polls;
+    std::vector<timestamp>             accelerometer_polls;
+    std::vector<timestamp>             reaction_wheel_polls;
+    bool                               has_controller;
+    PointingModeController::loop_state controller;
+} sim_checkpoint;
+
+/**
+ * @class   Checkpoint
+ *
+ * @details reads and writes checkpoint files.
+**/
+class Checkpoint
+{
+    public:
+        /* Magic string at the start of every checkpoint file, including the null byte. */
+        static constexpr char magic[8] = "ADCSCKP";
+
+        /* Version of the file layout. */
+        static constexpr uint32_t format_version = 2;
+
+        /**
+         * @name    write
+         *
+         * @details writes a checkpoint. The file is written next to the path and then renamed,
+         *          so a run stopped while writing never leaves a partial checkpoint behind.
+         *
+         * @param   checkpoint the checkpoint to write.
+         * @param   path       path of the checkpoint file. Missing directories are created.
+         *
+         * @exception invalid_checkpoint the file could not be written.
+        **/
+        static void write(const sim_checkpoint &checkpoint, const std::string &path);
+
+        /**
+         * @name    read
+         *
+         * @param   path path of the checkpoint file.
+         *
+         * @returns the checkpoint.
+         *
+         * @exception invalid_checkpoint the file is missing, truncated, or not a checkpoint.
+        **/
+        static sim_checkpoint read(const std::string &path);
+
+        /**
+         * @name    get_default_path
+         *
+         * @returns the path start_sim writes its checkpoint to, and resume_sim reads by default.
+        **/
+        inline static std::string get_default_path()
+        {
+            return "output/sim_checkpoint.ckpt";
+        }
+};
+
+/**
+ * @exception invalid_checkpoint
+ *
+ * @details exception used to indicate that a checkpoint could not be read or written, or does
+ *          not match the configuration it is resumed with.
+**/
+class invalid_checkpoint : public adcs_exception
+{
+    public:
+        invalid_checkpoint(const char* msg) : adcs_exception(msg) {}
+};
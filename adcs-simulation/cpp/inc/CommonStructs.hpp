@@ -6,12 +6,14 @@
  * @authors Lily de Loe, Aidan Sheedy
  *
  * Last Edited
- * 2022-11-08
+ * 2026-10-14
  *
 **/
 #pragma once
 
 #include <Eigen/Dense>
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 /**
@@ -29,6 +31,16 @@ enum class ActuatorType{
     ReactionWheel
 };
 
+/**
+* @details enum class for integrator type, which defines all valid integrators for the attitude
+* dynamics
+*/
+enum class IntegratorType{
+    Euler,
+    RK4,
+    DormandPrince
+};
+
 /**
 * @name Satellite
 * @property theta_b [Eigen::Vector3f], the angular position of the satellite body
@@ -49,24 +61,26 @@ typedef struct {
 } Satellite;
 
 /**
- * @struct  sim_reaction_wheel
+ * @struct  sim_reaction_wheels
  * 
- * @details structure defining the status of a reaction wheel in the simulator.
+ * @details structure-of-arrays defining the status of every reaction wheel in the simulator. Element
+ *          (or column) i of each member describes reaction wheel i.
  * 
- * @param omega     the angular velocity of the reaciton wheel (body frame)
- * @param alpha     the angular acceleration of the reaction wheel (body frame)
- * @param inertia   the inertia matrix of the reaction wheel.
- * @param position  the position of the satellite of the reaction wheel
+ * @param omega             the angular velocity of each reaction wheel (body frame)
+ * @param alpha             the angular acceleration of each reaction wheel (body frame)
+ * @param inertia           the inertia of each reaction wheel about its axis of rotation.
+ * @param axis_of_rotation  the axis of rotation of each reaction wheel, one per column.
+ * @param position          the position in the satellite of each reaction wheel, one per column.
  * 
 **/
 typedef struct
 {
-    float omega;
-    float alpha;
-    float inertia;
-    Eigen::Vector3f axis_of_rotation;
-    Eigen::Vector3f position;
-} sim_reaction_wheel;
+    Eigen::VectorXf  omega;
+    Eigen::VectorXf  alpha;
+    Eigen::VectorXf  inertia;
+    Eigen::Matrix3Xf axis_of_rotation;
+    Eigen::Matrix3Xf position;
+} sim_reaction_wheels;
 
 /**
  * @struct  sim_accelerometer
@@ -108,7 +122,7 @@ typedef struct
  * @param satellite         info of the overall satellite
  * @param accelerometer     accelerometer info in the satellite system
  * @param gyroscope         gyroscope info in the satellite system
- * @param reaction_wheels   vector of all reaction wheels in the satellite system
+ * @param reaction_wheels   all reaction wheels in the satellite system
  * 
 **/
 typedef struct
@@ -116,9 +130,51 @@ typedef struct
     Satellite                        satellite;
     sim_accelerometer                accelerometer;
     sim_gyroscope                    gyroscope;
-    std::vector<sim_reaction_wheel>  reaction_wheels;
+    sim_reaction_wheels              reaction_wheels;
 } sim_config;
 
+/**
+ * @struct  physics_context
+ * 
+ * @details constants of the rigid body dynamics that are derived from the satellite configuration.
+ *          These never change during a run, so the simulator computes them once instead of on
+ *          every timestep.
+ * 
+ * @param inertia_b_inverse  inverse of the satellite body inertia tensor.
+ * @param rw_momentum_axes   inertia * axis_of_rotation of each reaction wheel, one per column.
+ *                           Multiplying by a vector of wheel velocities (or accelerations) gives
+ *                           the summed wheel angular momentum (or torque) in the body frame.
+ * 
+**/
+typedef struct
+{
+    Eigen::Matrix3f  inertia_b_inverse;
+    Eigen::Matrix3Xf rw_momentum_axes;
+} physics_context;
+
+/**
+ * @struct  phase_timing
+ * 
+ * @details wall clock time spent in each phase of a run, measured with the steady clock. Filled
+ *          in by the Simulator and SimulationRun when a benchmark asks for it. Time not spent in
+ *          any of these phases is spent in the control code.
+ * 
+ * @param setup    loading the configuration and building the simulator, devices and controller.
+ * @param physics  integrating the dynamics, summed over every timestep.
+ * @param io       handing telemetry to the Messenger and flushing it at the end of the run.
+ * @param total    the whole run, including setup.
+ * @param steps    number of timesteps simulated.
+ * 
+**/
+typedef struct
+{
+    std::chrono::nanoseconds setup   = std::chrono::nanoseconds(0);
+    std::chrono::nanoseconds physics = std::chrono::nanoseconds(0);
+    std::chrono::nanoseconds io      = std::chrono::nanoseconds(0);
+    std::chrono::nanoseconds total   = std::chrono::nanoseconds(0);
+    uint64_t                 steps   = 0;
+} phase_timing;
+
 /**
  * @struct  text_colour
  *
@@ -1,27 +1,35 @@
 /**
  * @file ConfigurationSingleton.hpp
  *
- * @details hpp file for singleton class used to configure the user's sensor/actuator inputs
+ * @details hpp file for the immutable configuration of the user's sensor/actuator inputs. The
+ *          file keeps its historical name, the configuration is no longer a singleton.
  *
  * @authors Lily de Loe, Aidan Sheedy
  *
  * Last Edited
- * 2022-11-15
+ * 2026-10-14
  *
 **/
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "CommonStructs.hpp"
+#include "AttitudeFilter.hpp"
+#include "ControllerGains.hpp"
+#include "Environment.hpp"
 #include <yaml-cpp/yaml.h>
 #include <Eigen/Dense>
 
 /**
 * @name SensorConfig
 * @property type [SensorType], the sensor type
+* @property id [uint32_t], index of the sensor among the sensors of its type
+* @property noiseStdDev [float], standard deviation of the noise added to each measured value,
+* in the units of the measurement. Optional NoiseStdDev key, 0 (no noise) by default
 *
 * @details struct outlining the sensor configuration according to the input sensor
 * config and type
@@ -33,16 +41,21 @@ struct SensorConfig {
         for (const auto &n : node["Position"]) {
             position(j++) = n.as<float>();
         }
+        noiseStdDev = node["NoiseStdDev"] ? node["NoiseStdDev"].as<float>() : 0;
     };
     virtual ~SensorConfig() = default;
     int pollingTime;
     SensorType type;
     Eigen::Vector3f position;
+    uint32_t id = 0;
+    float noiseStdDev = 0;
 };
 
 /**
 * @name ActuatorConfig
 * @property type [ActuatorType], the actuator type
+* @property id [uint32_t], index of the actuator among the actuators of its type. For reaction
+* wheels this is the column of the wheel in the simulator's reaction wheel arrays.
 *
 * @details struct outlining the actuator configuration according to the input actuator
 * config and type
@@ -51,17 +64,24 @@ struct ActuatorConfig {
     ActuatorConfig(ActuatorType t) : type(t){};
     virtual ~ActuatorConfig() = default;
     ActuatorType type;
+    uint32_t id = 0;
 };
 
 /**
 * @name GryoConfig
+* @property rateNoiseStdDev [float], standard deviation of the noise on the measured angular
+* velocity, in rad/s. Optional RateNoiseStdDev key, 0 by default. The NoiseStdDev of a gyroscope
+* is the noise on the measured angle, in rad
 *
 * @details struct outling the configuration of a gryoscope according to the input YAML
 * parameters
 */
 struct GyroConfig : public SensorConfig
 {
-    GyroConfig(const YAML::Node &node) : SensorConfig(SensorType::Gyroscope, node) {}
+    GyroConfig(const YAML::Node &node) : SensorConfig(SensorType::Gyroscope, node) {
+        rateNoiseStdDev = node["RateNoiseStdDev"] ? node["RateNoiseStdDev"].as<float>() : 0;
+    }
+    float rateNoiseStdDev = 0;
 };
 
 /**
@@ -110,26 +130,46 @@ struct ReactionWheelConfig : public ActuatorConfig {
 /**
  * @class Configuration
  *
- * @details class used in configuring the satellite based on its input YAML file
+ * @details immutable configuration of one simulation, loaded from its input YAML file and,
+ * optionally, its exit YAML file. Configurations are only created through Load and are
+ * never modified after, so one loaded configuration can be shared by any number of runs,
+ * including runs on separate threads.
+ *
+ * Loading a file that was already loaded, and has not been modified since, returns the
+ * cached configuration instead of parsing the YAML again.
  *
 **/
 class Configuration {
 public:
     /**
     * @name Load
-    * @param fileName [string], the input YAML file's name
-    * @details loads the input YAML file
+    * @param configFile [string], the input YAML file's name
+    * @param exitFile [string], the exit YAML file's name. Optional, the configuration has
+    * no exit conditions if it is empty.
+    * @return the loaded configuration, or nullptr if either file failed to load or cannot be run
+    *
+    * @details loads the input and exit YAML files. The result is cached by file path and
+    * modification time, so later loads of the same unmodified files skip parsing.
    **/
-    bool Load(const std::string &fileName);
+    static std::shared_ptr<const Configuration> Load(const std::string &configFile, const std::string &exitFile = "");
 
     /**
-    * @name load_exit_file
-    * 
-    * @param fileName [string], the input YAML file's name
-    * 
-    * @details loads the exit YAML file
+    * @name Load
+    * @param config [YAML::Node], the already parsed contents of an input YAML file
+    * @param exit [YAML::Node], the already parsed contents of an exit YAML file. Optional,
+    * the configuration has no exit conditions if it is null.
+    * @return the loaded configuration, or nullptr if it cannot be run
+    *
+    * @details loads the configuration from parsed YAML documents. The result is not cached.
+   **/
+    static std::shared_ptr<const Configuration> Load(const YAML::Node &config, const YAML::Node &exit = YAML::Node());
+
+    /**
+    * @name ClearCache
+    *
+    * @details drops every cached configuration. Configurations still in use are not affected.
    **/
-    bool load_exit_file(const std::string &fileName);
+    static void ClearCache();
 
     /**
     * @details copy constructor is explicitly deleted to prevent C++ from auto-generating one
@@ -141,37 +181,28 @@ public:
    **/
     void operator=(Configuration &) = delete;
 
-    /**
-    * @name GetInstance
-    * @return instance of the satellite configuration
-    *
-    * @details getter for an instance of the satellite's configuration
-   **/
-    inline static Configuration &GetInstance() {
-        static Configuration instance;
-        return instance;
-    };
-
     /**
     * @name GetSensorConfig
     * @param name [string], the name of the sensor
-    * @return the sensor config
+    * @return the sensor config, or nullptr if there is no such sensor
     *
     * @details getter for shared pointer to the sensor config
    **/
-    inline const std::shared_ptr<SensorConfig> &GetSensorConfig(const std::string &name) {
-        return sensorConfigs[name];
+    inline std::shared_ptr<const SensorConfig> GetSensorConfig(const std::string &name) const {
+        const auto it = sensorConfigs.find(name);
+        return (sensorConfigs.end() == it) ? nullptr : it->second;
     };
 
     /**
     * @name GetActuatorConfig
     * @param name [string], the name of the actuator
-    * @return the actuator config
+    * @return the actuator config, or nullptr if there is no such actuator
     *
     * @details getter for shared pointer to the actuator config
    **/
-    inline const std::shared_ptr<ActuatorConfig> &GetActuatorConfig(const std::string &name) {
-        return actuatorConfigs[name];
+    inline std::shared_ptr<const ActuatorConfig> GetActuatorConfig(const std::string &name) const {
+        const auto it = actuatorConfigs.find(name);
+        return (actuatorConfigs.end() == it) ? nullptr : it->second;
     };
 
     /**
@@ -180,7 +211,7 @@ public:
     *
     * @details getter for the map of sensor configs
    **/
-    inline const std::unordered_map<std::string, std::shared_ptr<SensorConfig>> &GetSensorConfigs() {
+    inline const std::unordered_map<std::string, std::shared_ptr<const SensorConfig>> &GetSensorConfigs() const {
         return sensorConfigs;
     };
 
@@ -190,7 +221,7 @@ public:
     *
     * @details getter for the map of actuator configs
    **/
-    inline const std::unordered_map<std::string, std::shared_ptr<ActuatorConfig>> &GetActuatorConfigs() {
+    inline const std::unordered_map<std::string, std::shared_ptr<const ActuatorConfig>> &GetActuatorConfigs() const {
         return actuatorConfigs;
     };
 
@@ -200,7 +231,7 @@ public:
     *
     * @details getter for shared pointer to the satellite's moment of inertia
    **/
-    inline const Eigen::Matrix3f &GetSatelliteMoment() {
+    inline const Eigen::Matrix3f &GetSatelliteMoment() const {
         return satelliteMomentOfInertia;
     };
 
@@ -210,7 +241,7 @@ public:
     *
     * @details getter for shared pointer to the satellite's position
    **/
-    inline const Eigen::Vector3f &GetSatellitePosition() {
+    inline const Eigen::Vector3f &GetSatellitePosition() const {
         return satellitePosition;
     };
 
@@ -220,7 +251,7 @@ public:
     *
     * @details getter for shared pointer to the satellite's velocity
    **/
-    inline const Eigen::Vector3f &GetSatelliteVelocity() {
+    inline const Eigen::Vector3f &GetSatelliteVelocity() const {
         return satelliteVelocity;
     };
 
@@ -230,7 +261,7 @@ public:
     * 
     * @details getter for the update timestep 
     */
-    inline const int &GetTimestepInMilliSeconds(){
+    inline const int &GetTimestepInMilliSeconds() const {
         return timestepInMilliSeconds;
     }
 
@@ -240,30 +271,94 @@ public:
     * 
     * @details getter for the timestep method
     */
-    inline const bool &GetTimestepDecision(){
+    inline const bool &GetTimestepDecision() const {
         return useVariableTimestep;
     }
 
     /**
     * @name GetMaxTimestep
-    * @return whether or not to use variable timestep
+    * @return the max timestep in ms. Fractions of a ms are allowed.
     * 
-    * @details getter for the timestep method
+    * @details getter for the max variable timestep
     */
-    inline const float &GetMaxTimestep(){
+    inline const float &GetMaxTimestep() const {
         return timeStepMax;
     }
 
     /**
     * @name GetMinTimestep
-    * @return whether or not to use variable timestep
+    * @return the min timestep in ms. Fractions of a ms are allowed.
     * 
-    * @details getter for the timestep method
+    * @details getter for the min variable timestep
     */
-    inline const float &GetMinTimestep(){
+    inline const float &GetMinTimestep() const {
         return timeStepMin;
     }
 
+    /**
+    * @name GetIntegratorType
+    * @return the integrator used for the attitude dynamics
+    * 
+    * @details getter for the integrator type
+    */
+    inline const IntegratorType &GetIntegratorType() const {
+        return integratorType;
+    }
+
+    /**
+    * @name GetNoiseSeed
+    * @return the seed of the sensor noise
+    * 
+    * @details getter for the noise seed. Runs with the same seed draw the same noise.
+    */
+    inline const uint64_t &GetNoiseSeed() const {
+        return noiseSeed;
+    }
+
+    /**
+    * @name GetAttitudeFilter
+    * @return the settings of the controller's attitude filter
+    * 
+    * @details getter for the attitude filter settings. The filter is disabled unless the config
+    * yaml has an AttitudeFilter section.
+    */
+    inline const attitude_filter_config &GetAttitudeFilter() const {
+        return attitudeFilter;
+    }
+
+    /**
+    * @name GetControllerGains
+    * @return the gains of the pointing mode controller
+    * 
+    * @details getter for the controller gains. Each gain not set in the ControllerGains section
+    * of the config yaml is the default, see default_controller_gains.
+    */
+    inline const controller_gains &GetControllerGains() const {
+        return controllerGains;
+    }
+
+    /**
+    * @name GetControllerRate
+    * @return the rate of the pointing mode controller, in Hz
+    * 
+    * @details getter for the controller rate. 0 unless the config yaml has a ControllerRate, in
+    * which case the controller runs every time the gyroscope is ready.
+    */
+    inline const float &GetControllerRate() const {
+        return controllerRate;
+    }
+
+    /**
+    * @name GetEnvironment
+    * @return the settings of the orbit, magnetic field and sun models
+    * 
+    * @details getter for the environment settings. The environment is disabled unless the config
+    * yaml has an Environment section.
+    */
+    inline const environment_config &GetEnvironment() const {
+        return environment;
+    }
+
     /**
     * @name    getTimeout
     * 
@@ -271,17 +366,27 @@ public:
     * 
     * @details getter for the timeout
     */
-    inline const int &getTimeout()
+    inline const int &getTimeout() const
     {
         return timeoutInMilliseconds;
     }
 
+    /**
+    * @name    hasExitConditions
+    * 
+    * @returns true if an exit YAML file was loaded with the configuration
+    */
+    inline bool hasExitConditions() const
+    {
+        return exitConditionsLoaded;
+    }
+
     /**
     * @name    getDesiredSatellitePosition
     * 
     * @returns the desired satellite position for the controller
     */
-    inline const Eigen::Vector3f &getDesiredSatellitePosition()
+    inline const Eigen::Vector3f &getDesiredSatellitePosition() const
     {
         return desiredSatellitePosition;
     }
@@ -291,7 +396,7 @@ public:
     * 
     * @returns the allowed jitter for the controller, in degrees/second
     */
-    inline const float &getAllowedJitter()
+    inline const float &getAllowedJitter() const
     {
         return allowed_jitter;
     }
@@ -301,7 +406,7 @@ public:
     * 
     * @returns the required accuracy of the controller, in degrees
     */
-    inline const float &getRequiredAccuracy()
+    inline const float &getRequiredAccuracy() const
     {
         return required_accuracy;
     }
@@ -311,7 +416,7 @@ public:
     * 
     * @returns the amount of time the controller needs to hold the target, in ms
     */
-    inline const int &getHoldTime()
+    inline const int &getHoldTime() const
     {
         return required_hold_time;
     }
@@ -319,77 +424,127 @@ public:
 private:
     /**
     * @name Configuration
-    * @details hidden default constructor for the satellite configuration
+    * @details creates an empty configuration, only used by Load.
    **/
-    Configuration(){};
+    Configuration() = default;
 
-private:
-    
     /**
-    * @details YAML node for the top-most heading in the YAML input file
-    **/
-    YAML::Node top;
+    * @name parse_config
+    * @param top [YAML::Node], the parsed contents of an input YAML file
+    * @return false if the configuration cannot be run, ie the variable timestep bounds are not a
+    * valid range
+    * @details populates the satellite, timestep and device configuration
+   **/
+    bool parse_config(const YAML::Node &top);
+
+    /**
+    * @name parse_exit
+    * @param top [YAML::Node], the parsed contents of an exit YAML file
+    * @details populates the exit conditions
+   **/
+    void parse_exit(const YAML::Node &top);
+
+    /**
+    * @name load_yaml_file
+    * @param fileName [string], the YAML file's name
+    * @param node [YAML::Node], populated with the parsed file
+    * @return true if the file was parsed
+   **/
+    static bool load_yaml_file(const std::string &fileName, YAML::Node *node);
 
     /**
     * @details unordered map of sensor configs that relates strings to names
     **/
-    std::unordered_map<std::string, std::shared_ptr<SensorConfig>> sensorConfigs;
+    std::unordered_map<std::string, std::shared_ptr<const SensorConfig>> sensorConfigs;
 
     /**
     * @details unordered map of actuator configs that relates strings to names
     **/
-    std::unordered_map<std::string, std::shared_ptr<ActuatorConfig>> actuatorConfigs;
+    std::unordered_map<std::string, std::shared_ptr<const ActuatorConfig>> actuatorConfigs;
 
     /**
     * @details 3-dimensional matrix storing the satellite's moment of inertia
     **/
-    Eigen::Matrix3f satelliteMomentOfInertia;
+    Eigen::Matrix3f satelliteMomentOfInertia = Eigen::Matrix3f::Zero();
 
     /**
     * @details 3-dimensional vector storing the satellite's position
     **/
-    Eigen::Vector3f satellitePosition;
+    Eigen::Vector3f satellitePosition = Eigen::Vector3f::Zero();
 
     /**
     * @details 3-dimensional matrix storing the satellite's velocity
     **/
-    Eigen::Vector3f satelliteVelocity;
+    Eigen::Vector3f satelliteVelocity = Eigen::Vector3f::Zero();
 
     /**
      * @details float storing the timestep in milliseconds
     */
-    int timestepInMilliSeconds;
+    int timestepInMilliSeconds = 0;
 
     /**
      * @details int storing the timeout in milliseconds
     */
-    int timeoutInMilliseconds;
+    int timeoutInMilliseconds = 0;
 
     /**
      * @details bool storing whether or not to use variable timestep
     */
-    bool useVariableTimestep;
+    bool useVariableTimestep = false;
 
     /**
      * @details max timestep allowed for the calculated variable timestep
     */
-    float timeStepMax;
+    float timeStepMax = 0;
 
     /**
      * @details min timestep allowed for the calculated variable timestep
     */
-    float timeStepMin;
+    float timeStepMin = 0;
+
+    /**
+     * @details integrator used for the attitude dynamics
+    */
+    IntegratorType integratorType = IntegratorType::Euler;
+
+    /**
+     * @details seed of the sensor noise
+    */
+    uint64_t noiseSeed = 0;
+
+    /**
+     * @details rate of the pointing mode controller, in Hz, 0 to run it whenever the gyroscope is ready
+    */
+    float controllerRate = 0;
+
+    /**
+     * @details settings of the controller's attitude filter
+    */
+    attitude_filter_config attitudeFilter = {false, 0, 0, 0};
+
+    /**
+     * @details gains of the pointing mode controller
+    */
+    controller_gains controllerGains = default_controller_gains();
+
+    /**
+     * @details settings of the environment models
+    */
+    environment_config environment = {false, 0, 0, 0, 0, 0, timestamp(0, 0), ""};
+
+    /* true if an exit YAML file was loaded */
+    bool exitConditionsLoaded = false;
 
     /* the desired satellite position for the controller */
-    Eigen::Vector3f desiredSatellitePosition;
+    Eigen::Vector3f desiredSatellitePosition = Eigen::Vector3f::Zero();
 
     /* the allowed jitter for the controller, in degrees/second */
-    float allowed_jitter;
+    float allowed_jitter = 0;
 
     /* the required accuracy of the controller, in degrees */
-    float required_accuracy;
+    float required_accuracy = 0;
 
     /* the amount of time the controller needs to hold the target, in ms */
-    int required_hold_time;
+    int required_hold_time = 0;
 
 };
@@ -0,0 +1,94 @@
+/**
+ * @file    ConvergenceMonitor.hpp
+ *
+ * @details header file for the hold condition of the exit yaml. The satellite has converged once
+ *          every axis of its attitude has stayed within RequiredAccuracy of the DesiredPosition,
+ *          and every axis of its angular velocity within AllowedJitter, for HoldTime.
+ *
+ *          The window is tracked by the time the satellite last entered the tolerance, so each
+ *          timestep is a handful of compares no matter how long the hold time is: any sample
+ *          outside the tolerance restarts the window, and the condition is met once the newest
+ *          sample is HoldTime after the start of the window. A resumed run starts a new window.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <limits>
+
+#include <Eigen/Dense>
+
+#include "def_interface.hpp"
+
+/**
+ * @class   ConvergenceMonitor
+ *
+ * @details checks the hold condition of a run one timestep at a time.
+**/
+class ConvergenceMonitor
+{
+    public:
+        /**
+         * @name    ConvergenceMonitor constructor
+         *
+         * @param desired_position  attitude the controller is trying to reach, in rad.
+         * @param required_accuracy largest error of any axis of the attitude, in rad.
+         * @param allowed_jitter    largest angular velocity of any axis, in rad/s. 0 or less to
+         *                          not limit the velocity.
+         * @param hold_time         time both have to stay within their tolerance.
+        **/
+        ConvergenceMonitor(const Eigen::Vector3f &desired_position, float required_accuracy, float allowed_jitter, timestamp hold_time) :
+            desired_position(desired_position), required_accuracy(required_accuracy),
+            allowed_jitter((0 < allowed_jitter) ? allowed_jitter : std::numeric_limits<float>::infinity()),
+            hold_time(hold_time) {}
+
+        /**
+         * @name    update
+         *
+         * @details checks the state at the end of a timestep.
+         *
+         * @param time  time at the end of the timestep.
+         * @param theta angular position of the satellite body.
+         * @param omega angular velocity of the satellite body.
+         *
+         * @returns true if the hold condition is met.
+        **/
+        inline bool update(timestamp time, const Eigen::Vector3f &theta, const Eigen::Vector3f &omega)
+        {
+            const bool within = ((this->desired_position - theta).cwiseAbs().maxCoeff() <= this->required_accuracy) &&
+                                (omega.cwiseAbs().maxCoeff() <= this->allowed_jitter);
+            if (!within)
+            {
+                this->holding = false;
+                return false;
+            }
+
+            if (!this->holding)
+            {
+                this->holding    = true;
+                this->held_since = time;
+            }
+            return this->hold_time <= (time - this->held_since);
+        }
+
+        /**
+         * @name    get_held_since
+         *
+         * @returns the time the satellite entered the tolerance it is in, only valid while it is.
+        **/
+        inline timestamp get_held_since() const { return this->held_since; }
+
+    private:
+        const Eigen::Vector3f desired_position;
+        const float           required_accuracy;
+        const float           allowed_jitter;
+        const timestamp       hold_time;
+
+        bool      holding    = false;
+        timestamp held_since = 0;
+};
@@ -0,0 +1,128 @@
+/**
+ * @file    DeviceArena.hpp
+ *
+ * @details This file describes the storage of the sensors and actuators of one simulation run.
+ *
+ * @authors Aidan Sheedy, Lily de Loe
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "sim_interface.hpp"
+#include "Simulator.hpp"
+#include "ConfigurationSingleton.hpp"
+
+/**
+ * @class   DeviceArena
+ *
+ * @details owns every device of a run. The devices are built in place in one buffer sized from
+ *          the configuration: first the gyroscopes, then the accelerometers, then the reaction
+ *          wheels, each at the index of its id, so they never move. The control code is given
+ *          the registry of typed pointers into the buffer.
+ *
+ *          Each thread keeps its buffer and registry between runs, so a thread running many
+ *          runs, eg a batch worker, only allocates when a run has more devices than any before.
+ *          An arena created while another is alive on the same thread gets storage of its own.
+**/
+class DeviceArena
+{
+    public:
+        /**
+         * @name    DeviceArena constructor
+         *
+         * @details creates every sensor and actuator of the configuration.
+         *
+         * @param config the configuration of the run.
+         * @param sim    the simulator the devices communicate with.
+         *
+         * @exception invalid_adcs_param the device ids are not dense, or a device is invalid.
+        **/
+        DeviceArena(const Configuration &config, Simulator *sim);
+
+        /**
+         * @name    DeviceArena destructor
+         *
+         * @details destroys every device, and hands the storage back to the thread.
+        **/
+        ~DeviceArena();
+
+        /**
+         * @details copying is explicitly deleted, as the registry points into the arena.
+        **/
+        DeviceArena(const DeviceArena &) = delete;
+
+        /**
+         * @details equals operator is explicitly deleted, as the registry points into the arena.
+        **/
+        void operator=(const DeviceArena &) = delete;
+
+        /**
+         * @name    get_registry
+         *
+         * @returns the typed pointers to every device, valid for the lifetime of the arena.
+        **/
+        inline const device_registry &get_registry() const
+        {
+            return storage->registry;
+        }
+
+    private:
+        /**
+         * @struct  device_storage
+         *
+         * @details memory the devices of a run are built in, kept between runs.
+         *
+         * @param buffer            the devices, in blocks of the largest alignment.
+         * @param capacity          number of blocks in the buffer.
+         * @param registry          pointers to the devices in the buffer.
+         * @param sensor_order      configs of a sensor type in id order, kept to reuse the list.
+         * @param actuator_order    configs of an actuator type in id order, kept to reuse the list.
+         * @param in_use            true while an arena holds the storage.
+        **/
+        typedef struct
+        {
+            std::unique_ptr<std::max_align_t[]> buffer;
+            size_t                              capacity;
+            device_registry                     registry;
+            std::vector<const SensorConfig *>   sensor_order;
+            std::vector<const ActuatorConfig *> actuator_order;
+            bool                                in_use;
+        } device_storage;
+
+        /**
+         * @name    blocks_for
+         *
+         * @returns the number of buffer blocks that hold count devices of a type.
+        **/
+        template <typename Device>
+        static size_t blocks_for(size_t count);
+
+        /**
+         * @name    release
+         *
+         * @details destroys the devices built so far, in reverse order, and hands the storage back.
+        **/
+        void release();
+
+        /* Storage of every thread that has run a simulation, reused by its next arena. */
+        static thread_local device_storage thread_storage;
+
+        /* Storage of this arena, if the thread's storage was already in use. */
+        std::unique_ptr<device_storage> own_storage;
+
+        /* Storage the devices are built in. */
+        device_storage *storage;
+
+        /* First device of each type in the buffer. */
+        Gyroscope      *gyroscopes      = nullptr;
+        Accelerometer  *accelerometers  = nullptr;
+        Reaction_wheel *reaction_wheels = nullptr;
+};
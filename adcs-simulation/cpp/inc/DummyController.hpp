@@ -6,7 +6,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-14
+ * 2026-10-14
 **/
 
 #pragma once
@@ -45,6 +45,16 @@ public:
     **/
     void begin();
 
+    /**
+     * @name step
+     *
+     * @details One step of the command loop, for runs that drive the controller as a task.
+     *
+     * @returns [timestamp], the time to sleep before the next step.
+     *
+    **/
+    timestamp step();
+
 private:
     /* Timer used to update the simulation. */
     ADCS_timer *timer;
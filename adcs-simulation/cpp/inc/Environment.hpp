@@ -0,0 +1,289 @@
+/**
+ * @file Environment.hpp
+ *
+ * @details header file for the environment of the satellite: its orbit, the Earth's magnetic field
+ *          and the position and intensity of the sun. The models are far more expensive than a
+ *          timestep, and change slowly next to the attitude, so they are only evaluated on a
+ *          coarse time grid when a run starts. The simulator linearly interpolates the grid,
+ *          which is a handful of multiply-adds per lookup.
+ *
+ *          Models, all in the inertial (J2000 equatorial) frame:
+ *              orbit           circular Keplerian orbit of the configured altitude and plane.
+ *              magnetic field  dipole terms of IGRF-13 (epoch 2020), rotated with the Earth.
+ *              sun             low precision solar ephemeris of the Astronomical Almanac (about
+ *                              0.01 degrees), with a cylindrical Earth shadow for eclipses.
+ *
+ *          With the default 10 s grid the interpolated position is within about 100 m of the
+ *          orbit of a 500 km satellite, and the field and sun direction within a fraction of a
+ *          percent. Eclipse edges are smeared over one grid step.
+ *
+ *          A table can be written to a file and memory mapped read-only by later runs, so every
+ *          run of a batch sweep, and every process on the host, shares one copy of the same
+ *          orbit instead of computing it again.
+ *
+ *          File layout (all values little-endian, as written by the host):
+ *              char[8]   magic "ADCSENV" followed by a null byte
+ *              uint32_t  format version
+ *              uint32_t  number of values per sample (10)
+ *              uint64_t  grid step, in microseconds
+ *              uint64_t  number of samples
+ *              float64   altitude (m), inclination, right ascension of the ascending node and
+ *                        initial argument of latitude (rad), then the epoch (days since J2000)
+ *              float32[10] per sample: position (m), magnetic field (T), sun direction, then the
+ *                        solar irradiance (W/m^2)
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "adcs_exception.hpp"
+#include "def_interface.hpp"
+
+/**
+ * @struct  environment_config
+ *
+ * @details settings of the environment models.
+ *
+ * @param enabled                       true if the config yaml has an Environment section.
+ * @param altitude                      altitude of the circular orbit above the reference radius, in m.
+ * @param inclination                   inclination of the orbit, in rad.
+ * @param right_ascension               right ascension of the ascending node, in rad.
+ * @param initial_argument_of_latitude  angle from the ascending node at time 0, in rad.
+ * @param epoch                         date of time 0, in days since J2000 (2000-01-01 12:00 TT).
+ * @param grid_step                     time between two samples of the table.
+ * @param table_path                    precomputed table to map instead of evaluating the
+ *                                      models, empty to evaluate them.
+**/
+typedef struct
+{
+    bool        enabled;
+    double      altitude;
+    double      inclination;
+    double      right_ascension;
+    double      initial_argument_of_latitude;
+    double      epoch;
+    timestamp   grid_step;
+    std::string table_path;
+} environment_config;
+
+/**
+ * @struct  environment_sample
+ *
+ * @details the environment at one time, in the inertial frame.
+ *
+ * @param position          position of the satellite, in m.
+ * @param magnetic_field    magnetic field at the satellite, in T.
+ * @param sun_direction     unit vector from the satellite to the sun.
+ * @param sun_irradiance    solar irradiance at the satellite, in W/m^2. 0 in eclipse.
+**/
+typedef struct
+{
+    Eigen::Vector3f position;
+    Eigen::Vector3f magnetic_field;
+    Eigen::Vector3f sun_direction;
+    float           sun_irradiance;
+} environment_sample;
+
+namespace EnvironmentModels
+{
+    /**
+     * @name    evaluate
+     *
+     * @details evaluates every model directly. Used to fill a table, too slow for every timestep.
+     *
+     * @param config the settings of the models.
+     * @param time   time since the epoch of the configuration.
+     *
+     * @returns the environment at that time.
+    **/
+    environment_sample evaluate(const environment_config &config, timestamp time);
+}
+
+/**
+ * @class   EnvironmentTable
+ *
+ * @details the environment models sampled on a uniform time grid. Tables are immutable once
+ *          built or mapped, so one table can be shared by any number of runs and threads.
+**/
+class EnvironmentTable
+{
+    public:
+        /* Magic string at the start of every table file, including the null byte. */
+        static constexpr char magic[8] = "ADCSENV";
+
+        /* Version of the file layout. */
+        static constexpr uint32_t format_version = 1;
+
+        /* Number of floats stored per sample. */
+        static constexpr uint32_t values_per_sample = 10;
+
+        /**
+         * @name    build
+         *
+         * @details evaluates the models on the grid of the configuration.
+         *
+         * @param config   the settings of the models.
+         * @param duration time the table must cover from time 0.
+         *
+         * @exception invalid_environment_table the grid step is 0.
+        **/
+        static std::shared_ptr<const EnvironmentTable> build(const environment_config &config, timestamp duration);
+
+        /**
+         * @name    map
+         *
+         * @details memory maps a table file read-only. The pages are shared with every other
+         *          mapping of the file, and are only read from disk as they are used.
+         *
+         * @param path path of the table file.
+         *
+         * @exception invalid_environment_table the file is missing, truncated, or not a table.
+        **/
+        static std::shared_ptr<const EnvironmentTable> map(const std::string &path);
+
+        /**
+         * @name    load
+         *
+         * @details maps the table named by the configuration, or builds one if it names none.
+         *
+         * @param config   the settings of the models.
+         * @param duration time the table must cover from time 0.
+         *
+         * @exception invalid_environment_table the table cannot be mapped or is too short.
+        **/
+        static std::shared_ptr<const EnvironmentTable> load(const environment_config &config, timestamp duration);
+
+        /**
+         * @name    write
+         *
+         * @details writes the table to a file that map can read. The file is written next to the
+         *          path and then renamed.
+         *
+         * @param path path of the table file. Missing directories are created.
+         *
+         * @exception invalid_environment_table the file could not be written.
+        **/
+        void write(const std::string &path) const;
+
+        EnvironmentTable(const EnvironmentTable &) = delete;
+        void operator=(const EnvironmentTable &) = delete;
+        ~EnvironmentTable();
+
+        /**
+         * @name    sample
+         *
+         * @details interpolates the table. Times after the end of the table get its last sample.
+         *
+         * @param time time since the epoch of the table.
+         *
+         * @returns the environment at that time.
+        **/
+        inline environment_sample sample(timestamp time) const
+        {
+            const uint64_t t     = time.microseconds();
+            const uint64_t index = t / this->step;
+
+            if (index + 1 >= this->num_samples)
+            {
+                return this->sample_at(this->num_samples - 1);
+            }
+
+            const float f = static_cast<float>(t - index * this->step) * this->inverse_step;
+            const float *a = this->values + index * values_per_sample;
+            const float *b = a + values_per_sample;
+
+            float v[values_per_sample];
+            for (uint32_t i = 0; i < values_per_sample; i++)
+            {
+                v[i] = a[i] + f * (b[i] - a[i]);
+            }
+
+            environment_sample s;
+            s.position       = Eigen::Vector3f(v[0], v[1], v[2]);
+            s.magnetic_field = Eigen::Vector3f(v[3], v[4], v[5]);
+            s.sun_direction  = Eigen::Vector3f(v[6], v[7], v[8]).normalized();
+            s.sun_irradiance = v[9];
+            return s;
+        }
+
+        /**
+         * @name    get_duration
+         *
+         * @returns the time covered by the table, from time 0.
+        **/
+        inline timestamp get_duration() const
+        {
+            return timestamp::from_microseconds((this->num_samples - 1) * this->step);
+        }
+
+        /**
+         * @name    get_config
+         *
+         * @returns the settings the table was built with.
+        **/
+        inline const environment_config &get_config() const
+        {
+            return this->config;
+        }
+
+        /**
+         * @name    is_mapped
+         *
+         * @returns true if the table is memory mapped from a file.
+        **/
+        inline bool is_mapped() const
+        {
+            return nullptr != this->mapping;
+        }
+
+    private:
+        EnvironmentTable() = default;
+
+        /**
+         * @name    sample_at
+         *
+         * @returns the sample at a point of the grid.
+        **/
+        environment_sample sample_at(uint64_t index) const;
+
+        /* The settings the table was built with */
+        environment_config config = {};
+
+        /* Grid step and its inverse, in microseconds */
+        uint64_t step         = 1;
+        float    inverse_step = 1;
+
+        /* Number of samples, at least 2 */
+        uint64_t num_samples = 0;
+
+        /* The samples, either owned or in the mapping */
+        const float       *values = nullptr;
+        std::vector<float> owned;
+
+        /* The mapped file, nullptr if the table was built */
+        void  *mapping      = nullptr;
+        size_t mapping_size = 0;
+};
+
+/**
+ * @exception invalid_environment_table
+ *
+ * @details exception used to indicate that an environment table could not be built, read or
+ *          written, or does not cover the run it is used by.
+**/
+class invalid_environment_table : public adcs_exception
+{
+    public:
+        invalid_environment_table(const char* msg) : adcs_exception(msg) {}
+};
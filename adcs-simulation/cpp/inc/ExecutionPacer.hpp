@@ -0,0 +1,279 @@
+/**
+ * @file    ExecutionPacer.hpp
+ *
+ * @details This file describes how simulated time is tied to wall time. The simulator runs in one
+ *          of three execution modes:
+ *              AsFastAsPossible: pure virtual time. The simulator never reads the wall clock, this
+ *                                is the mode used for regression and batch runs.
+ *              Paced:            simulated time is held to k times real time, for hardware in the
+ *                                loop sessions. The jitter of each wake up and every overrun (a
+ *                                timestep finished after its wall clock deadline) are recorded.
+ *              Lockstep:         simulated time only advances as far as an external tick source
+ *                                allows. Each tick grants another duration of simulated time.
+ *
+ *          The simulator asks the pacer how far it may simulate before each timestep, and hands
+ *          the pacer the new time after each timestep. In the fast mode the simulator has no pacer
+ *          at all.
+ *
+ *          Tick files: each line is the number of ms of simulated time to allow, eg "10". A line
+ *          "end" stops waiting for ticks, and the rest of the run goes as fast as possible. The
+ *          end of a regular file does the same. A named pipe (mkfifo) stays open, so any number
+ *          of writers can tick it in turn.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "adcs_exception.hpp"
+#include "def_interface.hpp"
+
+/**
+* @details enum class for the relationship between simulated time and wall time.
+*/
+enum class ExecutionMode : uint8_t {
+    AsFastAsPossible,
+    Paced,
+    Lockstep
+};
+
+/**
+ * @struct  pacing_stats
+ *
+ * @details how well a paced or lockstep run kept to its clock.
+ *
+ * @param paced_steps    number of times the simulator was held back to the wall clock.
+ * @param overruns       number of times a timestep finished after its wall clock deadline.
+ * @param max_overrun    latest a timestep finished after its deadline.
+ * @param mean_jitter    mean time between each deadline and the simulator waking up for it.
+ * @param jitter_stddev  standard deviation of the jitter.
+ * @param max_jitter     largest jitter.
+ * @param ticks          number of ticks received in lockstep.
+ * @param tick_wait      time spent waiting for ticks in lockstep.
+ * @param wall_time      wall time since the run started.
+ * @param simulated_time simulated time since the run started.
+**/
+typedef struct
+{
+    uint64_t                 paced_steps;
+    uint64_t                 overruns;
+    std::chrono::nanoseconds max_overrun;
+    std::chrono::nanoseconds mean_jitter;
+    std::chrono::nanoseconds jitter_stddev;
+    std::chrono::nanoseconds max_jitter;
+    uint64_t                 ticks;
+    std::chrono::nanoseconds tick_wait;
+    std::chrono::nanoseconds wall_time;
+    timestamp                simulated_time;
+} pacing_stats;
+
+/**
+ * @class   ExecutionPacer
+ *
+ * @details holds a simulator to the wall clock or to an external tick, as set by its mode.
+**/
+class ExecutionPacer
+{
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        /* Returned by limit when the simulator may run as far as it likes. */
+        static constexpr timestamp unlimited = timestamp::from_microseconds(std::numeric_limits<uint64_t>::max());
+
+        /**
+         * @name    ExecutionPacer constructor
+         *
+         * @param mode             the execution mode.
+         * @param real_time_factor simulated seconds per wall second in the paced mode.
+         *
+         * @exception invalid_execution_mode the real time factor is not positive.
+        **/
+        ExecutionPacer(ExecutionMode mode = ExecutionMode::AsFastAsPossible, double real_time_factor = 1);
+
+        /**
+         * @name    ExecutionPacer destructor
+         *
+         * @details stops reading ticks.
+        **/
+        ~ExecutionPacer();
+
+        ExecutionPacer(const ExecutionPacer&) = delete;
+        ExecutionPacer &operator=(const ExecutionPacer&) = delete;
+
+        /**
+         * @name    get_mode
+         *
+         * @returns the execution mode.
+        **/
+        inline ExecutionMode get_mode() const { return this->mode; }
+
+        /**
+         * @name    begin
+         *
+         * @details starts the clock of a run. Clears the statistics and any ticks of a previous run.
+         *
+         * @param   simulation_time the simulated time the run starts at.
+        **/
+        void begin(timestamp simulation_time);
+
+        /**
+         * @name    limit
+         *
+         * @details called before each timestep. In lockstep, waits until a tick allows time after
+         *          simulation_time.
+         *
+         * @param   simulation_time the current simulated time.
+         *
+         * @returns the latest time that may be simulated before the next call, or unlimited.
+        **/
+        timestamp limit(timestamp simulation_time);
+
+        /**
+         * @name    pace
+         *
+         * @details called after each timestep. In the paced mode, sleeps until the wall time of
+         *          simulation_time. Deadlines are absolute, so a run that overran catches up. The
+         *          simulator is only held back once per min_pace_interval of wall time, so very
+         *          short timesteps do not each cost a sleep.
+         *
+         * @param   simulation_time the simulated time after the timestep.
+        **/
+        void pace(timestamp simulation_time);
+
+        /**
+         * @name    tick
+         *
+         * @details allows another duration of simulated time in lockstep. Safe to call from any
+         *          thread.
+        **/
+        void tick(timestamp duration);
+
+        /**
+         * @name    release
+         *
+         * @details stops waiting for ticks. The rest of the run goes as fast as possible. Safe to
+         *          call from any thread.
+        **/
+        void release();
+
+        /**
+         * @name    read_ticks
+         *
+         * @details starts a thread that ticks from a file or named pipe, as described above.
+         *
+         * @param   path path of the tick file.
+         *
+         * @exception invalid_execution_mode the file cannot be opened.
+        **/
+        void read_ticks(const std::string &path);
+
+        /**
+         * @name    stop
+         *
+         * @details stops reading ticks and releases the simulator.
+        **/
+        void stop();
+
+        /**
+         * @name    get_stats
+         *
+         * @returns the statistics of the run so far. Only call once the run is stopped.
+        **/
+        pacing_stats get_stats() const;
+
+        /**
+         * @name    summary
+         *
+         * @returns a description of the statistics of the run, for the terminal.
+        **/
+        std::string summary() const;
+
+        /**
+         * @name    mode_name
+         *
+         * @returns the name of a mode.
+        **/
+        static const char *mode_name(ExecutionMode mode);
+
+    private:
+        /**
+         * @name    tick_reader
+         *
+         * @details body of the tick thread.
+        **/
+        void tick_reader(int fd);
+
+        /**
+         * @name    join_tick_thread
+         *
+         * @details stops the tick thread, if there is one, and waits for it to finish.
+        **/
+        void join_tick_thread();
+
+        /* Least wall time between two pauses of the paced mode. */
+        static constexpr std::chrono::microseconds min_pace_interval = std::chrono::microseconds(1000);
+
+        /* The execution mode */
+        const ExecutionMode mode;
+
+        /* Simulated seconds per wall second in the paced mode */
+        const double real_time_factor;
+
+        /* Wall time and simulated time the run started at */
+        clock::time_point start_wall;
+        timestamp         start_simulation;
+
+        /* Last deadline the simulator was held back to, and the time of the last timestep */
+        clock::time_point last_deadline;
+        timestamp         last_simulation;
+
+        /* Pacing statistics. Jitter is accumulated in ns for the mean and variance. */
+        uint64_t                 paced_steps = 0;
+        uint64_t                 overruns    = 0;
+        std::chrono::nanoseconds max_overrun = std::chrono::nanoseconds(0);
+        std::chrono::nanoseconds max_jitter  = std::chrono::nanoseconds(0);
+        double                   jitter_sum    = 0;
+        double                   jitter_sum_sq = 0;
+
+        /* Guards the lockstep state below, which the tick thread changes */
+        mutable std::mutex      tick_mutex;
+        std::condition_variable tick_received;
+
+        /* Simulated time the ticks so far allow */
+        timestamp granted;
+
+        /* True once ticks are no longer waited for */
+        bool released = false;
+
+        /* Lockstep statistics */
+        uint64_t                 ticks     = 0;
+        std::chrono::nanoseconds tick_wait = std::chrono::nanoseconds(0);
+
+        /* Thread reading the tick file, and the flag that stops it */
+        std::thread       tick_thread;
+        std::atomic<bool> stopping{false};
+};
+
+/**
+ * @exception invalid_execution_mode
+ *
+ * @details exception used to indicate that an execution mode cannot be used as requested.
+**/
+class invalid_execution_mode : public adcs_exception
+{
+    public:
+        invalid_execution_mode(const char* msg) : adcs_exception(msg) {}
+};
@@ -0,0 +1,247 @@
+/**
+ * @file    GainTuner.hpp
+ *
+ * @details This file describes the gain tuner. A tuning yaml names a base config yaml, an exit
+ *          yaml, and the parameters to tune, usually the ControllerGains of the config yaml. Each
+ *          candidate is one run of the base config with the parameters set, scored by a cost of
+ *          its settle time, overshoot and reaction wheel saturation. The candidates of each round
+ *          run in parallel as one batch, see BatchRunner.hpp.
+ *
+ *          Runs end as soon as the exit yaml hold condition is met, so a good candidate costs
+ *          little more than its settle time. A Checkpoint lets every candidate start from one
+ *          shared prefix, eg a run of the base config without an exit yaml, after which the
+ *          controller starts with the candidate gains.
+ *
+ *          Tuning yaml format:
+ *              BaseConfig: [string], path to the config yaml every candidate starts from
+ *              ExitConfig: [string], path to the exit yaml
+ *              Checkpoint: [string], path of a checkpoint every candidate resumes from. Optional
+ *              Threads: [int], number of worker threads. Optional, default is one per core
+ *              SettleTolerance: [float], error in rad under which the satellite counts as settled.
+ *                               Optional, default is the RequiredAccuracy from the exit yaml
+ *              Output: [string], path of the results csv. Optional
+ *              Search: Grid or Compass. Optional, default Grid
+ *                  Grid tries every combination of Steps values of each parameter.
+ *                  Compass starts from the Initial values and each round tries a step up and down
+ *                  of every parameter, moving to the best candidate, or halving the step if none
+ *                  is better. The step starts at a quarter of each range.
+ *              Rounds: [int], largest number of Compass rounds. Optional, default 10
+ *              Cost: weights of the cost of a candidate. Optional, each defaults as below
+ *                  SettleTime: [float], per s to settle, or to the end of an unsettled run. Default 1
+ *                  Overshoot: [float], per rad past the desired position. Default 100
+ *                  Saturation: [float], per peak wheel speed over its max speed. Default 10
+ *                  Unsettled: [float], added if the run has not settled by its end. Default 1000
+ *              Parameters: list of
+ *                  Path: [string], dot separated key in the config yaml, eg ControllerGains.Kp.
+ *                        Prefix with "Exit." to tune the exit yaml instead.
+ *                  Min, Max: [float], range of the parameter
+ *                  Steps: [int], number of Grid values, evenly spaced from Min to Max. Default 5
+ *                  Log: [bool], space the values logarithmically. Optional, default FALSE
+ *                  Initial: [float], start of the Compass search. Optional, default the middle
+ *                  Scale: [bool], multiply the base value by the parameter instead of replacing
+ *                         it, eg to scale a gain of every axis. Optional, default FALSE
+ *
+ *          Every candidate draws the same sensor noise. The results csv has one row per
+ *          candidate, and the best one is reported at the end.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "Messenger.hpp"
+#include "BatchRunner.hpp"
+
+/**
+ * @class   GainTuner
+ *
+ * @details loads a tuning yaml and searches for the parameters with the lowest cost.
+**/
+class GainTuner
+{
+    public:
+        /**
+         * @name    GainTuner constructor
+         *
+         * @param tuning_yaml_path  path to the tuning yaml.
+         * @param messenger         messenger used to report progress. Runs use their own.
+         *
+         * @exception invalid_tuning_spec the tuning yaml is missing or invalid.
+        **/
+        GainTuner(const std::string &tuning_yaml_path, Messenger *messenger);
+
+        /**
+         * @name    run
+         *
+         * @details runs the search, writes the results csv and reports the best candidate.
+         *
+         * @exception invalid_batch_spec the candidates cannot be run, eg a path is not in the yaml.
+        **/
+        void run();
+
+        /**
+         * @name    get_default_output_path
+         *
+         * @returns the results csv path used if the tuning yaml does not provide one.
+        **/
+        inline static std::string get_default_output_path()
+        {
+            return "output/tuning_results.csv";
+        }
+
+    private:
+        /**
+        * @details enum class for how the candidates are chosen.
+        */
+        enum class Search{
+            Grid,
+            Compass
+        };
+
+        /**
+         * @struct  tuning_parameter
+         *
+         * @details one parameter of the search, as read from the tuning yaml.
+        **/
+        typedef struct
+        {
+            std::string path;
+            float       min;
+            float       max;
+            uint32_t    steps;
+            bool        log;
+            float       initial;
+            bool        scale;
+        } tuning_parameter;
+
+        /**
+         * @struct  cost_weights
+         *
+         * @details weights of each term of the cost, see the tuning yaml format.
+        **/
+        typedef struct
+        {
+            float settle_time;
+            float overshoot;
+            float saturation;
+            float unsettled;
+        } cost_weights;
+
+        /**
+         * @struct  evaluation
+         *
+         * @details one candidate and the result of its run.
+        **/
+        typedef struct
+        {
+            uint32_t                round;
+            std::vector<float>      point;
+            std::vector<float>      values;
+            BatchRunner::run_result result;
+            float                   cost;
+        } evaluation;
+
+        /**
+         * @name    grid_search
+         *
+         * @details evaluates every combination of the Steps values of each parameter.
+        **/
+        void grid_search();
+
+        /**
+         * @name    compass_search
+         *
+         * @details evaluates steps around the best candidate until the rounds run out or the step
+         *          is too small to matter.
+        **/
+        void compass_search();
+
+        /**
+         * @name    evaluate
+         *
+         * @details runs the candidates that have not been run yet as one batch.
+         *
+         * @param round     round of the search, for the results csv.
+         * @param points    position of each candidate in the range of each parameter, from 0 at
+         *                  Min to 1 at Max.
+         *
+         * @returns the index in evaluations of the best candidate of points.
+        **/
+        size_t evaluate(uint32_t round, const std::vector<std::vector<float>> &points);
+
+        /**
+         * @name    to_value
+         *
+         * @returns the value of a parameter at a position in its range.
+        **/
+        float to_value(const tuning_parameter &parameter, float position) const;
+
+        /**
+         * @name    to_position
+         *
+         * @returns the position of a value of a parameter in its range.
+        **/
+        float to_position(const tuning_parameter &parameter, float value) const;
+
+        /**
+         * @name    cost
+         *
+         * @returns the cost of a run, infinity if it failed.
+        **/
+        float cost(const BatchRunner::run_result &result) const;
+
+        /**
+         * @name    write_results
+         *
+         * @details writes one row per candidate to the results csv.
+        **/
+        void write_results();
+
+        /* Messenger used to report progress */
+        Messenger *messenger;
+
+        /* Keys of the tuning yaml that are passed to each batch as they are */
+        YAML::Node batch_base;
+
+        /* Parameters of the search */
+        std::vector<tuning_parameter> parameters;
+
+        /* How the candidates are chosen */
+        Search search = Search::Grid;
+
+        /* Largest number of Compass rounds */
+        uint32_t rounds = 10;
+
+        /* Weights of the cost */
+        cost_weights weights = {1, 100, 10, 1000};
+
+        /* Path of the results csv */
+        std::string output_path;
+
+        /* Every candidate run so far, in order */
+        std::vector<evaluation> evaluations;
+
+        /* Index in evaluations of each candidate run so far, by position */
+        std::map<std::vector<float>, size_t> evaluated;
+};
+
+/**
+ * @exception invalid_tuning_spec
+ *
+ * @details exception used to indicate that the tuning yaml is not valid.
+**/
+class invalid_tuning_spec : public adcs_exception
+{
+    public:
+        invalid_tuning_spec(const char* msg) : adcs_exception(msg) {}
+};
@@ -0,0 +1,156 @@
+/**
+ * @file Integrator.hpp
+ *
+ * @details header file for the numerical integrators used to propagate the satellite attitude
+ *          dynamics. The integrator is selected with the "Integrator" key in the config YAML.
+ *
+ * @authors Lily de Loe, Justin Paoli, Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <memory>
+#include <Eigen/Dense>
+
+#include "CommonStructs.hpp"
+
+/**
+ * @struct  rigid_body_dynamics
+ *
+ * @details everything needed to evaluate the satellite body acceleration over one timestep. The
+ *          reaction wheel accelerations are constant over a timestep, so their summed momentum is
+ *          linear in time: rw_momentum(t) = rw_momentum + rw_torque * t.
+ *
+ * @param inertia_b          inertia tensor of the satellite body.
+ * @param inertia_b_inverse  inverse of the satellite body inertia tensor.
+ * @param rw_torque          summed reaction wheel torque (I_rw * a_rw * axis) in the body frame.
+ * @param rw_momentum        summed reaction wheel momentum (I_rw * w_rw * axis) at the start of
+ *                           the timestep, in the body frame.
+**/
+typedef struct
+{
+    Eigen::Matrix3f inertia_b;
+    Eigen::Matrix3f inertia_b_inverse;
+    Eigen::Vector3f rw_torque;
+    Eigen::Vector3f rw_momentum;
+} rigid_body_dynamics;
+
+/**
+ * @name    body_acceleration
+ *
+ * @details evaluates the angular acceleration of the satellite body.
+ *
+ * @param dynamics  the dynamics of the current timestep.
+ * @param t         time since the start of the timestep in seconds.
+ * @param omega_b   angular velocity of the satellite body.
+ *
+ * @returns the angular acceleration of the satellite body.
+**/
+inline Eigen::Vector3f body_acceleration(const rigid_body_dynamics &dynamics, float t, const Eigen::Vector3f &omega_b)
+{
+    Eigen::Vector3f sum_rw = dynamics.rw_torque + omega_b.cross(dynamics.rw_momentum + dynamics.rw_torque * t);
+
+    return (-dynamics.inertia_b_inverse * omega_b).cross(dynamics.inertia_b * omega_b)
+        - dynamics.inertia_b_inverse * sum_rw;
+}
+
+/**
+ * @class Integrator
+ *
+ * @details Base class for the integrators that advance the satellite attitude by one timestep.
+ *
+**/
+class Integrator {
+public:
+    /**
+     * @name Integrator destructor
+     *
+     * @details virtual as this class is a base class with virtual functions.
+    **/
+    virtual ~Integrator(){}
+
+    /**
+     * @name step
+     *
+     * @details advances the satellite body position and velocity by one timestep.
+     *
+     * @param dynamics  the dynamics of the current timestep.
+     * @param dt        length of the timestep in seconds.
+     * @param satellite the satellite body to advance. theta_b and omega_b are updated, and alpha_b
+     *                  is set to the body acceleration at the start of the timestep.
+     *
+     * @returns an estimate of the local error in the body position (rad) over the timestep, or 0
+     *          if the integrator does not provide one.
+    **/
+    virtual float step(const rigid_body_dynamics &dynamics, float dt, Satellite *satellite) = 0;
+
+    /**
+     * @name is_adaptive
+     *
+     * @returns true if step() returns an error estimate that should be used to size the timestep.
+    **/
+    virtual bool is_adaptive() { return false; }
+
+    /**
+     * @name order
+     *
+     * @returns the order of the error estimate, used to scale the next timestep.
+    **/
+    virtual float order() { return 1; }
+};
+
+/**
+ * @class EulerIntegrator
+ *
+ * @details semi-implicit Euler integration. The velocity is updated first and the new velocity is
+ *          used to update the position. This is the original simulator behaviour.
+ *
+ * @implements Integrator
+**/
+class EulerIntegrator : public Integrator {
+public:
+    float step(const rigid_body_dynamics &dynamics, float dt, Satellite *satellite);
+};
+
+/**
+ * @class RK4Integrator
+ *
+ * @details classic fourth order Runge-Kutta integration with a fixed timestep.
+ *
+ * @implements Integrator
+**/
+class RK4Integrator : public Integrator {
+public:
+    float step(const rigid_body_dynamics &dynamics, float dt, Satellite *satellite);
+};
+
+/**
+ * @class DormandPrinceIntegrator
+ *
+ * @details Dormand-Prince 5(4) integration. The difference between the embedded fourth and fifth
+ *          order solutions is returned as the error estimate so the simulator can adapt the
+ *          timestep.
+ *
+ * @implements Integrator
+**/
+class DormandPrinceIntegrator : public Integrator {
+public:
+    float step(const rigid_body_dynamics &dynamics, float dt, Satellite *satellite);
+    bool is_adaptive() { return true; }
+    float order() { return 5; }
+};
+
+/**
+ * @name    make_integrator
+ *
+ * @details creates the integrator matching the requested type.
+ *
+ * @param type the integrator type from the config YAML.
+ *
+ * @returns a pointer to the new integrator.
+**/
+std::unique_ptr<Integrator> make_integrator(IntegratorType type);
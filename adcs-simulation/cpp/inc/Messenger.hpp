@@ -7,7 +7,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-18
+ * 2026-10-14
  *
 **/
 
@@ -16,19 +16,180 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
 
 #include "CommonStructs.hpp"
+#include "SensorState.hpp"
+#include "SpscRingBuffer.hpp"
+#include "SharedTelemetry.hpp"
+#include "TrajectoryWriter.hpp"
+#include "SummaryWriter.hpp"
 #include "def_interface.hpp"
+#include "Profiler.hpp"
+
+/**
+* @details enum class for the simulation output format.
+*   CSV     - human readable csv, held in memory and written when the simulation ends.
+*   Binary  - columnar binary file streamed to disk in chunks, see TrajectoryWriter.hpp.
+*/
+enum class OutputFormat{
+    CSV,
+    Binary
+};
+
+/**
+* @details enum class for what the simulation does when the telemetry writer falls behind.
+*   Block   - the simulation waits for space in the queue. No samples are lost.
+*   Drop    - the sample is discarded and counted. The simulation never waits on output.
+*/
+enum class BackpressurePolicy{
+    Block,
+    Drop
+};
+
+/**
+ * @class   sim_state_view
+ *
+ * @details read-only view of the simulation state at the end of a timestep, published by the
+ *          Simulator to the Messenger. It only refers to the Simulator's own state, so creating one
+ *          never copies or allocates. A view is only valid until the next timestep. The sensors
+ *          are only derived if they are read, see SensorState.hpp.
+**/
+class sim_state_view
+{
+    public:
+        /**
+         * @name    sim_state_view constructor
+         *
+         * @param state     the simulator state to view.
+         * @param sensors   the sensors of the state.
+         * @param time      time at the end of the timestep.
+         * @param timestep  length of the timestep.
+        **/
+        sim_state_view(const sim_config &state, SensorState &sensors, timestamp time, timestamp timestep) :
+            state(state), sensors(sensors), state_time(time), state_timestep(timestep) {}
+
+        /* The satellite body. */
+        inline const Satellite &satellite() const { return state.satellite; }
+
+        /* The accelerometer. */
+        inline const sim_accelerometer &accelerometer() const { return sensors.accelerometer(); }
+
+        /* The gyroscope. */
+        inline const sim_gyroscope &gyroscope() const { return sensors.gyroscope(); }
+
+        /* Every reaction wheel. */
+        inline const sim_reaction_wheels &reaction_wheels() const { return state.reaction_wheels; }
+
+        /* Time at the end of the timestep. */
+        inline timestamp time() const { return state_time; }
+
+        /* Length of the timestep. */
+        inline timestamp timestep() const { return state_timestep; }
+
+    private:
+        const sim_config &state;
+        SensorState      &sensors;
+        const timestamp   state_time;
+        const timestamp   state_timestep;
+};
+
+/**
+ * @class   TelemetrySink
+ *
+ * @details interface for anything that observes every timestep of a simulation on the simulation
+ *          thread, for example to compute run statistics. Sinks are called before the terminal
+ *          and file rate limits are applied, so they must be cheap.
+**/
+class TelemetrySink
+{
+    public:
+        /**
+         * @name    TelemetrySink destructor
+         *
+         * @details virtual as this class is a base class with virtual functions.
+        **/
+        virtual ~TelemetrySink() {}
+
+        /**
+         * @name    on_simulation_state
+         *
+         * @details called at the end of every timestep.
+         *
+         * @param   state view of the simulation state. Only valid for the duration of the call.
+        **/
+        virtual void on_simulation_state(const sim_state_view &state) = 0;
+};
+
+/**
+ * @struct  telemetry_sample
+ *
+ * @details snapshot of the simulation state handed from the simulation thread to the writer
+ *          thread. Plain arrays are used so the sample can be written into the queue without any
+ *          allocation. The reaction wheel values are kept in place beside the queue slot of the
+ *          sample, in storage sized for the wheels of the simulation when it starts.
+ *
+ * @param time                  time of the sample.
+ * @param timestep              length of the timestep that ended at this sample.
+ * @param theta_b               angular position of the satellite body.
+ * @param omega_b               angular velocity of the satellite body.
+ * @param alpha_b               angular acceleration of the satellite body.
+ * @param accelerometer         accelerometer measurement.
+ * @param num_reaction_wheels   number of valid entries in rw_omega and rw_alpha.
+ * @param rw_omega              angular velocity of each reaction wheel.
+ * @param rw_alpha              angular acceleration of each reaction wheel.
+ * @param to_terminal           true if the sample should be printed to the terminal.
+ * @param to_file               true if the sample should be written to the output file.
+**/
+typedef struct
+{
+    timestamp time;
+    timestamp timestep;
+    float     theta_b[3];
+    float     omega_b[3];
+    float     alpha_b[3];
+    float     accelerometer[3];
+    uint32_t  num_reaction_wheels;
+    float    *rw_omega;
+    float    *rw_alpha;
+    bool      to_terminal;
+    bool      to_file;
+} telemetry_sample;
 
 /**
  * @class   Messenger
  *
  * @details This class defines a basic terminal-based user interface. The functions provided allow
  *          for future expandability to graphs, or even a more advanced GUI if desired.
+ *
+ *          While a simulation is running, the simulation state is formatted and written by a
+ *          background writer thread. update_simulation_state() only copies the state into a
+ *          lock-free queue, so the simulation never waits on the terminal or the file system
+ *          unless the queue is full and the backpressure policy is Block. The writer thread also
+ *          builds the decimated summary of the output file, see SummaryWriter.hpp.
 **/
 class Messenger
 {
     public:
+        /**
+         * @name    Messenger constructor
+         *
+         * @details allocates the telemetry queue.
+        **/
+        Messenger();
+
+        /**
+         * @name    Messenger destructor
+         *
+         * @details stops the writer thread if it is still running.
+        **/
+        ~Messenger();
+
         /**
          * @name    send_message
          *
@@ -60,21 +221,41 @@ class Messenger
         **/
         void send_error(std::string msg);
 
+        /**
+         * @name    send_profile_summary
+         *
+         * @details sends the time spent in each profiled zone and the value of each counter to the
+         *          UI. Silenced with the other messages.
+         *
+         * @param profiler profiler of the run.
+        **/
+        void send_profile_summary(const Profiler &profiler);
+
         /**
          * @name    update_simulation_state
          *
          * @details Function used by the simulation to udpate the user on the state of the system
-         *          at each time step. For now this just dumps the text directly to the terminal,
-         *          but it should be improved for better clarity.
+         *          at the end of a time step. The terminal and output file rates are checked first,
+         *          and the state is only read and queued for the writer thread if one of them is due.
+         *
+         * @param state view of the satellite state at the end of the timestep, including angular
+         *              position, velocity, and acceleration.
+        **/
+        void update_simulation_state(const sim_state_view &state);
+
+        /**
+         * @name    next_update_time
          *
-         * @note    For now this does not allow for updating the udpate frequency, but this should
-         *          be added.
+         * @details the simulation only calls update_simulation_state when it is due, see
+         *          RateScheduler.hpp.
          *
-         * @param state state variables of the satellite, including angular position, velocity, and
-         *              acceleration.
-         * @param time  time of the update.
+         * @param   now the current simulation time.
+         *
+         * @returns the earliest time update_simulation_state has anything to do: now if a
+         *          telemetry sink or the shared memory ring observes every timestep, otherwise the next time the terminal
+         *          or the output file is due, or the largest timestamp if both are silenced.
         **/
-        void update_simulation_state(sim_config state, timestamp time, timestamp timestep);
+        timestamp next_update_time(timestamp now) const;
 
         /**
          * @name    prompt_char
@@ -96,6 +277,16 @@ class Messenger
         **/
         void start_new_sim(uint32_t num_reaction_wheels);
 
+        /**
+         * @name    resume_output_at
+         *
+         * @details continues the print rates from a resumed time, so a resumed run prints at the
+         *          same times the original run would have.
+         *
+         * @param   time simulation time the run resumes from.
+        **/
+        void resume_output_at(timestamp time);
+
         /**
          * @name    clean_csv_files
          *
@@ -103,6 +294,55 @@ class Messenger
         **/
         void clean_csv_files();
 
+        /**
+         * @name    silence_messages
+         *
+         * @details silences send_message and send_warning, for runs with no user watching such as
+         *          the runs of a batch. Errors are still printed.
+        **/
+        void silence_messages();
+
+        /**
+         * @name    add_telemetry_sink
+         *
+         * @details registers a sink to be called at every timestep of the next simulation. The
+         *          sink must outlive the simulation. Sinks are removed by reset_defaults.
+         *
+         * @param   sink the sink to register.
+        **/
+        void add_telemetry_sink(TelemetrySink *sink);
+
+        /**
+         * @name    request_stop
+         *
+         * @details asks the simulation to end after the current timestep, as if it had timed out,
+         *          eg from a sink that has seen all it needs. The request is cleared when the next
+         *          simulation starts.
+         *
+         * @param   reason reported in place of the timeout message.
+        **/
+        void request_stop(const std::string &reason);
+
+        /**
+         * @name    stop_requested
+         *
+         * @returns true if request_stop was called since the simulation started.
+        **/
+        inline bool stop_requested() const
+        {
+            return this->stop_is_requested;
+        }
+
+        /**
+         * @name    get_stop_reason
+         *
+         * @returns the reason given to request_stop, empty if no stop was requested.
+        **/
+        inline const std::string &get_stop_reason() const
+        {
+            return this->stop_reason;
+        }
+
         /**
          * @name    silence_sim_prints
          *
@@ -135,6 +375,56 @@ class Messenger
         **/
         void set_terminal_print_rate(uint32_t terminal_rate);
 
+        /**
+         * @name    set_output_format
+         *
+         * @details sets the format of the simulation output file for the next simulation.
+         *
+         * @param   format [OutputFormat] the output file format.
+        **/
+        void set_output_format(OutputFormat format);
+
+        /**
+         * @name    set_backpressure_policy
+         *
+         * @details sets what the next simulation does when the telemetry writer falls behind.
+         *
+         * @param   policy [BackpressurePolicy] block the simulation, or drop and count samples.
+        **/
+        void set_backpressure_policy(BackpressurePolicy policy);
+
+        /**
+         * @name    set_output_path
+         *
+         * @details writes the output file of the next simulations to a fixed path instead of the
+         *          next free default name, eg so runs on several threads do not race for a name.
+         *          An existing file at the path is replaced. reset_defaults goes back to the
+         *          default names.
+         *
+         * @param   path [string] path of the output file including its extension, empty for the
+         *          default names. Missing directories are created.
+        **/
+        void set_output_path(const std::string &path);
+
+        /**
+         * @name    set_shared_memory_output
+         *
+         * @details publishes the state of every timestep of the next simulations into a shared
+         *          memory ring, see SharedTelemetry.hpp. The segment is created when a simulation
+         *          starts, and stays readable after it ends until a simulation starts without it or
+         *          the messenger is destroyed. reset_defaults stops publishing from the next one.
+         *
+         * @param   name [string] name of the shared memory segment, empty to not publish.
+        **/
+        void set_shared_memory_output(const std::string &name);
+
+        /**
+         * @name    close_shared_memory
+         *
+         * @details removes the shared memory segment of the last simulation now, eg before the
+         *          process exits without destroying the messenger.
+        **/
+        void close_shared_memory();
 
         /**
         * @name get_output_file_path_string
@@ -175,11 +465,87 @@ class Messenger
         /**
          * @name    write_output_buffer
          * 
-         * @details saves the file buffer to a new csv file
+         * @details waits for the writer thread to write every queued sample, then saves the file
+         *          buffer to a new csv file, or finishes the binary output file. The decimated
+         *          summary is saved next to it.
         */
         void write_output_buffer();
 
+        /**
+         * @name    format_csv_row
+         *
+         * @details formats a simulation state as one row of the csv output.
+         *
+         * @param   sample  the simulation state.
+         * @param   out     stream the row is appended to.
+        **/
+        static void format_csv_row(const telemetry_sample &sample, std::ostream &out);
+
     private:
+        /* Queue between the simulation and the writer thread. */
+        typedef SpscRingBuffer<telemetry_sample, 1024> telemetry_queue_t;
+
+        /**
+         * @name    start_writer
+         *
+         * @details starts the writer thread for a new simulation.
+        **/
+        void start_writer();
+
+        /**
+         * @name    stop_writer
+         *
+         * @details stops the writer thread once it has written every queued sample. Does nothing
+         *          if the writer is not running.
+        **/
+        void stop_writer();
+
+        /**
+         * @name    writer_loop
+         *
+         * @details body of the writer thread. Writes samples from the queue until stopped.
+        **/
+        void writer_loop();
+
+        /**
+         * @name    publish_shared_frame
+         *
+         * @details copies the state of a timestep into the shared memory ring.
+         *
+         * @param   state view of the satellite state at the end of the timestep.
+        **/
+        void publish_shared_frame(const sim_state_view &state);
+
+        /**
+         * @name    write_sample
+         *
+         * @details writes a sample to the terminal and/or the output file, as flagged in the sample.
+        **/
+        void write_sample(const telemetry_sample &sample);
+
+        /**
+         * @name    next_output_file_path
+         *
+         * @details finds the first unused output file name, creating the output directory if
+         *          necessary.
+         *
+         * @param   extension   extension of the output file.
+         *
+         * @returns the path of the new output file.
+        **/
+        std::string next_output_file_path(const std::string &extension);
+
+        /**
+         * @name    output_column_names
+         *
+         * @details names of every output column, shared by the csv and binary outputs.
+         *
+         * @param   num_reaction_wheels the number of reaction wheels used.
+         *
+         * @returns the column names, starting with the time.
+        **/
+        std::vector<std::string> output_column_names(uint32_t num_reaction_wheels);
+
         /**
          * @name    write_cout_header
          * 
@@ -205,14 +571,40 @@ class Messenger
          *
          * @details appends a simulation state to the csv output buffer.
         **/
-        void append_csv_output(sim_config state, timestamp time, timestamp timestep);
+        void append_csv_output(const telemetry_sample &sample);
+
+        /**
+         * @name    close_summary
+         *
+         * @details saves the decimated summary. A summary that cannot be written is reported,
+         *          as the output file itself is still complete.
+         *
+         * @param   path path of the summary, if it was kept in memory.
+        **/
+        void close_summary(const std::string &path);
+
+        /**
+         * @name    fill_output_row
+         *
+         * @details copies every output column of a sample but the time to output_row, in column
+         *          order.
+        **/
+        void fill_output_row(const telemetry_sample &sample);
+
+        /**
+         * @name    append_binary_output
+         *
+         * @details appends output_row to the binary output file. fill_output_row must be called
+         *          first.
+        **/
+        void append_binary_output(const telemetry_sample &sample);
 
         /**
          * @name    append_cout_output
          * 
          * @details appends a simulation state to the terminal.
         **/
-        void append_cout_output(sim_config state, timestamp time, timestamp timestep);
+        void append_cout_output(const telemetry_sample &sample);
 
     private:
         /* Character used to denote user control of the terminal.**/
@@ -227,12 +619,24 @@ class Messenger
         /* extension of csv files */
         const std::string csv_ext = ".csv";
 
+        /* extension of binary output files */
+        const std::string binary_ext = ".bin";
+
         /* default state of the terminal prints */
         const bool default_silent_sim_prints = false;
 
         /* default state of the csv prints */
         const bool default_silent_csv_prints = false;
 
+        /* default format of the output file */
+        const OutputFormat default_output_format = OutputFormat::CSV;
+
+        /* default backpressure policy of the telemetry queue */
+        const BackpressurePolicy default_backpressure_policy = BackpressurePolicy::Block;
+
+        /* time the writer thread sleeps when the queue is empty */
+        const std::chrono::microseconds writer_idle_period = std::chrono::microseconds(200);
+
         /* default print rate to the csv file in ms */
         const timestamp default_csv_print_rate = timestamp(1,0);
 
@@ -248,6 +652,30 @@ class Messenger
         /* state of the terminal prints */
         bool silent_csv_prints = false;
 
+        /* state of send_message and send_warning */
+        bool silent_messages = false;
+
+        /* sinks called at every timestep */
+        std::vector<TelemetrySink*> telemetry_sinks;
+
+        /* true once a stop of the current simulation is requested */
+        bool stop_is_requested = false;
+
+        /* reason given with the stop request */
+        std::string stop_reason;
+
+        /* fixed path of the output file, empty to use the next free default name */
+        std::string output_path_override;
+
+        /* name of the shared memory segment published to, empty if there is none */
+        std::string shared_memory_name;
+
+        /* publisher of the shared memory ring, nullptr if the last simulation did not publish */
+        std::unique_ptr<SharedTelemetryPublisher> shared_telemetry;
+
+        /* format of the output file */
+        OutputFormat output_format = OutputFormat::CSV;
+
         /* print rate to the csv file in ms */
         timestamp csv_print_rate = timestamp(1,0);
 
@@ -262,6 +690,36 @@ class Messenger
 
         /* Buffer variable for the simulation output data. */
         std::stringstream output_file_buffer;
+
+        /* Writer for the binary output file. */
+        TrajectoryWriter trajectory_writer;
+
+        /* Writer for the decimated summary of the output file. */
+        SummaryWriter summary_writer;
+
+        /* Scratch row passed to the binary output file and the summary, sized at the start of the simulation. */
+        std::vector<float> output_row;
+
+        /* backpressure policy of the telemetry queue */
+        BackpressurePolicy backpressure_policy = BackpressurePolicy::Block;
+
+        /* Queue of samples waiting for the writer thread. */
+        std::unique_ptr<telemetry_queue_t> telemetry_queue;
+
+        /* Reaction wheel values of each queue slot, then of the sample written without the writer thread. */
+        std::vector<float> wheel_storage;
+
+        /* Number of reaction wheels of the current simulation, the size of the wheel values of a slot. */
+        uint32_t num_telemetry_wheels = 0;
+
+        /* Thread that formats and writes the queued samples. */
+        std::thread writer_thread;
+
+        /* Set while the writer thread should keep waiting for samples. */
+        std::atomic<bool> writer_running{false};
+
+        /* Number of samples dropped in the current simulation. */
+        uint64_t dropped_samples = 0;
 };
 
 /**
@@ -0,0 +1,240 @@
+/**
+ * @file    Profiler.hpp
+ *
+ * @details This file describes the hot path profiler. Scoped timers and counters are placed in
+ *          the simulation loop, the Messenger, the devices and the ADCS timer with the
+ *          ADCS_PROFILE_SCOPE and ADCS_PROFILE_COUNT macros. They only do anything if the
+ *          simulator is built with ADCS_PROFILING defined (cmake -DADCS_PROFILING=ON), otherwise
+ *          the macros are empty and the profiler costs nothing.
+ *
+ *          Each thread profiles into its own Profiler, so batch runs on separate threads do not
+ *          share counters. A SimulationRun resets the profiler of its thread when it starts, and
+ *          has the Messenger print a summary when it ends. Every timed scope can also be recorded
+ *          as an event and exported in the Chrome trace format, which can be opened with
+ *          chrome://tracing or https://ui.perfetto.dev.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* @details enum class for the scopes timed by the profiler.
+*/
+enum class ProfileZone : uint8_t {
+    timestep,
+    determine_timestep,
+    messenger_update,
+    controller_cycle,
+    device_poll,
+    num_zones
+};
+
+/**
+* @details enum class for the events counted by the profiler.
+*/
+enum class ProfileCounter : uint8_t {
+    timesteps,
+    shortened_timesteps,
+    controller_cycles,
+    device_polls,
+    device_not_ready,
+    num_counters
+};
+
+/**
+ * @class   Profiler
+ *
+ * @details timing and counts of every zone and counter of one thread.
+**/
+class Profiler
+{
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        /**
+         * @struct  zone_stats
+         *
+         * @details time spent in a zone.
+         *
+         * @param calls number of times the zone was entered.
+         * @param total time spent in the zone, summed over every call.
+         * @param max   longest single call.
+        **/
+        typedef struct
+        {
+            uint64_t                 calls;
+            std::chrono::nanoseconds total;
+            std::chrono::nanoseconds max;
+        } zone_stats;
+
+        /**
+         * @name    thread_instance
+         *
+         * @returns the profiler of the calling thread.
+        **/
+        static Profiler &thread_instance();
+
+        /**
+         * @name    reset
+         *
+         * @details clears every zone, counter and trace event.
+         *
+         * @param   record_trace true to record an event for every timed scope from now on.
+        **/
+        void reset(bool record_trace = false);
+
+        /**
+         * @name    add_zone
+         *
+         * @details adds one call of a zone.
+        **/
+        void add_zone(ProfileZone zone, clock::time_point start, clock::time_point end);
+
+        /**
+         * @name    count
+         *
+         * @details adds to a counter.
+        **/
+        inline void count(ProfileCounter counter, uint64_t amount = 1)
+        {
+            this->counters[static_cast<size_t>(counter)] += amount;
+        }
+
+        /**
+         * @name    get_zone
+         *
+         * @returns the time spent in a zone.
+        **/
+        inline const zone_stats &get_zone(ProfileZone zone) const
+        {
+            return this->zones[static_cast<size_t>(zone)];
+        }
+
+        /**
+         * @name    get_counter
+         *
+         * @returns the value of a counter.
+        **/
+        inline uint64_t get_counter(ProfileCounter counter) const
+        {
+            return this->counters[static_cast<size_t>(counter)];
+        }
+
+        /**
+         * @name    summary
+         *
+         * @returns a table of every zone and counter, with the time since the last reset.
+        **/
+        std::string summary() const;
+
+        /**
+         * @name    write_chrome_trace
+         *
+         * @details writes the recorded events in the Chrome trace event format.
+         *
+         * @param   path path of the json file. Missing directories are created.
+         *
+         * @returns true if the file was written.
+        **/
+        bool write_chrome_trace(const std::string &path) const;
+
+        /**
+         * @name    zone_name
+         *
+         * @returns the name of a zone, as used in the summary and trace.
+        **/
+        static const char *zone_name(ProfileZone zone);
+
+        /**
+         * @name    counter_name
+         *
+         * @returns the name of a counter, as used in the summary.
+        **/
+        static const char *counter_name(ProfileCounter counter);
+
+    private:
+        /**
+         * @struct  trace_event
+         *
+         * @details one timed scope, relative to the last reset.
+        **/
+        typedef struct
+        {
+            ProfileZone zone;
+            uint64_t    start_ns;
+            uint64_t    duration_ns;
+        } trace_event;
+
+        /* Number of zones and counters */
+        static constexpr size_t num_zones    = static_cast<size_t>(ProfileZone::num_zones);
+        static constexpr size_t num_counters = static_cast<size_t>(ProfileCounter::num_counters);
+
+        /* Most events kept in a trace, so a long run cannot use all the memory. Later events are dropped. */
+        static constexpr size_t max_trace_events = 2000000;
+
+        /* Time spent in each zone */
+        std::array<zone_stats, num_zones> zones = {};
+
+        /* Value of each counter */
+        std::array<uint64_t, num_counters> counters = {};
+
+        /* Time of the last reset */
+        clock::time_point epoch = clock::now();
+
+        /* True if events are recorded */
+        bool record_trace = false;
+
+        /* Recorded events, in the order they ended */
+        std::vector<trace_event> events;
+
+        /* Number of events dropped once the trace was full */
+        uint64_t dropped_events = 0;
+};
+
+/**
+ * @class   ScopedProfileZone
+ *
+ * @details adds the time between its construction and destruction to a zone of the profiler of
+ *          the calling thread.
+**/
+class ScopedProfileZone
+{
+    public:
+        explicit ScopedProfileZone(ProfileZone zone) : zone(zone), start(Profiler::clock::now()) {}
+
+        ~ScopedProfileZone()
+        {
+            Profiler::thread_instance().add_zone(this->zone, this->start, Profiler::clock::now());
+        }
+
+        ScopedProfileZone(const ScopedProfileZone&) = delete;
+        ScopedProfileZone &operator=(const ScopedProfileZone&) = delete;
+
+    private:
+        const ProfileZone                 zone;
+        const Profiler::clock::time_point start;
+};
+
+#define ADCS_PROFILE_CONCAT_INNER(a, b) a##b
+#define ADCS_PROFILE_CONCAT(a, b)       ADCS_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ADCS_PROFILING
+/* Times the rest of the enclosing scope as zone */
+#define ADCS_PROFILE_SCOPE(zone)   ScopedProfileZone ADCS_PROFILE_CONCAT(adcs_profile_scope_, __LINE__)(ProfileZone::zone)
+/* Adds one to counter */
+#define ADCS_PROFILE_COUNT(counter) Profiler::thread_instance().count(ProfileCounter::counter)
+#else
+#define ADCS_PROFILE_SCOPE(zone)    ((void) 0)
+#define ADCS_PROFILE_COUNT(counter) ((void) 0)
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file RateScheduler.hpp
+ *
+ * @details header file for the multi-rate scheduler of the simulation loop. The physics runs at
+ *          its own timestep, and every other periodic task of the loop (telemetry, checkpoints)
+ *          is a task of the scheduler with its own rate. After each physics step the simulator
+ *          only checks the earliest due time, so a fine physics timestep does not pay for tasks
+ *          that are not due. The controller sets its own rate, see PointingModeController, and
+ *          the physics lands a step on each of its cycles through the scheduled events.
+ *
+ *          A task runs at the end of the first physics step at or after its due time, and
+ *          returns the time it is next due. A task may be due every step, or never.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "def_interface.hpp"
+
+/**
+ * @class   RateScheduler
+ *
+ * @details runs the periodic tasks of the simulation loop at their own rates.
+**/
+class RateScheduler
+{
+    public:
+        /**
+         * @details body of a task. Called with the current simulation time, returns the time the
+         *          task is next due.
+        **/
+        typedef std::function<timestamp(timestamp now)> task_function;
+
+        /* Due time of a task that never runs. */
+        static constexpr timestamp never = timestamp::from_microseconds(std::numeric_limits<uint64_t>::max());
+
+        /**
+         * @name    add_task
+         *
+         * @details adds a task. Tasks that are due at the same time run in the order they were
+         *          added.
+         *
+         * @param run the body of the task.
+         * @param due the first time the task is due, never by default.
+         *
+         * @returns the id of the task.
+        **/
+        size_t add_task(task_function run, timestamp due = never);
+
+        /**
+         * @name    set_due
+         *
+         * @details changes the next time a task is due, eg when the rate it runs at changes.
+         *
+         * @param task the id of the task.
+         * @param due  the next time the task is due.
+        **/
+        void set_due(size_t task, timestamp due);
+
+        /**
+         * @name    next_due
+         *
+         * @returns the earliest time any task is due.
+        **/
+        inline timestamp next_due() const
+        {
+            return this->earliest;
+        }
+
+        /**
+         * @name    run_due
+         *
+         * @details runs every task that is due at or before now, when any is.
+         *
+         * @param now the current simulation time.
+        **/
+        inline void run_due(timestamp now)
+        {
+            if (this->earliest <= now)
+            {
+                this->run_tasks(now);
+            }
+        }
+
+    private:
+        /**
+         * @struct  task
+         *
+         * @details a task and the time it is next due.
+        **/
+        typedef struct
+        {
+            task_function run;
+            timestamp     due;
+        } task;
+
+        /**
+         * @name    run_tasks
+         *
+         * @details runs every due task, then finds the earliest due time.
+        **/
+        void run_tasks(timestamp now);
+
+        /**
+         * @name    update_earliest
+         *
+         * @details finds the earliest due time of every task.
+        **/
+        void update_earliest();
+
+        /* Every task */
+        std::vector<task> tasks;
+
+        /* Earliest due time of any task */
+        timestamp earliest = never;
+};
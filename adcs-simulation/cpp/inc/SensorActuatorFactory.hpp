@@ -1,22 +1,21 @@
 /**
- * @file    Simulator.cpp
+ * @file    SensorActuatorFactory.hpp
  *
- * @details header file for class to create the sensor and actuator objects
+ * @details header file for class to create the sensor and actuator objects from their
+ *          configuration. The objects are stored by DeviceArena.
  *
  * @authors Lily de Loe, Aidan Sheedy
  *
  * Last Edited
- * 2022-11-07
+ * 2026-10-14
  *
 **/
 
 #pragma once
 
-#include <memory>
-
 #include "sim_interface.hpp"
 #include "Simulator.hpp"
-
+#include "ConfigurationSingleton.hpp"
 
 
 /**
@@ -28,22 +27,29 @@
 class SensorActuatorFactory {
 public:
     /**
-    * @name GetSensor
-    * @param name [string], the name of the sensor
+    * @name CreateGyroscope
+    * @param config the configuration of the gyroscope.
+    * @param sim pointer to the simulator that the sensors/actuators will communicate with.
+    *
+    * @details creates a gyroscope from its configuration.
+   **/
+    static Gyroscope CreateGyroscope(const SensorConfig &config, Simulator* sim);
+
+    /**
+    * @name CreateAccelerometer
+    * @param config the configuration of the accelerometer.
     * @param sim pointer to the simulator that the sensors/actuators will communicate with.
     *
-    * @details getter for a sensor object from singleton class instance. Returns a unique
-    * pointer of the type of sensor matching the configuration
+    * @details creates an accelerometer from its configuration.
    **/
-    static std::shared_ptr<Sensor> GetSensor(const std::string &name, Simulator* sim);
+    static Accelerometer CreateAccelerometer(const SensorConfig &config, Simulator* sim);
 
     /**
-    * @name GetActuator
-    * @param name [string], the name of the actuator
+    * @name CreateReactionWheel
+    * @param config the configuration of the reaction wheel.
     * @param sim pointer to the simulator that the sensors/actuators will communicate with.
     *
-    * @details getter for actuator object from singleton class instance. Returns a unique
-    * pointer of the type of actuator matching the configuration
+    * @details creates a reaction wheel from its configuration.
    **/
-    static std::shared_ptr<Actuator> GetActuator(const std::string &name, Simulator* sim);
+    static Reaction_wheel CreateReactionWheel(const ReactionWheelConfig &config, Simulator* sim);
 };
@@ -0,0 +1,154 @@
+/**
+ * @file SensorNoise.hpp
+ *
+ * @details header file for the sensor noise model. Each noisy channel of a sensor draws from its
+ *          own stream of standard normal samples, scaled by the standard deviation of the
+ *          channel. Samples are generated a block at a time rather than per measurement: the
+ *          uniforms of a whole block are hashed from a counter in one loop, then turned into
+ *          normals with Box-Muller in a second, both straight loops over aligned arrays that the
+ *          compiler vectorizes.
+ *
+ *          The streams are counter based: sample i of a stream only depends on the seed, the
+ *          stream id and i. Runs with the same seed are reproducible on any thread, every run
+ *          of a batch gets its own stream id, and a checkpoint only needs the number of samples
+ *          drawn to continue the stream exactly.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include <Eigen/Dense>
+
+/**
+ * @struct  sensor_noise_positions
+ *
+ * @details number of samples drawn so far from each noise stream of the simulator. Saved in
+ *          checkpoints.
+ *
+ * @param gyroscope_angle   samples of the gyroscope angle noise.
+ * @param gyroscope_rate    samples of the gyroscope rate noise.
+ * @param accelerometer     samples of the accelerometer noise.
+**/
+typedef struct
+{
+    uint64_t gyroscope_angle;
+    uint64_t gyroscope_rate;
+    uint64_t accelerometer;
+} sensor_noise_positions;
+
+/**
+ * @class   NoiseStream
+ *
+ * @details one seeded stream of gaussian noise. Does not allocate, the current block is stored
+ *          in the stream.
+**/
+class NoiseStream
+{
+    public:
+        /* Samples generated at once. A multiple of 6, so Box-Muller pairs and 3D draws never
+           straddle two blocks. */
+        static constexpr uint32_t block_size = 384;
+
+        /**
+         * @name    reset
+         *
+         * @details starts the stream from its first sample.
+         *
+         * @param seed      seed of the run, from the config yaml.
+         * @param stream    id of the stream. Streams of the same seed are independent.
+         * @param std_dev   standard deviation of the noise. 0 disables the stream, which then
+         *                  never draws a sample.
+        **/
+        void reset(uint64_t seed, uint64_t stream, float std_dev);
+
+        /**
+         * @name    enabled
+         *
+         * @returns true if the stream adds noise.
+        **/
+        inline bool enabled() const
+        {
+            return 0 != this->std_dev;
+        }
+
+        /**
+         * @name    add
+         *
+         * @details adds the next three samples of the stream to a vector. Does nothing if the
+         *          stream is disabled.
+         *
+         * @param v the vector to add noise to.
+        **/
+        inline void add(Eigen::Vector3f *v)
+        {
+            if (!this->enabled())
+            {
+                return;
+            }
+
+            const uint64_t block_index = this->position / block_size;
+            if (block_index != this->filled_block)
+            {
+                this->fill_block(block_index);
+            }
+
+            *v += this->std_dev * Eigen::Map<const Eigen::Vector3f>(this->block + (this->position % block_size));
+            this->position += 3;
+        }
+
+        /**
+         * @name    get_position
+         *
+         * @returns the number of samples drawn so far.
+        **/
+        inline uint64_t get_position() const
+        {
+            return this->position;
+        }
+
+        /**
+         * @name    seek
+         *
+         * @details continues the stream from a number of samples drawn, when resuming from a
+         *          checkpoint.
+         *
+         * @param position the number of samples already drawn.
+        **/
+        inline void seek(uint64_t position)
+        {
+            this->position = position;
+        }
+
+    private:
+        /**
+         * @name    fill_block
+         *
+         * @details generates one block of the stream.
+         *
+         * @param block_index index of the block, counted from the start of the stream.
+        **/
+        void fill_block(uint64_t block_index);
+
+        /* Hash key of the stream, from the seed and stream id */
+        uint64_t key = 0;
+
+        /* Standard deviation of the noise, 0 if disabled */
+        float std_dev = 0;
+
+        /* Samples drawn so far */
+        uint64_t position = 0;
+
+        /* Index of the block held in block, or none */
+        uint64_t filled_block = std::numeric_limits<uint64_t>::max();
+
+        /* Standard normal samples of the current block */
+        alignas(32) float block[block_size];
+};
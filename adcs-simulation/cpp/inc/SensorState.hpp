@@ -0,0 +1,152 @@
+/**
+ * @file SensorState.hpp
+ *
+ * @details lazily derived sensor values of the simulation. The values a sensor reads, such as the
+ *          accelerometer measurement, only depend on the satellite state, and sensors are polled
+ *          far less often than the simulation steps. Instead of deriving every sensor at the end
+ *          of each timestep, a timestep only marks the sensors stale, and each sensor is derived
+ *          the first time it is read after a timestep: by its device, by the telemetry, or by a
+ *          checkpoint.
+ *
+ *          The stale flags are one bit per sensor type, so marking them is a single store however
+ *          many sensor types there are. A new sensor type adds a bit, a derive function and an
+ *          accessor, and costs nothing in the integration loop.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <cstdint>
+
+#include "CommonStructs.hpp"
+
+/**
+ * @name    sensor_bit
+ *
+ * @returns the stale flag of a sensor type.
+**/
+constexpr uint32_t sensor_bit(SensorType type)
+{
+    return uint32_t(1) << static_cast<uint32_t>(type);
+}
+
+/**
+ * @class   SensorState
+ *
+ * @details derives the sensor values of a simulator state on demand.
+**/
+class SensorState
+{
+    public:
+        /**
+         * @name    SensorState constructor
+         *
+         * @param state the simulator state the sensors are derived from and stored in. Must
+         *              outlive the sensor state.
+        **/
+        explicit SensorState(sim_config *state) : state(state) {}
+
+        /**
+         * @name    invalidate
+         *
+         * @details marks every sensor stale. Called once the satellite state has changed, at the
+         *          end of each timestep.
+        **/
+        inline void invalidate()
+        {
+            this->stale = all_sensors;
+        }
+
+        /**
+         * @name    reset
+         *
+         * @details marks every sensor up to date, when their values were set directly, eg from
+         *          the initial configuration or a checkpoint.
+        **/
+        inline void reset()
+        {
+            this->stale = 0;
+        }
+
+        /**
+         * @name    accelerometer
+         *
+         * @returns the accelerometer, derived from the satellite state if it is stale.
+        **/
+        inline const sim_accelerometer &accelerometer()
+        {
+            if (0 != (this->stale & sensor_bit(SensorType::Accelerometer)))
+            {
+                derive_accelerometer(this->state);
+                this->stale &= ~sensor_bit(SensorType::Accelerometer);
+            }
+            return this->state->accelerometer;
+        }
+
+        /**
+         * @name    gyroscope
+         *
+         * @returns the gyroscope, derived from the satellite state if it is stale.
+        **/
+        inline const sim_gyroscope &gyroscope()
+        {
+            if (0 != (this->stale & sensor_bit(SensorType::Gyroscope)))
+            {
+                derive_gyroscope(this->state);
+                this->stale &= ~sensor_bit(SensorType::Gyroscope);
+            }
+            return this->state->gyroscope;
+        }
+
+        /**
+         * @name    derive_stale
+         *
+         * @details derives every stale sensor into a copy of the state, leaving the state itself
+         *          as it is. Used to save the state without changing it.
+         *
+         * @param copy a copy of the state.
+        **/
+        inline void derive_stale(sim_config *copy) const
+        {
+            if (0 != (this->stale & sensor_bit(SensorType::Accelerometer)))
+            {
+                derive_accelerometer(copy);
+            }
+            if (0 != (this->stale & sensor_bit(SensorType::Gyroscope)))
+            {
+                derive_gyroscope(copy);
+            }
+        }
+
+    private:
+        /* Every stale flag */
+        static constexpr uint32_t all_sensors = sensor_bit(SensorType::Gyroscope) | sensor_bit(SensorType::Accelerometer);
+
+        /**
+         * @name    derive_accelerometer, derive_gyroscope
+         *
+         * @details compute the values a sensor reads from the satellite state.
+        **/
+        static inline void derive_accelerometer(sim_config *state)
+        {
+            state->accelerometer.measurement = state->satellite.alpha_b.cross(state->accelerometer.position);
+        }
+
+        static inline void derive_gyroscope(sim_config *state)
+        {
+            state->gyroscope.alpha = state->satellite.alpha_b;
+            state->gyroscope.omega = state->satellite.omega_b;
+            state->gyroscope.theta = state->satellite.theta_b;
+        }
+
+        /* The state the sensors are derived from */
+        sim_config *state;
+
+        /* One bit per sensor type whose values are out of date */
+        uint32_t stale = 0;
+};
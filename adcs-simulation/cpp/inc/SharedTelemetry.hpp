@@ -0,0 +1,321 @@
+/**
+ * @file SharedTelemetry.hpp
+ *
+ * @details header file for the shared memory telemetry bridge. The simulation publishes the state
+ *          of every timestep into a POSIX shared memory ring, where any number of other processes,
+ *          eg a visualizer or a hardware in the loop rig, read it with plain loads: no syscalls,
+ *          no serialization, and no locks.
+ *
+ *          Each slot of the ring is a seqlock. The publisher makes the sequence of the slot odd,
+ *          copies the frame in, then makes it even again, and readers retry a copy that saw an odd
+ *          or changed sequence. The publisher never waits for a reader, so a slow reader only
+ *          ever misses frames, and readers never write to the segment, which they map read-only.
+ *
+ *          Segment layout (host byte order; every field is at a fixed offset, see the structs):
+ *              shared_telemetry_header   one cache line
+ *              shared_telemetry_slot     capacity slots, one or more cache lines each
+ *
+ *          Frame n (counting from 0 over the life of the segment) is published into slot
+ *          n % capacity, whose sequence is 2n + 1 while it is written and 2n + 2 once it is
+ *          complete. The header's published count is n + 1 once frame n is complete.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "adcs_exception.hpp"
+
+/* Maximum number of reaction wheels in a shared memory frame. */
+constexpr uint32_t max_shared_reaction_wheels = 16;
+
+/**
+ * @struct  shared_telemetry_frame
+ *
+ * @details the state of the simulation at the end of one timestep. Times are in microseconds,
+ *          everything else in the units of the simulator.
+**/
+typedef struct
+{
+    uint64_t time;
+    uint64_t timestep;
+    float    theta_b[3];
+    float    omega_b[3];
+    float    alpha_b[3];
+    float    accelerometer[3];
+    float    gyroscope_theta[3];
+    float    gyroscope_omega[3];
+    uint32_t num_reaction_wheels;
+    float    rw_omega[max_shared_reaction_wheels];
+    float    rw_alpha[max_shared_reaction_wheels];
+} shared_telemetry_frame;
+
+/**
+ * @struct  shared_telemetry_header
+ *
+ * @details the start of the segment. Only published and run change after the segment is created.
+ *
+ * @param magic       "ADCSSHM" followed by a null byte.
+ * @param version     version of the layout.
+ * @param capacity    number of slots, a power of two.
+ * @param frame_size  sizeof(shared_telemetry_frame), to catch readers built differently.
+ * @param slot_size   sizeof(shared_telemetry_slot).
+ * @param run         incremented when a simulation starts publishing.
+ * @param published   number of complete frames ever published.
+**/
+typedef struct alignas(64)
+{
+    char                  magic[8];
+    uint32_t              version;
+    uint32_t              capacity;
+    uint32_t              frame_size;
+    uint32_t              slot_size;
+    std::atomic<uint64_t> run;
+    std::atomic<uint64_t> published;
+} shared_telemetry_header;
+
+/**
+ * @struct  shared_telemetry_slot
+ *
+ * @details one seqlocked frame of the ring, on its own cache lines.
+**/
+typedef struct alignas(64)
+{
+    std::atomic<uint64_t>  sequence;
+    shared_telemetry_frame frame;
+} shared_telemetry_slot;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "The shared telemetry needs address free 64 bit atomics.");
+
+/**
+ * @class   SharedTelemetryPublisher
+ *
+ * @details creates a shared memory segment and publishes frames into it. Only one thread may
+ *          publish. The segment is removed when the publisher is destroyed, readers that already
+ *          mapped it keep their mapping.
+**/
+class SharedTelemetryPublisher
+{
+    public:
+        /* Magic string at the start of every segment, including the null byte. */
+        static constexpr char magic[8] = "ADCSSHM";
+
+        /* Version of the segment layout. */
+        static constexpr uint32_t format_version = 1;
+
+        /* Number of slots if none is given, about a second of 1 ms timesteps. */
+        static constexpr uint32_t default_capacity = 1024;
+
+        /**
+         * @name    SharedTelemetryPublisher constructor
+         *
+         * @param name     name of the segment, eg "/adcs_telemetry". A leading '/' is added if
+         *                 missing. An existing segment of the same name is replaced.
+         * @param capacity number of slots. Rounded up to a power of two.
+         *
+         * @exception invalid_shared_telemetry the segment could not be created.
+        **/
+        SharedTelemetryPublisher(const std::string &name, uint32_t capacity = default_capacity);
+
+        SharedTelemetryPublisher(const SharedTelemetryPublisher &) = delete;
+        void operator=(const SharedTelemetryPublisher &) = delete;
+        ~SharedTelemetryPublisher();
+
+        /**
+         * @name    begin_run
+         *
+         * @details tells readers a new simulation starts publishing. Frames keep their numbering.
+        **/
+        inline void begin_run()
+        {
+            this->header->run.fetch_add(1, std::memory_order_release);
+        }
+
+        /**
+         * @name    publish
+         *
+         * @details copies a frame into the next slot. Never blocks.
+         *
+         * @param   frame the frame to publish.
+        **/
+        inline void publish(const shared_telemetry_frame &frame)
+        {
+            const uint64_t n = this->next_frame++;
+            shared_telemetry_slot &slot = this->slots[n & (this->capacity - 1)];
+
+            slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(static_cast<void*>(&slot.frame), &frame, sizeof(frame));
+            slot.sequence.store(2 * n + 2, std::memory_order_release);
+
+            this->header->published.store(n + 1, std::memory_order_release);
+        }
+
+        /**
+         * @name    get_name
+         *
+         * @returns the name of the segment.
+        **/
+        inline const std::string &get_name() const
+        {
+            return this->name;
+        }
+
+    private:
+        /* Name of the segment */
+        std::string name;
+
+        /* The mapped segment */
+        void                    *mapping = nullptr;
+        size_t                   mapping_size = 0;
+        shared_telemetry_header *header = nullptr;
+        shared_telemetry_slot   *slots = nullptr;
+        uint32_t                 capacity = 0;
+
+        /* Number of the next frame, only used by the publishing thread */
+        uint64_t next_frame = 0;
+};
+
+/**
+ * @class   SharedTelemetryReader
+ *
+ * @details maps a segment read-only and copies frames out of it. Meant for the processes on the
+ *          other side of the bridge; the simulator itself only publishes.
+**/
+class SharedTelemetryReader
+{
+    public:
+        /**
+         * @name    SharedTelemetryReader constructor
+         *
+         * @param name name of the segment, as given to the publisher.
+         *
+         * @exception invalid_shared_telemetry the segment does not exist or has another layout.
+        **/
+        explicit SharedTelemetryReader(const std::string &name);
+
+        SharedTelemetryReader(const SharedTelemetryReader &) = delete;
+        void operator=(const SharedTelemetryReader &) = delete;
+        ~SharedTelemetryReader();
+
+        /**
+         * @name    published
+         *
+         * @returns the number of complete frames published so far.
+        **/
+        inline uint64_t published() const
+        {
+            return this->header->published.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @name    run
+         *
+         * @returns the number of simulations that started publishing.
+        **/
+        inline uint64_t run() const
+        {
+            return this->header->run.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @name    read
+         *
+         * @details copies frame n out of the ring.
+         *
+         * @param   n     number of the frame.
+         * @param   frame populated with the frame.
+         *
+         * @returns true if the frame was copied, false if it is not published yet or was already
+         *          overwritten, in which case frames up to published() - capacity are gone.
+        **/
+        inline bool read(uint64_t n, shared_telemetry_frame *frame) const
+        {
+            const shared_telemetry_slot &slot = this->slots[n & (this->capacity - 1)];
+
+            /* A publisher that stopped in the middle of a frame must not hang the reader */
+            for (uint32_t attempt = 0; attempt < max_read_attempts; attempt++)
+            {
+                const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+                if (2 * n + 1 == before)
+                {
+                    /* The publisher is writing frame n */
+                    continue;
+                }
+                if (2 * n + 2 != before)
+                {
+                    return false;
+                }
+
+                std::memcpy(frame, static_cast<const void*>(&slot.frame), sizeof(*frame));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (before == slot.sequence.load(std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @name    read_latest
+         *
+         * @param   frame populated with the newest frame.
+         *
+         * @returns true if a frame was copied, false if nothing was published yet.
+        **/
+        inline bool read_latest(shared_telemetry_frame *frame) const
+        {
+            const uint64_t count = this->published();
+            if (0 == count)
+            {
+                return false;
+            }
+
+            /* If the newest frame was overwritten while it was copied, the one before it is complete */
+            return this->read(count - 1, frame) || ((1 < count) && this->read(count - 2, frame));
+        }
+
+        /**
+         * @name    get_capacity
+         *
+         * @returns the number of slots of the ring.
+        **/
+        inline uint32_t get_capacity() const
+        {
+            return this->capacity;
+        }
+
+    private:
+        /* Number of times a frame being written is retried before giving up on it */
+        static constexpr uint32_t max_read_attempts = 1 << 16;
+
+        /* The mapped segment */
+        const void                    *mapping = nullptr;
+        size_t                         mapping_size = 0;
+        const shared_telemetry_header *header = nullptr;
+        const shared_telemetry_slot   *slots = nullptr;
+        uint32_t                       capacity = 0;
+};
+
+/**
+ * @exception invalid_shared_telemetry
+ *
+ * @details exception used to indicate that a shared memory segment could not be created or
+ *          mapped.
+**/
+class invalid_shared_telemetry : public adcs_exception
+{
+    public:
+        invalid_shared_telemetry(const char* msg) : adcs_exception(msg) {}
+};
@@ -0,0 +1,301 @@
+/**
+ * @file    SimulationRun.hpp
+ *
+ * @details This file describes a single simulation run: the Simulator, the sensors and actuators
+ *          given to the control code, and the controller itself, all built from one loaded
+ *          Configuration. It is shared by the interactive UI and the batch runner so that every
+ *          run is set up the same way.
+ *
+ * @authors Aidan Sheedy, Lily de Loe
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "sim_interface.hpp"
+#include "ConfigurationSingleton.hpp"
+#include "Messenger.hpp"
+#include "Simulator.hpp"
+#include "Checkpoint.hpp"
+#include "ExecutionPacer.hpp"
+
+class DeviceArena;
+class PointingModeController;
+class DummyController;
+
+/**
+ * @class   SimulationRun
+ *
+ * @details owns everything needed for one simulation. Only the immutable Configuration may be
+ *          shared between runs, so separate runs with separate Messenger objects can execute on
+ *          separate threads, or be interleaved on one.
+**/
+class SimulationRun
+{
+    public:
+        /**
+         * @name    SimulationRun constructor
+         *
+         * @param config          configuration of the run. The pointing mode controller is run
+         *                        if it has exit conditions, otherwise the dummy controller runs
+         *                        until the timeout.
+         * @param messenger       messenger used for all output of the run.
+        **/
+        SimulationRun(std::shared_ptr<const Configuration> config, Messenger *messenger);
+
+        ~SimulationRun();
+
+        /**
+         * @name    execute
+         *
+         * @details initializes the simulator and runs the controller until the timeout is reached.
+         *          Same as start, advance until the run ends, then finish.
+        **/
+        void execute();
+
+        /**
+         * @name    start
+         *
+         * @details initializes the simulator and sets up the devices and the controller, without
+         *          simulating any time. The controller runs as a task of the simulator, see
+         *          Simulator::run_task, so a thread can start several runs and advance each in
+         *          turn. Interleaved runs share the profiler of their thread.
+        **/
+        void start();
+
+        /**
+         * @name    advance
+         *
+         * @details runs the controller and the simulation of a started run.
+         *
+         * @param until simulation time to pause the run at, if it has not ended by then.
+         *
+         * @returns true if the run is paused at until, false once it has ended.
+        **/
+        bool advance(timestamp until = RateScheduler::never);
+
+        /**
+         * @name    finish
+         *
+         * @details reports how the run ended and releases its controller and devices. The total
+         *          phase time counts from start, including the time other runs on the thread were
+         *          advanced in between.
+        **/
+        void finish();
+
+        /**
+         * @name    set_phase_timing
+         *
+         * @details times the phases of the next execute. Times are added to the timing, so one
+         *          timing may be shared by several runs on the same thread.
+         *
+         * @param timing populated with the time spent in each phase, nullptr to stop timing.
+        **/
+        void set_phase_timing(phase_timing *timing);
+
+        /**
+         * @name    set_trace_path
+         *
+         * @details records every profiled scope of the next execute and writes them as a Chrome
+         *          trace. Only available if the simulator is built with ADCS_PROFILING.
+         *
+         * @param path path of the trace json, empty to not write a trace.
+        **/
+        inline void set_trace_path(const std::string &path) { this->trace_path = path; }
+
+        /**
+         * @name    set_checkpoint_output
+         *
+         * @details saves a checkpoint of the next execute every period of simulation time and when
+         *          the timeout is reached. Each checkpoint replaces the previous one.
+         *
+         * @param path   path of the checkpoint file, empty to not save checkpoints.
+         * @param period simulation time between checkpoints, 0 to only save one at the timeout.
+        **/
+        void set_checkpoint_output(const std::string &path, timestamp period);
+
+        /**
+         * @name    set_resume_checkpoint
+         *
+         * @details continues the next execute from a checkpoint instead of the initial state of
+         *          the configuration. The configuration must have the same devices as the run
+         *          that saved the checkpoint. May be shared by any number of runs.
+         *
+         * @param checkpoint the checkpoint to resume from, nullptr to start from the beginning.
+        **/
+        inline void set_resume_checkpoint(std::shared_ptr<const sim_checkpoint> checkpoint) { this->resume_from = std::move(checkpoint); }
+
+        /**
+         * @name    set_noise_stream
+         *
+         * @details draws the sensor noise of the next execute from its own streams, so runs that
+         *          share the noise seed of their configuration still get independent noise.
+         *
+         * @param stream id of the streams, eg the index of the run in a batch. 0 by default.
+        **/
+        inline void set_noise_stream(uint64_t stream) { this->simulator.set_noise_stream(stream); }
+
+        /**
+         * @name    set_environment
+         *
+         * @details uses an already built or mapped environment table for the next execute, eg one
+         *          table shared by every run of a batch. Without one, a run whose configuration
+         *          has an Environment section loads its own.
+         *
+         * @param table the environment table, nullptr to load it from the configuration.
+        **/
+        inline void set_environment(std::shared_ptr<const EnvironmentTable> table) { this->environment = std::move(table); }
+
+        /**
+         * @name    set_stop_on_convergence
+         *
+         * @details ends the next execute as soon as the satellite meets the hold condition of the
+         *          exit yaml, see ConvergenceMonitor.hpp, instead of at the timeout. On by default,
+         *          and only used if the exit yaml has a RequiredAccuracy.
+         *
+         * @param stop false to run until the timeout.
+        **/
+        inline void set_stop_on_convergence(bool stop) { this->stop_on_convergence = stop; }
+
+        /**
+         * @name    set_execution_mode
+         *
+         * @details sets how the simulated time of the next execute is tied to wall time. Runs go
+         *          as fast as possible unless this is called.
+         *
+         * @param mode             the execution mode.
+         * @param real_time_factor simulated seconds per wall second in the paced mode.
+         * @param tick_path        file or named pipe the ticks are read from in lockstep. Empty if
+         *                         the ticks are given to get_pacer from another thread instead.
+         *
+         * @exception invalid_execution_mode the real time factor is not positive.
+        **/
+        void set_execution_mode(ExecutionMode mode, double real_time_factor = 1, const std::string &tick_path = "");
+
+        /**
+         * @name    get_pacer
+         *
+         * @returns the pacer of the run, nullptr if it runs as fast as possible.
+        **/
+        inline ExecutionPacer *get_pacer() { return this->pacer.get(); }
+
+    private:
+        /**
+         * @name    end_setup
+         *
+         * @details records the end of the setup phase if the run is timed.
+        **/
+        void end_setup();
+
+        /**
+         * @name    start_pacer
+         *
+         * @details starts the clock of the pacer, if the run has one, as the controller starts.
+         *
+         * @exception invalid_execution_mode the tick file cannot be opened.
+        **/
+        void start_pacer();
+
+        /**
+         * @name    stop_pacer
+         *
+         * @details stops the pacer, if the run has one, and reports how well it kept time.
+        **/
+        void stop_pacer();
+
+        /**
+         * @name    save_checkpoint
+         *
+         * @details writes a checkpoint of the current state of the run. Errors are reported
+         *          without stopping the run.
+         *
+         * @param devices    devices of the run, nullptr if the run has none.
+         * @param controller controller of the run, nullptr if it is not the pointing mode controller.
+        **/
+        void save_checkpoint(const device_registry *devices, const PointingModeController *controller);
+
+        /**
+         * @name    setup_environment
+         *
+         * @details gives the simulator the environment table of the run, loading it from the
+         *          configuration if none was set.
+         *
+         * @exception invalid_environment_table the table cannot be loaded or is too short for the run.
+        **/
+        void setup_environment();
+
+        /**
+         * @name    restore_devices
+         *
+         * @details sets the poll time of every device from the checkpoint being resumed.
+         *
+         * @exception invalid_checkpoint the checkpoint has different devices.
+        **/
+        void restore_devices(const device_registry &devices);
+
+        /* Configuration of the run. Shared with any other run of the same files. */
+        std::shared_ptr<const Configuration> config;
+
+        /* Messenger used for all output of the run. */
+        Messenger *messenger;
+
+        /* The simulator. */
+        Simulator simulator;
+
+        /* Time spent in each phase, or nullptr if the run is not timed. */
+        phase_timing *phase_times = nullptr;
+
+        /* Path of the Chrome trace of the run, empty if no trace is written. */
+        std::string trace_path;
+
+        /* Path of the checkpoint file, empty if no checkpoints are saved. */
+        std::string checkpoint_path;
+
+        /* Simulation time between checkpoints, 0 to only save one at the timeout. */
+        timestamp checkpoint_period;
+
+        /* Paces the run, nullptr if it runs as fast as possible. */
+        std::unique_ptr<ExecutionPacer> pacer;
+
+        /* File or named pipe ticks are read from in lockstep, empty if there is none. */
+        std::string tick_path;
+
+        /* Checkpoint the run continues from, nullptr to start from the beginning. */
+        std::shared_ptr<const sim_checkpoint> resume_from;
+
+        /* Environment of the run, nullptr if it has none. May be shared with other runs. */
+        std::shared_ptr<const EnvironmentTable> environment;
+
+        /* End the run once the hold condition of the exit yaml is met. */
+        bool stop_on_convergence = true;
+
+        /* Time over which the controller ramps to the desired attitude. */
+        const timestamp ramp_time = timestamp(0, 30);
+
+        /* Time start was called. */
+        std::chrono::steady_clock::time_point run_start;
+
+        /* Timer of the control code, alive from start to finish like the members below. */
+        std::unique_ptr<ADCS_timer> timer;
+
+        /* Every device of the run, nullptr if it has no exit conditions. */
+        std::unique_ptr<DeviceArena> devices;
+
+        /* Hold condition of the exit yaml, nullptr if the run does not stop on convergence. */
+        std::unique_ptr<ConvergenceMonitor> convergence;
+
+        /* The controller of the run, exactly one of which is set between start and finish. */
+        std::unique_ptr<PointingModeController> pointing_controller;
+        std::unique_ptr<DummyController>        dummy_controller;
+
+        /* One step of the controller, run by the simulator whenever it is due. */
+        std::function<timestamp()> controller_task;
+};
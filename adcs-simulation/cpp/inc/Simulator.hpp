@@ -6,18 +6,61 @@
  * @authors Lily de Loe, Justin Paoli, Aidan Sheedy
  *
  * Last Edited
- * 2022-12-01
+ * 2026-10-14
  *
 **/
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <queue>
+#include <string>
 #include <vector>
 
 #include "def_interface.hpp"
 #include "CommonStructs.hpp"
 #include "Messenger.hpp"
+#include "Integrator.hpp"
+#include "ConfigurationSingleton.hpp"
+#include "ExecutionPacer.hpp"
+#include "ConvergenceMonitor.hpp"
+#include "RateScheduler.hpp"
+#include "SensorNoise.hpp"
+#include "Environment.hpp"
+
+/**
+ * @struct  simulator_state
+ *
+ * @details everything the simulator needs to continue a run from where it stopped. Saved in
+ *          checkpoints.
+ *
+ * @param system_vals       state of the satellite, sensors and reaction wheels.
+ * @param simulation_time   time simulated so far.
+ * @param timestep_length   length of the next timestep.
+ * @param last_step_error   error estimate of the last timestep, for adaptive integrators.
+ * @param scheduled_events  upcoming events, in any order.
+ * @param noise_positions   samples drawn from each sensor noise stream.
+**/
+typedef struct
+{
+    sim_config             system_vals;
+    timestamp              simulation_time;
+    timestamp              timestep_length;
+    float                  last_step_error;
+    std::vector<timestamp> scheduled_events;
+    sensor_noise_positions noise_positions;
+} simulator_state;
+
+/**
+ * @details enum class for how a run ended, or that it has not yet.
+ */
+enum class RunOutcome{
+    Running,
+    TimedOut,
+    Converged,
+    Stopped
+};
 
 /**
  * @class Simulator
@@ -29,28 +72,144 @@ class Simulator {
 public:
     /**
      * @class Simulator
-     * @param configFile [string], the filename of the YAML config file
+     * @param messenger the messenger used for all output of the simulation.
      *
-     * @details constructor for the simulator class. Calls the configuration
-     * singleton to instantiate all of the sensors and actuators present in the
-     * simulation based on the properties of the provided YAML configuration file.
+     * @details constructor for the simulator class. The simulation does not start until
+     * init is called.
     **/
     Simulator(Messenger *messenger);
 
     /**
      * @name init
      *
-     * @details Initializes the simulation with starting values.
+     * @details Initializes the simulation with starting values. The sensors are noiseless.
+     *
+     * @param integrator_type the integrator used for the attitude dynamics. Adaptive integrators
+     *                        size the timestep from their error estimate, starting at min_timestep.
+    **/
+    void init(sim_config initial_values, timestamp timeout, timestamp initial_timestep, bool variableTimestep, timestamp max_timestep, timestamp min_timestep,
+              IntegratorType integrator_type = IntegratorType::Euler);
+
+    /**
+     * @name init
+     *
+     * @details Initializes the simulation with the starting values, timestep, integrator and
+     *          sensor noise of a loaded configuration.
+     *
+     * @param config the configuration of the run.
+    **/
+    void init(const Configuration &config);
+
+    /**
+     * @name get_sim_config
+     *
+     * @param config configuration used to get the simulation initial parameters.
+     *
+     * @returns the initial configuration of the satellite
+    **/
+    static sim_config get_sim_config(const Configuration &config);
+
+    /**
+     * @name get_state
+     *
+     * @returns the state needed to continue the run from the current time.
     **/
-    void init(sim_config initial_values, timestamp timeout, timestamp initial_timestep, bool variableTimestep, timestamp max_timestep, timestamp min_timestep);
+    simulator_state get_state() const;
+
+    /**
+     * @name restore_state
+     *
+     * @details continues a run from a saved state. Must be called after init, which still sets
+     * the integrator and timestep limits. The timeout is counted from the saved time, so the
+     * resumed run simulates for another timeout.
+     *
+     * @param state the saved state.
+     *
+     * @exception invalid_adcs_param the saved state has a different number of reaction wheels.
+    **/
+    void restore_state(const simulator_state &state);
+
+    /**
+     * @name set_checkpoint_handler
+     *
+     * @details calls handler every period of simulation time and once more when the timeout is
+     * reached, between two timesteps. The handler is expected to save a checkpoint.
+     *
+     * @param period  simulation time between each call, 0 to only call it at the timeout.
+     * @param handler called with the simulator between timesteps.
+    **/
+    void set_checkpoint_handler(timestamp period, std::function<void()> handler);
+
+    /**
+     * @name set_phase_timing
+     *
+     * @param timing populated with the time spent integrating and handing off telemetry. The
+     * simulator only reads the clock if this is set, nullptr to stop timing.
+    **/
+    inline void set_phase_timing(phase_timing *timing) { this->phase_times = timing; }
+
+    /**
+     * @name set_pacer
+     *
+     * @param pacer ties the simulated time to the wall clock or an external tick, as set by its
+     * mode. nullptr to run as fast as possible without reading the clock.
+    **/
+    inline void set_pacer(ExecutionPacer *pacer) { this->pacer = pacer; }
+
+    /**
+     * @name set_convergence_monitor
+     *
+     * @param monitor checked after every timestep, the run ends with simulation_converged once
+     * its hold condition is met. nullptr to run until the timeout.
+    **/
+    inline void set_convergence_monitor(ConvergenceMonitor *monitor) { this->convergence = monitor; }
+
+    /**
+     * @name set_noise_stream
+     *
+     * @param stream id of the noise streams of the run, so the runs of a batch that share a
+     * noise seed draw different noise. Streams are reset to their start by init, so this must
+     * be called before it.
+    **/
+    inline void set_noise_stream(uint64_t stream) { this->noise_stream = stream; }
+
+    /**
+     * @name set_environment
+     *
+     * @param table the precomputed orbit, magnetic field and sun of the run, nullptr if the run
+     * has no environment. Must outlive the run.
+    **/
+    inline void set_environment(const EnvironmentTable *table) { this->environment = table; }
+
+    /**
+     * @name get_environment
+     *
+     * @returns the environment at the current simulation time, interpolated from the table.
+     * Only valid if the run has an environment, see has_environment.
+    **/
+    inline environment_sample get_environment() const { return this->environment->sample(this->simulation_time); }
+
+    /**
+     * @name has_environment
+     *
+     * @returns true if the run has an environment table.
+    **/
+    inline bool has_environment() const { return nullptr != this->environment; }
+
+    /**
+     * @name get_timeout
+     *
+     * @returns the simulation time the run ends at.
+    **/
+    inline timestamp get_timeout() const { return this->timeout; }
 
     /**
      * @name update_simulation
-     * @returns [timestamp], the simulation time at the end of calculations
+     * @returns [timestamp], the current simulation time
      *
-     * @details Updates the simulation based on the amount of time the
-     * control code spent running. Used when the control code requests
-     * up to date values for a sensor
+     * @details Used when the control code requests up to date values for a device. The
+     * simulation runs on a virtual clock that only advances when the control code sleeps, so the
+     * state is already up to date and no time is simulated.
     **/
     timestamp update_simulation();
 
@@ -58,57 +217,126 @@ public:
      * @name determine_timestep
      *
      * @details Updates the desired timestep based on an error equation. Restricts the timestep to
-     *          be within the min and max described in the YAML.
+     *          be within the min and max described in the YAML. Adaptive integrators use the error
+     *          estimate of the previous timestep instead.
     **/
     void determine_timestep();
 
     /**
      * @name set_adcs_sleep
-     * @param duration [timestamp], the additional time to simulate
+     * @param duration [timestamp], the time to simulate
      * @returns [timestamp], the simulation time at the end of calculations
      *
-     * @details Updates the simulation based on the amount of time the
-     * control code spent running plus some additional specified time.
-     * Used when the control code is not ready for new sensor data and
-     * intends to sleep until new data can be processed.
+     * @details Advances the simulation by exactly the requested duration. Used when the
+     * control code is not ready for new sensor data and intends to sleep until new data can
+     * be processed. Timesteps are shortened where needed to land on each scheduled event.
+     * Control code that blocks on the timer instead of running as a task, see run_task, is
+     * unwound with simulation_timeout or simulation_converged once the run ends.
     **/
     timestamp set_adcs_sleep(timestamp duration);
 
+    /**
+     * @name run_task
+     * @param task [function], one step of the control code. Returns the time it sleeps for
+     * before its next step, and must not sleep on the timer itself.
+     * @param until [timestamp], simulation time to stop at if the run has not ended by then
+     * @returns [RunOutcome], how the run ended, Running if it stopped at until
+     *
+     * @details Runs the control code as a resumable task: steps it whenever it is due, and
+     * advances the simulation between steps, so the physics never runs nested inside the
+     * control code and the end of the run is a normal return. A task stopped at until picks up
+     * where it left off on the next call, so one thread can interleave many runs.
+     *
+     * A task that returns a sleep of 0 is not stepped again at the same time: it sleeps for the
+     * current timestep length instead, so the simulation advances by at least one timestep
+     * between any two steps of the task.
+    **/
+    RunOutcome run_task(const std::function<timestamp()> &task, timestamp until = RateScheduler::never);
+
+    /**
+     * @name get_outcome
+     *
+     * @returns how the run ended, Running until it does.
+    **/
+    inline RunOutcome get_outcome() const { return this->outcome; }
+
+    /**
+     * @name get_outcome_message
+     *
+     * @returns the report of how the run ended, empty while it is running.
+    **/
+    inline const std::string &get_outcome_message() const { return this->outcome_message; }
+
+    /**
+     * @name schedule_event
+     * @param time [timestamp], the simulation time of the event
+     *
+     * @details Schedules an event, such as a device becoming ready to be polled. The simulation
+     * always lands a timestep exactly on each event it passes, so the control code sees the
+     * state at the moment the event happens. Events that are not in the future are ignored.
+    **/
+    void schedule_event(timestamp time);
+
     /**
      * @name reaction_wheel_update_desired_state
      * 
      * @details udpates the simulation with the new target state of a reaction wheel.
      * 
-     * @param wheel_position location of the reaction wheel in the satellite body.
+     * @param wheel_id the id of the reaction wheel, as assigned when the configuration was loaded.
      * @param new_target the new target state of the reactino wheel.
      * 
      * @returns the time of the simulation upon return.
      * 
-     * 
-     * @note The simulator must figure out which reaction wheel is calling the function by it's 
-     *       position - this may be changed to an ID later.
+     * @exception invalid_adcs_param the id does not belong to a reaction wheel.
     **/
-    timestamp reaction_wheel_update_desired_state(Eigen::Vector3f wheel_position, actuator_state new_target);
+    timestamp reaction_wheel_update_desired_state(uint32_t wheel_id, actuator_state new_target);
 
     /**
      * @name reaction_wheel_get_current_state
      * 
      * @details request by a reaction wheel for an update on its current state.
      * 
-     * @param position location of the reaction wheel in the satellite body.
+     * @param wheel_id the id of the reaction wheel, as assigned when the configuration was loaded.
      * 
      * @returns the current state of the actuator.
      * 
+     * @exception invalid_adcs_param the id does not belong to a reaction wheel.
+    **/
+    actuator_state reaction_wheel_get_current_state(uint32_t wheel_id);
+
+    /**
+     * @name reaction_wheels_update_desired_states
+     * 
+     * @details udpates the simulation with the new target accelerations of every reaction wheel
+     *          at once, for control code that commands all the wheels together.
+     * 
+     * @param accelerations the target acceleration of each reaction wheel, indexed by wheel id.
+     * 
+     * @returns the time of the simulation upon return.
+     * 
+     * @exception invalid_dimensions_error there is not one acceleration per reaction wheel.
+    **/
+    timestamp reaction_wheels_update_desired_states(const Eigen::VectorXf &accelerations);
+
+    /**
+     * @name reaction_wheels_get_current_states
+     * 
+     * @details request for an update on the state of every reaction wheel at once. The simulation
+     *          is updated once, however many wheels there are.
      * 
-     * @note The simulator must figure out which reaction wheel is calling the function by it's 
-     *       position - this may be changed to an ID later.
+     * @param velocities populated with the velocity of each wheel, indexed by wheel id. May be null.
+     * @param accelerations populated with the acceleration of each wheel, indexed by wheel id. May
+     *                      be null.
+     * 
+     * @returns the time of the simulation at the moment the states were read.
     **/
-    actuator_state reaction_wheel_get_current_state(Eigen::Vector3f position);
+    timestamp reaction_wheels_get_current_states(Eigen::VectorXf *velocities, Eigen::VectorXf *accelerations);
 
     /**
      * @name gyroscope_take_measurement
      * 
-     * @details request by a gyroscope for an update on its current state.
+     * @details request by a gyroscope for an update on its current state. The angle and angular
+     * velocity are measured with the noise of the gyroscope, the acceleration without.
      * 
      * @param measurement pointer to a measurement to fill with the current info for the sensor.
      * 
@@ -119,7 +347,8 @@ public:
     /**
      * @name accelerometer_take_measurement
      * 
-     * @details request by a accelerometer for an update on its current state.
+     * @details request by a accelerometer for an update on its current state, with the noise of
+     * the accelerometer.
      * 
      * @param measurement pointer to a measurement to fill with the current info for the sensor.
      * 
@@ -129,31 +358,53 @@ public:
 
 private:
     /**
-     * @name simulate
-     * @param t [timestamp], the amount of time to be simulated
+     * @name check_wheel_id
+     *
+     * @param wheel_id the id of a reaction wheel.
      *
-     * @details Used to perform the main simulation calculations. Iterates
-     * over each timestep up until the specified timestamp t's worth
-     * of time has been simulated.
+     * @returns the column of the reaction wheel in the reaction wheel arrays.
+     *
+     * @exception invalid_adcs_param the id does not belong to a reaction wheel.
     **/
-    void simulate(timestamp t);
+    Eigen::Index check_wheel_id(uint32_t wheel_id) const;
+
+    /**
+     * @name advance_to
+     * @param target [timestamp], the simulation time to advance to
+     *
+     * @returns [bool], false if the run ended before target, see get_outcome
+     *
+     * @details Used to perform the main simulation calculations. Iterates over each timestep
+     * until the simulation time is exactly target, shortening the timesteps that would step
+     * over a scheduled event or the target.
+    **/
+    bool advance_to(timestamp target);
 
     /**
      * @name timestep
      *
-     * @details Used to perform a single timestep of simulation.
+     * @details Used to perform a single timestep of simulation. Adaptive integrators retry the
+     *          timestep with a shorter length until the error estimate is within max_error_in_rad,
+     *          so timestep_length may be reduced by this function.
     **/
     void timestep();
 
     /**
-     * @name determine_time_passed
-     * @returns timestamp
+     * @name rebuild_physics_context
      *
-     * @details Used to determine the time the control code spent running in order
-     * to account for the real-life losses due to processing speed. Does not take
-     * into account the processor the control code is running on.
+     * @details Recomputes the cached rigid body constants (inverse inertia, reaction wheel
+     * momentum axes) from system_vals. Must be called whenever the inertias or axes of rotation
+     * in system_vals change.
     **/
-    timestamp determine_time_passed();
+    void rebuild_physics_context();
+
+    /**
+     * @name schedule_periodic_tasks
+     *
+     * @details sets when the telemetry and the next periodic checkpoint are next due, after the
+     * simulation time, the messenger or the checkpoint period changed.
+    **/
+    void schedule_periodic_tasks();
 
 private:
     /* max error allowed per timestep in position accuracy - the first term is in degrees */
@@ -169,12 +420,11 @@ private:
     timestamp simulation_time;
 
     /**
-     * @property last_called [timestamp]
+     * @property scheduled_events [priority_queue<timestamp>]
      *
-     * @details The timestamp that the simulation was last called at. Used to determine
-     * the amount of time that has passed while the control code was running.
+     * @details Simulation times of the upcoming events, earliest first.
     **/
-    timestamp last_called;
+    std::priority_queue<timestamp, std::vector<timestamp>, std::greater<timestamp>> scheduled_events;
 
     /**
      * @property timestep_length [timestamp]
@@ -205,6 +455,21 @@ private:
     **/
     timestamp min_timestamp;
 
+    /**
+     * @property integrator [Integrator]
+     *
+     * @details integrator used to advance the satellite attitude each timestep.
+    **/
+    std::unique_ptr<Integrator> integrator;
+
+    /**
+     * @property last_step_error [float]
+     *
+     * @details error estimate of the last accepted timestep, in rad. Only used by adaptive
+     * integrators.
+    **/
+    float last_step_error;
+
     /**
      * @property system_vals [sim_config]
      *
@@ -212,6 +477,37 @@ private:
     **/  
     sim_config system_vals;
 
+    /**
+     * @property sensors [SensorState]
+     *
+     * @details The sensor values of system_vals, derived when they are read after a timestep.
+    **/
+    SensorState sensors;
+
+    /**
+     * @property physics [physics_context]
+     *
+     * @details Cached constants derived from system_vals, used by each timestep.
+    **/  
+    physics_context physics;
+
+    /**
+     * @property sum_wheel_momentum [function pointer]
+     *
+     * @details Sums the reaction wheel torque and momentum into the dynamics of a timestep. Chosen
+     * by rebuild_physics_context for the number of reaction wheels: 3 and 4 wheels use fixed size
+     * matrices, any other number uses the dynamically sized ones.
+    **/
+    void (*sum_wheel_momentum)(const physics_context &physics, const sim_reaction_wheels &wheels, rigid_body_dynamics *dynamics) = nullptr;
+
+    /**
+     * @property integrate_wheels [function pointer]
+     *
+     * @details Advances the reaction wheel velocities by one timestep. Chosen with
+     * sum_wheel_momentum.
+    **/
+    void (*integrate_wheels)(sim_reaction_wheels *wheels, float dt) = nullptr;
+
     /**
      * @property messenger [Messenger*]
      *
@@ -219,6 +515,102 @@ private:
     **/  
     Messenger *messenger;
 
+    /**
+     * @property checkpoint_handler [function]
+     *
+     * @details called to save a checkpoint, or empty if no checkpoints are saved.
+    **/
+    std::function<void()> checkpoint_handler;
+
+    /**
+     * @property checkpoint_period [timestamp]
+     *
+     * @details simulation time between each checkpoint, 0 to only save one at the timeout.
+    **/
+    timestamp checkpoint_period;
+
+    /**
+     * @property next_checkpoint [timestamp]
+     *
+     * @details simulation time of the next periodic checkpoint.
+    **/
+    timestamp next_checkpoint;
+
+    /**
+     * @property tasks [RateScheduler]
+     *
+     * @details the tasks that run after a timestep at their own rate: the telemetry at the
+     * terminal and output file rates, and the periodic checkpoints.
+    **/
+    RateScheduler tasks;
+
+    /**
+     * @property telemetry_task, checkpoint_task [size_t]
+     *
+     * @details the ids of the telemetry and checkpoint tasks in tasks.
+    **/
+    size_t telemetry_task;
+    size_t checkpoint_task;
+
+    /**
+     * @property phase_times [phase_timing*]
+     *
+     * @details time spent in each phase, or nullptr if the run is not being timed.
+    **/
+    phase_timing *phase_times = nullptr;
+
+    /**
+     * @property pacer [ExecutionPacer*]
+     *
+     * @details paces the simulation, or nullptr if it runs as fast as possible.
+    **/
+    ExecutionPacer *pacer = nullptr;
+
+    /**
+     * @property convergence [ConvergenceMonitor*]
+     *
+     * @details ends the run once the satellite holds its target, or nullptr if it runs until the timeout.
+    **/
+    ConvergenceMonitor *convergence = nullptr;
+
+    /**
+     * @property outcome, outcome_message [RunOutcome, string]
+     *
+     * @details how the run ended and its report, set once it does.
+    **/
+    RunOutcome  outcome = RunOutcome::Running;
+    std::string outcome_message;
+
+    /**
+     * @property task_wake [timestamp]
+     *
+     * @details simulation time the task of run_task is next due.
+    **/
+    timestamp task_wake;
+
+    /**
+     * @property noise_stream [uint64_t]
+     *
+     * @details id of the noise streams of the run, see set_noise_stream.
+    **/
+    uint64_t noise_stream = 0;
+
+    /**
+     * @property environment [EnvironmentTable*]
+     *
+     * @details the environment of the run, nullptr if it has none. May be shared with other runs.
+    **/
+    const EnvironmentTable *environment = nullptr;
+
+    /**
+     * @property gyroscope_angle_noise, gyroscope_rate_noise, accelerometer_noise [NoiseStream]
+     *
+     * @details noise added to each sensor measurement. Disabled unless the config sets it.
+    **/
+    NoiseStream gyroscope_angle_noise;
+    NoiseStream gyroscope_rate_noise;
+    NoiseStream accelerometer_noise;
+
     /**
      * @property timeout [timestamp]
      * 
@@ -237,3 +629,15 @@ class simulation_timeout : public adcs_exception
     public:
         simulation_timeout(const char* msg) :  adcs_exception(msg) {}
 };
+
+/**
+ * @exception simulation_converged
+ *
+ * @details exception used to indicate that the satellite held its target for the hold time of
+ *          the exit yaml, so the run ended before its timeout.
+**/
+class simulation_converged : public adcs_exception
+{
+    public:
+        simulation_converged(const char* msg) :  adcs_exception(msg) {}
+};
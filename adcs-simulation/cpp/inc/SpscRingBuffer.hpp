@@ -0,0 +1,198 @@
+/**
+ * @file SpscRingBuffer.hpp
+ *
+ * @details bounded lock-free single producer, single consumer ring buffer. Used to hand telemetry
+ *          from the simulation thread to the Messenger writer thread without either side taking a
+ *          lock.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @class   SpscRingBuffer
+ *
+ * @details fixed capacity ring buffer. Exactly one thread may push, with try_push or try_claim,
+ *          and exactly one (other) thread may pop, with try_pop or try_peek. The head and tail
+ *          indices only ever increase, and are kept on separate cache lines so the two threads do
+ *          not contend for them.
+ *
+ * @tparam T        element type. Must be trivially copyable, as elements are copied in and out.
+ * @tparam Capacity number of elements. Must be a power of two.
+**/
+template <typename T, size_t Capacity>
+class SpscRingBuffer
+{
+    static_assert((Capacity > 0) && (0 == (Capacity & (Capacity - 1))), "SpscRingBuffer capacity must be a power of two.");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRingBuffer elements must be trivially copyable.");
+
+    public:
+        /**
+         * @name    try_push
+         *
+         * @details copies an element into the buffer. Producer thread only.
+         *
+         * @param   item the element to add.
+         *
+         * @returns true if the element was added, false if the buffer is full.
+        **/
+        bool try_push(const T &item)
+        {
+            const size_t index = this->try_claim();
+            if (Capacity == index)
+            {
+                return false;
+            }
+
+            this->buffer[index] = item;
+            this->publish();
+            return true;
+        }
+
+        /**
+         * @name    try_pop
+         *
+         * @details copies the oldest element out of the buffer. Consumer thread only.
+         *
+         * @param   item populated with the element removed.
+         *
+         * @returns true if an element was removed, false if the buffer is empty.
+        **/
+        bool try_pop(T *item)
+        {
+            const size_t index = this->try_peek();
+            if (Capacity == index)
+            {
+                return false;
+            }
+
+            *item = this->buffer[index];
+            this->release();
+            return true;
+        }
+
+        /**
+         * @name    try_claim
+         *
+         * @details finds the slot the next element goes in, so the producer can fill it, and any
+         *          storage kept beside the buffer for that slot, in place. Producer thread only.
+         *          The element is added by publish.
+         *
+         * @returns the index of the slot, or capacity() if the buffer is full.
+        **/
+        size_t try_claim()
+        {
+            const size_t head = this->head_index.load(std::memory_order_relaxed);
+            if (Capacity <= (head - this->cached_tail))
+            {
+                this->cached_tail = this->tail_index.load(std::memory_order_acquire);
+                if (Capacity <= (head - this->cached_tail))
+                {
+                    return Capacity;
+                }
+            }
+
+            return head & (Capacity - 1);
+        }
+
+        /**
+         * @name    publish
+         *
+         * @details adds the element of the slot returned by the last try_claim. Producer thread only.
+        **/
+        void publish()
+        {
+            this->head_index.store(this->head_index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @name    try_peek
+         *
+         * @details finds the slot of the oldest element, which stays in place until release.
+         *          Consumer thread only.
+         *
+         * @returns the index of the slot, or capacity() if the buffer is empty.
+        **/
+        size_t try_peek()
+        {
+            const size_t tail = this->tail_index.load(std::memory_order_relaxed);
+            if (tail == this->cached_head)
+            {
+                this->cached_head = this->head_index.load(std::memory_order_acquire);
+                if (tail == this->cached_head)
+                {
+                    return Capacity;
+                }
+            }
+
+            return tail & (Capacity - 1);
+        }
+
+        /**
+         * @name    release
+         *
+         * @details removes the element of the slot returned by the last try_peek, so the producer
+         *          may reuse it. Consumer thread only.
+        **/
+        void release()
+        {
+            this->tail_index.store(this->tail_index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @name    slot
+         *
+         * @returns the element of a slot, only valid between try_claim and publish for the
+         *          producer, or between try_peek and release for the consumer.
+        **/
+        inline T &slot(size_t index) { return this->buffer[index]; }
+
+        /**
+         * @name    empty
+         *
+         * @returns true if the buffer holds no elements. Only a hint while both threads are active.
+        **/
+        bool empty() const
+        {
+            return this->head_index.load(std::memory_order_acquire) == this->tail_index.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @name    capacity
+         *
+         * @returns the number of elements the buffer can hold.
+        **/
+        static constexpr size_t capacity()
+        {
+            return Capacity;
+        }
+
+    private:
+        /* Size of a cache line, used to keep the producer and consumer indices apart. */
+        static constexpr size_t cache_line = 64;
+
+        /* Next index to be written. Written by the producer only. */
+        alignas(cache_line) std::atomic<size_t> head_index{0};
+
+        /* Producer's copy of the tail, refreshed only when the buffer looks full. */
+        size_t cached_tail = 0;
+
+        /* Next index to be read. Written by the consumer only. */
+        alignas(cache_line) std::atomic<size_t> tail_index{0};
+
+        /* Consumer's copy of the head, refreshed only when the buffer looks empty. */
+        size_t cached_head = 0;
+
+        /* Element storage. */
+        alignas(cache_line) std::array<T, Capacity> buffer;
+};
@@ -0,0 +1,180 @@
+/**
+ * @file SummaryWriter.hpp
+ *
+ * @details header file for the decimated summary of the simulation output. While the output file
+ *          is written, every row is also folded into a multi-resolution min/max pyramid: level 0
+ *          buckets hold the minimum and maximum of each column over base_rows rows, and each
+ *          level above holds level_factor buckets of the level below. The plotter draws the
+ *          coarsest level that still resolves the plotted range, so it never has to load the full
+ *          output, and only reads full resolution rows for small zoomed windows.
+ *
+ *          The summary is written next to the output file, as <output file>.summary.
+ *
+ *          File layout (all values little-endian, as written by the host):
+ *              char[8]   magic "ADCSSUM" followed by a null byte
+ *              uint32_t  format version
+ *              uint32_t  number of value columns n, ie every output column but the time
+ *              uint32_t  rows in a level 0 bucket
+ *              uint32_t  buckets of a level in a bucket of the level above
+ *              uint32_t  number of levels
+ *              for each value column:
+ *                  uint16_t  length of the column name
+ *                  char[]    column name, not null terminated
+ *              repeated until the end of the file, in the order the buckets are completed:
+ *                  uint32_t   level of the bucket
+ *                  uint32_t   number of rows in the bucket
+ *                  float64    time of the first and of the last row
+ *                  float32[n] minimum of each column, then float32[n] maximum of each column
+ *
+ *          The last bucket of each level may hold fewer rows than the others.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "adcs_exception.hpp"
+
+/**
+ * @class   SummaryWriter
+ *
+ * @details builds the decimated summary of the output rows as they are written.
+**/
+class SummaryWriter
+{
+    public:
+        /* Magic string at the start of every summary file, including the null byte. */
+        static constexpr char magic[8] = "ADCSSUM";
+
+        /* Version of the file layout. */
+        static constexpr uint32_t format_version = 1;
+
+        /* Rows in a level 0 bucket. */
+        static constexpr uint32_t base_rows = 16;
+
+        /* Buckets of a level in one bucket of the level above. */
+        static constexpr uint32_t level_factor = 4;
+
+        /* Number of levels. The top level buckets hold base_rows * level_factor^(num_levels - 1) rows. */
+        static constexpr uint32_t num_levels = 8;
+
+        /**
+         * @name    open
+         *
+         * @details starts a new summary. Any summary that is open is discarded.
+         *
+         * @param path          path the summary is streamed to. If empty, the summary is kept in
+         *                      memory until close is given a path, for outputs whose file name is
+         *                      only known at the end of the run.
+         * @param column_names  names of every output column. The first column must be the time.
+         *
+         * @exception summary_write_error unable to open the file.
+        **/
+        void open(const std::string &path, const std::vector<std::string> &column_names);
+
+        /**
+         * @name    append_row
+         *
+         * @details folds a row into every level, writing each bucket it completes.
+         *
+         * @param time      value of the time column in seconds.
+         * @param values    values of every other column, in column order.
+        **/
+        void append_row(double time, const float *values);
+
+        /**
+         * @name    close
+         *
+         * @details writes the unfinished bucket of every level and closes the summary. Does
+         *          nothing if no summary is open.
+         *
+         * @param path  path of the summary file if it was kept in memory. Ignored otherwise.
+         *
+         * @exception summary_write_error unable to write the file.
+        **/
+        void close(const std::string &path = "");
+
+        /**
+         * @name    is_open
+         *
+         * @returns true if a summary is being built.
+        **/
+        inline bool is_open() const
+        {
+            return nullptr != this->output;
+        }
+
+        /**
+         * @name    get_summary_path
+         *
+         * @returns the path of the summary of an output file.
+        **/
+        inline static std::string get_summary_path(const std::string &output_path)
+        {
+            return output_path + ".summary";
+        }
+
+    private:
+        /**
+         * @struct  bucket
+         *
+         * @details the rows of one level folded so far.
+        **/
+        typedef struct
+        {
+            uint32_t           rows;
+            double             first_time;
+            double             last_time;
+            std::vector<float> min;
+            std::vector<float> max;
+        } bucket;
+
+        /**
+         * @name    merge
+         *
+         * @details folds bucket from into bucket into.
+        **/
+        void merge(const bucket &from, bucket *into);
+
+        /**
+         * @name    write_bucket
+         *
+         * @details writes a bucket of a level, then empties it.
+        **/
+        void write_bucket(uint32_t level, bucket *b);
+
+        /* File the summary is streamed to, if it has a path. */
+        std::ofstream output_file;
+
+        /* Summary kept in memory until close, if it has no path. */
+        std::stringstream output_buffer;
+
+        /* Where records are written, nullptr if no summary is open. */
+        std::ostream *output = nullptr;
+
+        /* Number of value columns. */
+        uint32_t value_columns = 0;
+
+        /* Unfinished bucket of each level. */
+        std::vector<bucket> levels;
+};
+
+/**
+ * @exception summary_write_error
+ *
+ * @details exception used to indicate that the summary could not be written.
+**/
+class summary_write_error : public adcs_exception
+{
+    public:
+        summary_write_error(const char* msg) : adcs_exception(msg) {}
+};
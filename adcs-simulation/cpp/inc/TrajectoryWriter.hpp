@@ -0,0 +1,154 @@
+/**
+ * @file TrajectoryWriter.hpp
+ *
+ * @details header file for the binary columnar trajectory output. This is an alternative to the
+ *          csv output for long runs: the trajectory is streamed to disk in fixed-size chunks
+ *          instead of being held in memory until the end of the run.
+ *
+ *          File layout (all values little-endian, as written by the host):
+ *              char[8]   magic "ADCSTRJ" followed by a null byte
+ *              uint32_t  format version
+ *              uint32_t  number of columns
+ *              uint32_t  maximum number of rows in a chunk
+ *              for each column:
+ *                  uint8_t   column type, 'd' for float64 or 'f' for float32
+ *                  uint16_t  length of the column name
+ *                  char[]    column name, not null terminated
+ *              repeated until the end of the file:
+ *                  uint32_t  number of rows in the chunk
+ *                  for each column, the rows of the chunk as a contiguous array of its type
+ *
+ *          The first column is always "Time" and is stored as float64 so long runs keep their
+ *          time resolution. Every other column is stored as float32. The column names match the
+ *          csv header, so results_visualization.py can read either format.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "adcs_exception.hpp"
+
+/**
+ * @class   TrajectoryWriter
+ *
+ * @details streams rows of simulation output to a binary columnar file.
+**/
+class TrajectoryWriter
+{
+    public:
+        /* Magic string at the start of every trajectory file, including the null byte. */
+        static constexpr char magic[8] = "ADCSTRJ";
+
+        /* Version of the file layout. */
+        static constexpr uint32_t format_version = 1;
+
+        /* Maximum number of rows buffered before a chunk is written to disk. */
+        static constexpr uint32_t default_chunk_rows = 4096;
+
+        /**
+         * @name    TrajectoryWriter destructor
+         *
+         * @details closes the file if it is still open. Any buffered rows are written first.
+        **/
+        ~TrajectoryWriter();
+
+        /**
+         * @name    open
+         *
+         * @details creates the file and writes the header. Any file that is already open is closed
+         *          first.
+         *
+         * @param path          path of the file to create.
+         * @param column_names  names of every column. The first column must be the time.
+         * @param chunk_rows    maximum number of rows in a chunk.
+         *
+         * @exception trajectory_write_error unable to open the file.
+        **/
+        void open(const std::string &path, const std::vector<std::string> &column_names,
+                  uint32_t chunk_rows = default_chunk_rows);
+
+        /**
+         * @name    append_row
+         *
+         * @details adds a row to the current chunk, and writes the chunk to disk once it is full.
+         *
+         * @param time      value of the time column in seconds.
+         * @param values    values of every other column, in column order. Must hold one fewer
+         *                  value than the number of columns.
+        **/
+        void append_row(double time, const float *values);
+
+        /**
+         * @name    close
+         *
+         * @details writes the current chunk to disk and closes the file. Does nothing if no file
+         *          is open.
+        **/
+        void close();
+
+        /**
+         * @name    is_open
+         *
+         * @returns true if a file is currently being written.
+        **/
+        inline bool is_open() const
+        {
+            return output_file.is_open();
+        }
+
+        /**
+         * @name    num_value_columns
+         *
+         * @returns the number of columns passed to append_row, ie all columns but the time.
+        **/
+        inline uint32_t num_value_columns() const
+        {
+            return value_columns;
+        }
+
+    private:
+        /**
+         * @name    write_chunk
+         *
+         * @details writes all buffered rows to disk as one chunk, then empties the buffer.
+        **/
+        void write_chunk();
+
+        /* File being written. */
+        std::ofstream output_file;
+
+        /* Number of float32 columns. */
+        uint32_t value_columns = 0;
+
+        /* Maximum number of rows in a chunk. */
+        uint32_t chunk_capacity = 0;
+
+        /* Number of rows currently buffered. */
+        uint32_t buffered_rows = 0;
+
+        /* Buffered time column. */
+        std::vector<double> time_column;
+
+        /* Buffered value columns. Column c occupies [c * chunk_capacity, (c+1) * chunk_capacity). */
+        std::vector<float> value_columns_data;
+};
+
+/**
+ * @exception trajectory_write_error
+ *
+ * @details exception used to indicate that the trajectory file could not be written.
+**/
+class trajectory_write_error : public adcs_exception
+{
+    public:
+        trajectory_write_error(const char* msg) : adcs_exception(msg) {}
+};
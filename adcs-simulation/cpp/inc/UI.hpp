@@ -12,7 +12,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-18
+ * 2026-10-14
  *
 **/
 
@@ -26,6 +26,7 @@
 #include "ConfigurationSingleton.hpp"
 #include "Messenger.hpp"
 #include "HelpMessages.hpp"
+#include "Checkpoint.hpp"
 
 /**
  * @class   UI
@@ -94,6 +95,13 @@ class UI
          *              --csv_rate r    - sets the csv print rate to r (ms) (optional)
          *              --print_rate r  - sets the terminal print rate to r (ms) (optional)
          *              --silence_plots - prevents writing to the output csv (optional)
+         *              --binary        - writes the output as a binary trajectory file (optional)
+         *              --drop_telemetry - drops output samples instead of waiting when the writer
+         *                                 falls behind (optional)
+         *              --shared_memory n - publishes every timestep to the shared memory ring n
+         *                                 (optional)
+         *              --run_to_timeout - keeps running after the hold condition of the exit
+         *                                 yaml is met (optional)
          *
          * @param args the user input arguments. Arguments are as follows:
          *              args[0]  command "clean_out"
@@ -104,48 +112,54 @@ class UI
         void parse_run_sim_args(std::vector<std::string> args);
 
         /**
-         * @name create_sensor
+         * @name    run_batch
          *
-         * @param name [string], the name of the sensor to be created
-         * @param sim  [Simulator*], the simulator pointer to be used in the sensor constructor.
-         * @param sensors an unordered map to populate with the sensor.
+         * @details Input command to run every simulation of a sweep yaml in parallel, and write
+         *          a summary of each run. See BatchRunner.hpp for the sweep yaml format.
          *
-         * @details creates a sensor object and populates it in an unordered map to be used by the
-         *          control code.
+         * @param args the user input arguments. Arguments are as follows:
+         *              args[0] command "batch_sim"
+         *              args[1] path to the sweep YAML file
         **/
-        void create_sensor(const std::string &name, Simulator *sim, std::unordered_map<std::string, std::shared_ptr<Sensor>> *sensors);
+        void run_batch(std::vector<std::string> args);
 
         /**
-         * @name create_actuator
+         * @name    run_tuning
          *
-         * @param name [string], the name of the actuator to be created
-         * @param sim  [Simulator*], the simulator pointer to be used in the actuator constructor.
-         * @param actuators an unordered map to populate with the actuator.
+         * @details Input command to search for the controller gains with the lowest cost, running
+         *          the candidates in parallel. See GainTuner.hpp for the tuning yaml format.
          *
-         * @details creates an actuator object and populates it in an unordered map to be used by the
-         *          control code.
+         * @param args the user input arguments. Arguments are as follows:
+         *              args[0] command "tune_gains"
+         *              args[1] path to the tuning YAML file
         **/
-        void create_actuator(const std::string &name, Simulator *sim, std::unordered_map<std::string, std::shared_ptr<Actuator>> *actuators);
+        void run_tuning(std::vector<std::string> args);
 
         /**
-         * @name get_sim_config
+         * @name    build_environment
          *
-         * @param config configuration singleton used to get the simulation initial parameters.
+         * @details Input command to precompute the environment of a config yaml over its timeout
+         *          and write it as a table that runs can memory map, see Environment.hpp.
          *
-         * @returns the initial configuration fo the satellite
+         * @param args the user input arguments. Arguments are as follows:
+         *              args[0] command "build_env"
+         *              args[1] path to the config YAML file, with an Environment section
+         *              args[2] path of the table file to write
         **/
-        sim_config get_sim_config(Configuration &config);
+        void build_environment(std::vector<std::string> args);
 
         /**
          * @name    resume_simulation
          *
-         * @details Input command to resume the previous simulation where it left off. Takes an end
-         *          state YAML as input, and uses the previous "final state" YAML as the new
-         *          initial conditions.
+         * @details Input command to continue a simulation from a checkpoint. With no paths, the
+         *          checkpoint of the previous simulation is resumed with the same yamls.
          *
          * @param args the user input arguments. Arguments are as follows:
          *              args[0] command "resume_sim"
-         *              args[1] path to the "stop conditions" YAML file
+         *              args[1] path to the checkpoint. Optional
+         *              args[2] path to the config yaml, required if a checkpoint is given
+         *              args[3] path to the exit yaml. Optional
+         *              args[n] any of the "start_sim" flags
         **/
         void resume_simulation(std::vector<std::string> args);
 
@@ -185,7 +199,9 @@ class UI
         /**
          * @name    run_no_controller_unit_tests
          *
-         * @details runs all the non-controller unit tests.
+         * @details runs all the non-controller unit tests in parallel. Each run is checked against
+         *          its expected results in memory as it progresses, see ValidationSink.hpp, and
+         *          stops as soon as it passes or fails.
          *
          * @param args the user input arguments. Arguments are as follows:
          *             args[0] command "unit_test"
@@ -195,13 +211,23 @@ class UI
         /**
          * @name    run_controller_unit_tests
          *
-         * @details runs all the controller-based unit tests.
+         * @details runs all the controller-based unit tests in parallel, then plots their outputs.
          *
          * @param args the user input arguments. Arguments are as follows:
          *             args[0] command "unit_test"
         **/
         void run_controller_unit_tests(std::vector<std::string> args);
 
+        /**
+         * @name    run_in_parallel
+         *
+         * @details runs independent jobs, eg simulations with their own Messenger, on up to one
+         *          thread per core, and returns once all of them are done.
+         *
+         * @param jobs the jobs to run. A job must not throw.
+        **/
+        void run_in_parallel(const std::vector<std::function<void()>> &jobs);
+
         /**
          * @name    run_controller_unit_tests
          *
@@ -258,13 +284,11 @@ class UI
         bool terminal_active;
 
         /* Max number of args for the "start_sim" command */
-        const uint8_t max_run_simulation_args = 9;
+        const uint8_t max_run_simulation_args = 21;
 
         /* Min number of args for the "start_sim" command */
         const uint8_t min_run_simulation_args = 2;
 
-        /* Number of expected args for the "resume_sim" command */
-        const uint8_t num_resume_simulation_args = 2;
 
         /* Number of expected args for the "exit" command */
         const uint8_t num_exit_args = 1;
@@ -278,6 +302,15 @@ class UI
         /* Number of expected args for the "perf_test" command */
         const uint8_t num_perf_test_args = 1;
 
+        /* Number of expected args for the "batch_sim" command */
+        const uint8_t num_batch_args = 2;
+
+        /* Number of expected args for the "tune_gains" command */
+        const uint8_t num_tuning_args = 2;
+
+        /* Number of expected args for the "build_env" command */
+        const uint8_t num_build_environment_args = 3;
+
         /* Number of expected args for the "clean_plots" command */
         const uint8_t num_clean_plots_args = 1;
 
@@ -314,36 +347,40 @@ class UI
         /* unit test name prefix for the sim exit yaml (without the number) */
         const std::string controller_test_output_name = "unit_test_out_";
 
-        /* path to the perfomance test config yaml file (without the number or file extension) */
-        const std::string perf_test_config_yaml_path = "unit_tests/performance/perf_test_config_";
-
-        /* path to the perfomance test exit yaml file (without the number or file extension) */
-        const std::string perf_test_exit_yaml_path = "unit_tests/performance/perf_test_exit_";
-
-        /* Description of each performance test */
-        const std::vector<std::string> perf_test_descriptions =
-        {
-            "No initial velocity, requested postion = stationary",
-            "Some initial velocity, requested postion = stationary",
-            "No initial velocity, requested position = moved",
-            "Test 3 + reduced csv writes",
-            "test 3 + no csv writes"
-        };
-
         /* directory of the plotting script */
         const std::string python_plot_file_dir = "./results_visualization.py";
 
         /* directory of the plotting output */
         const std::string plot_dir = "./plots";
 
-        /* number of performance tests to run */
-        const uint8_t num_performance_tests = 5;
+        /* number of untimed runs of each performance test */
+        const uint32_t perf_test_warmup_iterations = 2;
+
+        /* number of timed runs of each performance test */
+        const uint32_t perf_test_iterations = 10;
 
         /* number of unit tests to run without the controller */
         const uint8_t num_no_controller_unit_tests = 6;
 
         /* number of unit tests to run with the controller */
-        const uint8_t num_controller_unit_tests = 3;
+        const uint8_t num_controller_unit_tests = 4;
+
+        /**
+         * number of timesteps of each non-controller unit test compared with its expected results.
+         * The expected results are the analytical acceleration of the initial state, so only the
+         * first timestep is checked; the later ones drift from it with the gyroscopic terms.
+        **/
+        const size_t num_validated_timesteps = 1;
+
+        /**
+         * tolerances of the non-controller unit tests: the 6 significant digits the expected
+         * results are written with, and the float rounding of axes expected to be 0.
+        **/
+        const float unit_test_relative_tolerance = 5e-6;
+        const float unit_test_absolute_tolerance = 1e-7;
+
+        /* csv period of the controller-based unit tests in ms, simulation time */
+        const uint32_t controller_test_csv_rate = 100;
 
         /* default value of the silent plots flag */
         const bool default_silent_plots = false;
@@ -351,8 +388,30 @@ class UI
         /* flag to indicate if results should be plotted. */
         bool silent_plots = false;
 
-        /* Path to the YAML file describing the final state of the previous simulation run. */
-        std::string previous_end_state_yaml;
+        /* true if the next simulation runs until its timeout even once the hold condition is met. */
+        bool run_to_timeout = false;
+
+        /* path of the profile trace of the next simulation, empty if no trace is written. */
+        std::string trace_path = "";
+
+        /* execution mode of the next simulation, paced at real_time_factor or locked to the ticks of tick_path. */
+        ExecutionMode execution_mode = ExecutionMode::AsFastAsPossible;
+        double real_time_factor = 1;
+        std::string tick_path = "";
+
+        /* path of the checkpoint saved by the next simulation, empty to not save one. */
+        std::string checkpoint_path = Checkpoint::get_default_path();
+
+        /* simulation time between the checkpoints of the next simulation, 0 to only save one at the timeout. */
+        timestamp checkpoint_period;
+
+        /* path of the checkpoint the next simulation resumes from, empty to start from the beginning. */
+        std::string resume_checkpoint_path = "";
+
+        /* Checkpoint, config yaml and exit yaml of the previous simulation run, used by "resume_sim". */
+        std::string previous_checkpoint;
+        std::string previous_config_yaml;
+        std::string previous_exit_yaml;
 
         /* Path to the YAML file describing the initial state of the simulation. */
         std::string config_yaml_path = "";
@@ -0,0 +1,117 @@
+/**
+ * @file    ValidationSink.hpp
+ *
+ * @details This file describes the in-memory validation of a run against expected results. The
+ *          sink compares the satellite acceleration of each timestep with the expected one as the
+ *          run progresses, so nothing has to be written to and parsed back from an output file,
+ *          and asks the run to stop as soon as the result is known: at the first sample outside
+ *          the tolerance, or once every expected sample has been checked.
+ *
+ *          Expected results csv format:
+ *              a header line naming the columns, with "alpha x", "alpha y" and "alpha z" columns
+ *              in that order, then one line per timestep from the first one.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "Messenger.hpp"
+
+/**
+ * @struct  validation_failure
+ *
+ * @details the first sample of a run outside the tolerance.
+ *
+ * @param timestep  number of the timestep, counting from 0.
+ * @param time      time at the end of the timestep.
+ * @param expected  expected angular acceleration of the satellite body.
+ * @param actual    simulated angular acceleration of the satellite body.
+**/
+typedef struct
+{
+    uint64_t        timestep;
+    timestamp       time;
+    Eigen::Vector3f expected;
+    Eigen::Vector3f actual;
+} validation_failure;
+
+/**
+ * @class   ValidationSink
+ *
+ * @details telemetry sink that checks a run against the expected acceleration of its first
+ *          timesteps.
+**/
+class ValidationSink : public TelemetrySink
+{
+    public:
+        /**
+         * @name    ValidationSink constructor
+         *
+         * @param expected_alphas    expected angular acceleration of the satellite body at the end
+         *                           of each timestep, from the first one.
+         * @param relative_tolerance a sample matches if every axis is within the relative tolerance
+         *                           of the expected value, plus the absolute tolerance.
+         * @param absolute_tolerance covers axes whose expected value is 0.
+         * @param messenger          messenger of the run, asked to stop it once the result is known.
+        **/
+        ValidationSink(std::vector<Eigen::Vector3f> expected_alphas, float relative_tolerance, float absolute_tolerance, Messenger *messenger) :
+            expected_alphas(std::move(expected_alphas)), relative_tolerance(relative_tolerance),
+            absolute_tolerance(absolute_tolerance), messenger(messenger) {}
+
+        void on_simulation_state(const sim_state_view &state);
+
+        /**
+         * @name    read_expected_alphas
+         *
+         * @details reads the expected accelerations from an expected results csv.
+         *
+         * @param path      path of the csv.
+         * @param max_rows  largest number of timesteps to read.
+         *
+         * @exception invalid_expected_results the file is missing or has no acceleration columns.
+        **/
+        static std::vector<Eigen::Vector3f> read_expected_alphas(const std::string &path, size_t max_rows);
+
+        /* true if every expected sample was checked and matched. */
+        inline bool passed() const { return !has_failed && (checked == expected_alphas.size()); }
+
+        /* true if a sample was outside the tolerance. */
+        inline bool failed() const { return has_failed; }
+
+        /* number of samples checked so far. */
+        inline size_t num_checked() const { return checked; }
+
+        /* the first sample outside the tolerance, only valid if failed(). */
+        inline const validation_failure &get_failure() const { return failure; }
+
+    private:
+        const std::vector<Eigen::Vector3f> expected_alphas;
+        const float                        relative_tolerance;
+        const float                        absolute_tolerance;
+        Messenger                         *messenger;
+
+        size_t             checked    = 0;
+        bool               has_failed = false;
+        validation_failure failure    = {};
+};
+
+/**
+ * @exception invalid_expected_results
+ *
+ * @details exception used to indicate that an expected results csv cannot be read.
+**/
+class invalid_expected_results : public adcs_exception
+{
+    public:
+        invalid_expected_results(const char* msg) : adcs_exception(msg) {}
+};
@@ -6,9 +6,10 @@
  * @authors Aidan Sheedy, Lily de Loe
  *
  * Last Edited
- * 2022-11-08
+ * 2026-10-14
  *
 **/
+#include <chrono>
 #include <vector>
 #include <Eigen/Dense>
 
@@ -36,8 +37,11 @@ class ADCS_device {
          * 
          * @param polling_time the minimum amount of time between polling events for the device
          * @param sim          simulator object used to update and get updates about the device
+         * @param id           index of the device among the devices of its type. Assigned when
+         *                     the configuration is loaded, and used by the simulator to address
+         *                     the device directly.
         **/
-        ADCS_device(timestamp polling_time, Simulator* sim);
+        ADCS_device(timestamp polling_time, Simulator* sim, uint32_t id);
 
         /**
          * @name ADCS_device destructor
@@ -56,6 +60,30 @@ class ADCS_device {
         **/
         virtual timestamp time_until_ready();
 
+        /**
+         * @name    get_id
+         *
+         * @returns the index of the device among the devices of its type.
+        **/
+        uint32_t get_id() const;
+
+        /**
+         * @name    get_last_polled
+         *
+         * @returns the last time the device was polled.
+        **/
+        timestamp get_last_polled() const;
+
+        /**
+         * @name    restore_poll_time
+         *
+         * @details sets the last time the device was polled, when resuming from a checkpoint. No
+         *          event is scheduled, as the checkpoint restores the simulator events itself.
+         *
+         * @param   last_polled the last poll time saved in the checkpoint.
+        **/
+        void restore_poll_time(timestamp last_polled);
+
     private:
         // TODO: This may need an accessor - for now not implementing.
         /* Minimum amount of time that must pass between each time the device is polled.**/
@@ -83,6 +111,9 @@ class ADCS_device {
         **/
         Simulator* sim;
 
+        /* Index of the device among the devices of its type. */
+        uint32_t device_id;
+
 };
 
 /**
@@ -107,8 +138,9 @@ class Sensor : public ADCS_device {
          * @param positions     positions of all sensor locations on the satellite
          * @param num_sensors   number of sensor locations on the satellite
          * @param num_axes      number of axes each sensor location measures
+         * @param id            index of the sensor among the sensors of its type
         **/
-        Sensor(timestamp polling_time, Simulator* sim, std::vector<Eigen::Vector3f> positions, uint32_t num_sensors, uint32_t num_axes);
+        Sensor(timestamp polling_time, Simulator* sim, std::vector<Eigen::Vector3f> positions, uint32_t num_sensors, uint32_t num_axes, uint32_t id);
 
         /**
          * @name Sensor destructor
@@ -172,7 +204,7 @@ class Actuator : public ADCS_device
          *
          * @details constructor for actuators. Initial values for current and target states are 0.
         **/
-        Actuator(timestamp polling_time, Simulator* sim, Eigen::Vector3f position, actuator_state max_vals, actuator_state min_vals, actuator_state initial_vals, Eigen::Vector3f axis_of_rotation);
+        Actuator(timestamp polling_time, Simulator* sim, Eigen::Vector3f position, actuator_state max_vals, actuator_state min_vals, actuator_state initial_vals, Eigen::Vector3f axis_of_rotation, uint32_t id);
 
         /**
          * @name Actuator destructor
@@ -327,6 +359,9 @@ class ADCS_timer
     private:
         /* Pointer to the simulation object, used to get the current time.**/
         Simulator* sim;
+
+        /* Time the control code last woke up, used to time controller cycles when profiling. */
+        std::chrono::steady_clock::time_point last_wake;
 };
 
 /**
@@ -347,8 +382,9 @@ class Accelerometer : public Sensor {
          * @param polling_time  polling time of the sensor
          * @param sim           simulator object used to update and get updates about the device
          * @param positions     positions of all sensor locations on the satellite
+         * @param id            index of the accelerometer among the accelerometers
         */
-        Accelerometer(timestamp polling_time, Simulator* sim, Eigen::Vector3f positions) : Sensor(polling_time, sim, {positions}, 1, 3) {}
+        Accelerometer(timestamp polling_time, Simulator* sim, Eigen::Vector3f positions, uint32_t id) : Sensor(polling_time, sim, {positions}, 1, 3, id) {}
 
         /**
          * @name    take_measurement
@@ -357,8 +393,21 @@ class Accelerometer : public Sensor {
          *          to update.
          *
          * @returns the required measurement if succesful.
+         *
+         * @exception device_not_ready the sensor has not completed its poll delay.
         **/
         measurement take_measurement();
+
+        /**
+         * @name    try_take_measurement
+         *
+         * @details takes a measurement if the sensor is ready, without throwing if it is not.
+         *
+         * @param   result populated with the measurement if the status is ok.
+         *
+         * @returns ok, or not_ready if the sensor has not completed its poll delay.
+        **/
+        device_status try_take_measurement(measurement *result);
 };
 
 /**
@@ -379,8 +428,9 @@ class Gyroscope : public Sensor {
          * @param polling_time  polling time of the sensor
          * @param sim           simulator object used to update and get updates about the device
          * @param positions     positions of all sensor locations on the satellite
+         * @param id            index of the gyroscope among the gyroscopes
         */
-        Gyroscope(timestamp polling_time, Simulator* sim, Eigen::Vector3f positions) : Sensor(polling_time, sim, {positions}, 1, 3) {}
+        Gyroscope(timestamp polling_time, Simulator* sim, Eigen::Vector3f positions, uint32_t id) : Sensor(polling_time, sim, {positions}, 1, 3, id) {}
 
         /**
          * @name    take_measurement
@@ -389,8 +439,21 @@ class Gyroscope : public Sensor {
          *          to update.
          *
          * @returns the required measurement if succesful.
+         *
+         * @exception device_not_ready the sensor has not completed its poll delay.
         **/
         gyro_state take_measurement();
+
+        /**
+         * @name    try_take_measurement
+         *
+         * @details takes a measurement if the sensor is ready, without throwing if it is not.
+         *
+         * @param   result populated with the measurement if the status is ok.
+         *
+         * @returns ok, or not_ready if the sensor has not completed its poll delay.
+        **/
+        device_status try_take_measurement(gyro_state *result);
 };
 
 /**
@@ -406,10 +469,11 @@ class Reaction_wheel : public Actuator
         /**
          * @name Reaction_wheel constructor
          *
-         * @details constructor for the Reaction_wheel. All parameters are passed to the Actuator
-         *          base class.
+         * @details constructor for the Reaction_wheel. All parameters except the inertia are passed
+         *          to the Actuator base class. The id is the column of the wheel in the simulator's
+         *          reaction wheel arrays.
         **/
-        Reaction_wheel(timestamp polling_time, Simulator* sim, Eigen::Vector3f position, actuator_state max_vals, actuator_state min_vals, actuator_state initial_vals, Eigen::Vector3f axis_of_rotation, float inertia_matrix);
+        Reaction_wheel(timestamp polling_time, Simulator* sim, Eigen::Vector3f position, actuator_state max_vals, actuator_state min_vals, actuator_state initial_vals, Eigen::Vector3f axis_of_rotation, float inertia_matrix, uint32_t id);
 
         /**
          * @name    get_inertia_matrix
@@ -430,9 +494,22 @@ class Reaction_wheel : public Actuator
          *
          * @param   target_state the new state the control code would like to be in.
          *
+         * @exception device_not_ready the actuator has not completed its poll delay.
         **/
         void set_target_state(actuator_state target_state);
 
+        /**
+         * @name    try_set_target_state
+         *
+         * @details sets the target state if the actuator is ready, without throwing if it is not.
+         *          An invalid target state is still a fault and throws.
+         *
+         * @param   target_state the new state the control code would like to be in.
+         *
+         * @returns ok, or not_ready if the actuator has not completed its poll delay.
+        **/
+        device_status try_set_target_state(actuator_state target_state);
+
         /**
          * @name    get_current_state
          *
@@ -443,6 +520,39 @@ class Reaction_wheel : public Actuator
         **/
         actuator_state get_current_state();
 
+        /**
+         * @name    get_current_states
+         *
+         * @details reads the state of every reaction wheel in one request to the simulation,
+         *          however many wheels there are.
+         *
+         * @param   wheels          every reaction wheel, indexed by id.
+         * @param   velocities      populated with the velocity of each wheel. May be null.
+         * @param   accelerations   populated with the acceleration of each wheel. May be null.
+         *
+         * @returns the time of the simulation when the states were read.
+        **/
+        static timestamp get_current_states(const std::vector<Reaction_wheel *> &wheels, Eigen::VectorXf *velocities, Eigen::VectorXf *accelerations);
+
+        /**
+         * @name    try_set_target_accelerations
+         *
+         * @details sets the target acceleration of every ready reaction wheel in one request to
+         *          the simulation. A wheel that is not ready keeps its current acceleration. An
+         *          invalid target is still a fault and throws.
+         *
+         * @param   wheels          every reaction wheel, indexed by id.
+         * @param   targets         the target acceleration of each wheel.
+         * @param   accelerations   the current acceleration of each wheel, eg from
+         *                          get_current_states. The entries of the ready wheels are set to
+         *                          their targets, then every entry is passed to the simulation.
+         *
+         * @returns ok, or not_ready if any wheel has not completed its poll delay.
+         *
+         * @exception invalid_dimensions_error there is not one target and acceleration per wheel.
+        **/
+        static device_status try_set_target_accelerations(const std::vector<Reaction_wheel *> &wheels, const Eigen::Ref<const Eigen::VectorXf> &targets, Eigen::VectorXf *accelerations);
+
     private:
 
         /**
@@ -454,4 +564,21 @@ class Reaction_wheel : public Actuator
         float inertia_matrix;
 };
 
+/**
+ * @struct  device_registry
+ *
+ * @details flat, typed view of every device of a run, as given to the control code. Each device
+ *          is at the index of its id. The devices are owned elsewhere and outlive the registry.
+ *
+ * @param gyroscopes        every gyroscope, indexed by id.
+ * @param accelerometers    every accelerometer, indexed by id.
+ * @param reaction_wheels   every reaction wheel, indexed by id.
+**/
+typedef struct
+{
+    std::vector<Gyroscope *>      gyroscopes;
+    std::vector<Accelerometer *>  accelerometers;
+    std::vector<Reaction_wheel *> reaction_wheels;
+} device_registry;
+
 #endif
@@ -6,7 +6,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-18
+ * 2026-10-14
  *
 **/
 
@@ -16,7 +16,7 @@
 #include "sim_interface.hpp"
 #include "Simulator.hpp"
 
-ADCS_device::ADCS_device(timestamp polling_time, Simulator* sim) : min_polling_increment(polling_time)
+ADCS_device::ADCS_device(timestamp polling_time, Simulator* sim, uint32_t id) : min_polling_increment(polling_time)
 {
 	if (nullptr == sim)
 	{
@@ -25,6 +25,7 @@ ADCS_device::ADCS_device(timestamp polling_time, Simulator* sim) : min_polling_i
 
 	this->sim = sim;
 	this->last_polled = 0;
+	this->device_id = id;
 }
 
 timestamp ADCS_device::time_until_ready()
@@ -41,7 +42,25 @@ timestamp ADCS_device::time_until_ready()
 	return ret;
 }
 
+uint32_t ADCS_device::get_id() const
+{
+	return this->device_id;
+}
+
+timestamp ADCS_device::get_last_polled() const
+{
+	return this->last_polled;
+}
+
+void ADCS_device::restore_poll_time(timestamp last_polled)
+{
+	this->last_polled = last_polled;
+}
+
 void ADCS_device::update_poll_time(timestamp new_time)
 {
 	this->last_polled = new_time;
+
+	/* The simulation stops exactly when the device is ready again */
+	this->sim->schedule_event(new_time + this->min_polling_increment);
 }
@@ -14,6 +14,7 @@
 
 #include "sim_interface.hpp"
 #include "Simulator.hpp"
+#include "Profiler.hpp"
 
 ADCS_timer::ADCS_timer(Simulator* sim)
 {
@@ -32,5 +33,19 @@ timestamp ADCS_timer::get_time()
 
 timestamp ADCS_timer::sleep(timestamp duration)
 {
-    return this->sim->set_adcs_sleep(duration);
+#ifdef ADCS_PROFILING
+    /* The control code ran from the end of the last sleep until now */
+    if (std::chrono::steady_clock::time_point() != this->last_wake)
+    {
+        Profiler::thread_instance().add_zone(ProfileZone::controller_cycle, this->last_wake, Profiler::clock::now());
+    }
+    ADCS_PROFILE_COUNT(controller_cycles);
+#endif
+
+    const timestamp wake_time = this->sim->set_adcs_sleep(duration);
+
+#ifdef ADCS_PROFILING
+    this->last_wake = Profiler::clock::now();
+#endif
+    return wake_time;
 }
@@ -6,21 +6,37 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-18
+ * 2026-10-14
  *
 **/
 
 #include <Eigen/Dense>
 
 #include "sim_interface.hpp"
+#include "Profiler.hpp"
 
 measurement Accelerometer::take_measurement()
 {
-    if (this->time_until_ready() > 0)
+    measurement result;
+    if (device_status::ok != this->try_take_measurement(&result))
     {
         throw device_not_ready("Accelerometer not ready.");
     }
 
+    return result;
+}
+
+device_status Accelerometer::try_take_measurement(measurement *result)
+{
+    ADCS_PROFILE_SCOPE(device_poll);
+    ADCS_PROFILE_COUNT(device_polls);
+
+    if (this->time_until_ready() > 0)
+    {
+        ADCS_PROFILE_COUNT(device_not_ready);
+        return device_status::not_ready;
+    }
+
     Eigen::Vector3f measurement;
     measurement = Eigen::Vector3f::Zero();
 
@@ -30,5 +46,6 @@ measurement Accelerometer::take_measurement()
     this->current_vector_value.time_taken = current_time;
     this->current_vector_value.vec = measurement;
 
-    return this->current_vector_value;
+    *result = this->current_vector_value;
+    return device_status::ok;
 }
@@ -6,7 +6,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-10-18
+ * 2026-10-14
  *
 **/
 
@@ -15,7 +15,7 @@
 #include "sim_interface.hpp"
 #include "Simulator.hpp"
 
-Actuator::Actuator(timestamp polling_time, Simulator* sim, Eigen::Vector3f position, actuator_state max_vals, actuator_state min_vals, actuator_state initial_vals, Eigen::Vector3f axis_of_rotation) : ADCS_device(polling_time, sim)
+Actuator::Actuator(timestamp polling_time, Simulator* sim, Eigen::Vector3f position, actuator_state max_vals, actuator_state min_vals, actuator_state initial_vals, Eigen::Vector3f axis_of_rotation, uint32_t id) : ADCS_device(polling_time, sim, id)
 {
     this->max_state_values = max_vals;
     this->min_state_values = min_vals;
@@ -6,27 +6,43 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-18
+ * 2026-10-14
  *
 **/
 
 #include <Eigen/Dense>
 
 #include "sim_interface.hpp"
+#include "Profiler.hpp"
 
 gyro_state Gyroscope::take_measurement()
 {
-    if (this->time_until_ready() > 0)
+    gyro_state measurement;
+    if (device_status::ok != this->try_take_measurement(&measurement))
     {
         throw device_not_ready("Gyroscope not ready.");
     }
 
-    gyro_state measurement = this->sim->gyroscope_take_measurement();
-    this->update_poll_time(measurement.time_taken);
-
     /* commenting out for now, but may not need either of these lines. Leaving as comments until confirmed. */
     // this->current_vector_value.time_taken = current_time;
     // this->current_vector_value.vec = measurement;
 
     return measurement;
 }
+
+device_status Gyroscope::try_take_measurement(gyro_state *result)
+{
+    ADCS_PROFILE_SCOPE(device_poll);
+    ADCS_PROFILE_COUNT(device_polls);
+
+    if (this->time_until_ready() > 0)
+    {
+        ADCS_PROFILE_COUNT(device_not_ready);
+        return device_status::not_ready;
+    }
+
+    *result = this->sim->gyroscope_take_measurement();
+    this->update_poll_time(result->time_taken);
+
+    return device_status::ok;
+}
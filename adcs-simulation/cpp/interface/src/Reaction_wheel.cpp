@@ -6,7 +6,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-18
+ * 2026-10-14
  *
 **/
 
@@ -14,9 +14,10 @@
 #include <iostream>
 
 #include "sim_interface.hpp"
+#include "Profiler.hpp"
 #include "Simulator.hpp"
 
-Reaction_wheel::Reaction_wheel(timestamp polling_time, Simulator* sim, Eigen::Vector3f position, actuator_state max_vals, actuator_state min_vals, actuator_state initial_vals, Eigen::Vector3f axis_of_rotation, float inertia_matrix) : Actuator(polling_time, sim, {position}, max_vals, min_vals, initial_vals, axis_of_rotation)
+Reaction_wheel::Reaction_wheel(timestamp polling_time, Simulator* sim, Eigen::Vector3f position, actuator_state max_vals, actuator_state min_vals, actuator_state initial_vals, Eigen::Vector3f axis_of_rotation, float inertia_matrix, uint32_t id) : Actuator(polling_time, sim, {position}, max_vals, min_vals, initial_vals, axis_of_rotation, id)
 {
 
     if(inertia_matrix == 0)
@@ -36,22 +37,89 @@ float Reaction_wheel::get_inertia_matrix()
 
 void Reaction_wheel::set_target_state(actuator_state new_target)
 {
+    if (device_status::ok != this->try_set_target_state(new_target))
+    {
+        throw device_not_ready("Reaction wheel not ready.");
+    }
+
+    return;
+}
+
+device_status Reaction_wheel::try_set_target_state(actuator_state new_target)
+{
+    ADCS_PROFILE_SCOPE(device_poll);
+    ADCS_PROFILE_COUNT(device_polls);
+
     check_valid_state(new_target);
 
     if (this->time_until_ready() > 0)
     {
-        throw device_not_ready("Reaction wheel not ready.");
+        ADCS_PROFILE_COUNT(device_not_ready);
+        return device_status::not_ready;
     }
     this->target_state = new_target;
-    timestamp cur_time = this->sim->reaction_wheel_update_desired_state(this->position, this->target_state);
+    timestamp cur_time = this->sim->reaction_wheel_update_desired_state(this->device_id, this->target_state);
     this->update_poll_time(cur_time);
 
-    return;
+    return device_status::ok;
 }
 
 actuator_state Reaction_wheel::get_current_state()
 {
-    this->sim->reaction_wheel_get_current_state(this->position);
+    this->sim->reaction_wheel_get_current_state(this->device_id);
     return this->current_state;
 }
 
+
+timestamp Reaction_wheel::get_current_states(const std::vector<Reaction_wheel *> &wheels, Eigen::VectorXf *velocities, Eigen::VectorXf *accelerations)
+{
+    if (wheels.empty())
+    {
+        return 0;
+    }
+
+    return wheels.front()->sim->reaction_wheels_get_current_states(velocities, accelerations);
+}
+
+device_status Reaction_wheel::try_set_target_accelerations(const std::vector<Reaction_wheel *> &wheels, const Eigen::Ref<const Eigen::VectorXf> &targets, Eigen::VectorXf *accelerations)
+{
+    ADCS_PROFILE_SCOPE(device_poll);
+
+    const Eigen::Index num_wheels = wheels.size();
+    if ((targets.size() != num_wheels) || (accelerations->size() != num_wheels))
+    {
+        throw invalid_dimensions_error("Number of reaction wheel targets does not match the number of reaction wheels.");
+    }
+    if (0 == num_wheels)
+    {
+        return device_status::ok;
+    }
+
+    Simulator *sim = wheels.front()->sim;
+    const timestamp cur_time = sim->update_simulation();
+
+    /* Only the ready wheels take their targets, the rest are passed their current acceleration */
+    device_status status = device_status::ok;
+    for (Eigen::Index i = 0; i < num_wheels; i++)
+    {
+        Reaction_wheel *wheel = wheels[i];
+        ADCS_PROFILE_COUNT(device_polls);
+
+        const actuator_state target = {targets(i), wheel->current_state.velocity, wheel->current_state.position, cur_time};
+        wheel->check_valid_state(target);
+
+        if (wheel->time_until_ready() > 0)
+        {
+            ADCS_PROFILE_COUNT(device_not_ready);
+            status = device_status::not_ready;
+            continue;
+        }
+        wheel->target_state = target;
+        wheel->update_poll_time(cur_time);
+        (*accelerations)(i) = targets(i);
+    }
+
+    sim->reaction_wheels_update_desired_states(*accelerations);
+
+    return status;
+}
@@ -6,14 +6,14 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-10-18
+ * 2026-10-14
  *
 **/
 
 #include "sim_interface.hpp"
 #include "Simulator.hpp"
 
-Sensor::Sensor(timestamp polling_time, Simulator* sim, std::vector<Eigen::Vector3f> positions, uint32_t num_sensors, uint32_t num_axes) : ADCS_device(polling_time, sim)
+Sensor::Sensor(timestamp polling_time, Simulator* sim, std::vector<Eigen::Vector3f> positions, uint32_t num_sensors, uint32_t num_axes, uint32_t id) : ADCS_device(polling_time, sim, id)
 {
     if (num_sensors != positions.size())
     {
@@ -3,106 +3,279 @@
 import sys
 import os
 import re
+import struct
+import numpy as np
 import pandas as pd
 import matplotlib.pyplot as plt
 import webbrowser
 
-def plot_results(csv_name, outpath):
-    data = pd.read_csv(csv_name)
-    time = data['Time']
-
-    timestep = data['Timestep']*1000
-
-    plt.figure(1)
-    plt.title("Timestep vs. Time")
-    plt.xlabel("Time [s]")
-    plt.ylabel("Timestep [ms]")
-    plt.plot(time, timestep)
-    plt.savefig(outpath + '/Timestep_vs_Time.png')
-
-    theta_x = data['Satellite theta x']
-    theta_y = data['Satellite theta y']
-    theta_z = data['Satellite theta z']
-
-    plt.figure(2)
-    plt.title("Satellite Position vs. Time")
-    plt.xlabel("Time [s]")
-    plt.ylabel("Satellite Position [rad]")
-    plt.plot(time, theta_x, label="x")
-    plt.plot(time, theta_y, label="y")
-    plt.plot(time, theta_z, label="z")
-    plt.legend()
-    plt.savefig(outpath + '/Satellite_Position_vs_Time.png')
-    webbrowser.open(outpath + '/Satellite_Position_vs_Time.png')
-
-    
-
-    omega_x = data['Satellite Omega x']
-    omega_y = data['Satellite Omega y']
-    omega_z = data['Satellite Omega z']
-
-    plt.figure(3)
-    plt.title("Satellite Velocity vs. Time")
-    plt.xlabel("Time [s]")
-    plt.ylabel("Satellite Velocity [rad/s]")
-    plt.plot(time, omega_x, label="x")
-    plt.plot(time, omega_y, label="y")
-    plt.plot(time, omega_z, label="z")
-    plt.legend()
-    plt.savefig(outpath + '/Satellite_Velocity_vs_Time.png')
-
-    alpha_x = data['Satellite alpha x']
-    alpha_y = data['Satellite alpha y']
-    alpha_z = data['Satellite alpha z']
-
-    plt.figure(4)
-    plt.title("Satellite Acceleration vs. Time")
-    plt.xlabel("Time [s]")
-    plt.ylabel("Satellite Acceleration [rad/s^2]")
-    plt.plot(time, alpha_x, label="x")
-    plt.plot(time, alpha_y, label="y")
-    plt.plot(time, alpha_z, label="z")
-    plt.legend()
-    plt.savefig(outpath + '/Satellite_Acceleration_vs_Time.png')
-
-    accel_x = data['Accelerometer x']
-    accel_y = data['Accelerometer y']
-    accel_z = data['Accelerometer z']
-
-    plt.figure(5)
-    plt.title("Accelerometer Reading vs. Time")
-    plt.xlabel("Time [s]")
-    plt.ylabel("Accelerometer [m/s^2]")
-    plt.plot(time, accel_x, label="x")
-    plt.plot(time, accel_y, label="y")
-    plt.plot(time, accel_z, label="z")
-    plt.legend()
-    plt.savefig(outpath + '/Accelerometer_Reading_vs_Time.png')
-
-    wheel_count = len([col for col in data.columns if "Reaction wheel" in col]) // 2
-    for i in range(wheel_count):
-        plt.figure(6+i)
-        rw_omega = data['Reaction wheel %d Omega' % i]
-        rw_alpha = data['Reaction wheel %d alpha' % i]
+TRAJECTORY_MAGIC = b'ADCSTRJ\x00'
+TRAJECTORY_TYPES = {ord('d'): np.float64, ord('f'): np.float32}
+
+SUMMARY_MAGIC = b'ADCSSUM\x00'
+
+# Most buckets drawn per plot. The finest summary level with no more buckets than this is used.
+MAX_PLOT_BUCKETS = 2000
+
+# Windows with at most this many rows are read from the output file at full resolution.
+MAX_FULL_RESOLUTION_ROWS = 20000
+
+# Rows read at once when a window is read from a csv.
+CSV_READ_ROWS = 100000
+
+def read_trajectory_header(f):
+    """Reads the header of a binary trajectory file, leaving f at the first chunk."""
+    header = f.read(20)
+    if header[:8] != TRAJECTORY_MAGIC:
+        raise ValueError(f.name + ' is not a trajectory file')
+    version, num_columns, _chunk_rows = struct.unpack_from('<III', header, 8)
+    if version != 1:
+        raise ValueError('unsupported trajectory file version %d' % version)
+
+    names = []
+    types = []
+    for _ in range(num_columns):
+        column_type, name_length = struct.unpack('<BH', f.read(3))
+        names.append(f.read(name_length).decode())
+        types.append(np.dtype(TRAJECTORY_TYPES[column_type]))
+    return names, types
+
+def read_binary_trajectory(path, start=None, end=None):
+    """Reads a binary trajectory file written by the simulator (see TrajectoryWriter.hpp).
+
+    If start and end are given, only the chunks holding rows between them are read.
+    """
+    with open(path, 'rb') as f:
+        names, types = read_trajectory_header(f)
+        chunks = [[] for _ in names]
+
+        while True:
+            size = f.read(4)
+            if len(size) < 4:
+                break
+            (rows,) = struct.unpack('<I', size)
+
+            # The time column comes first, so a chunk outside the window is skipped without reading the rest
+            time = np.frombuffer(f.read(rows * types[0].itemsize), dtype=types[0])
+            rest = sum(rows * t.itemsize for t in types[1:])
+            if (start is not None) and (len(time) > 0) and ((time[-1] < start) or (time[0] > end)):
+                f.seek(rest, os.SEEK_CUR)
+                continue
+
+            chunks[0].append(time)
+            for i in range(1, len(names)):
+                chunks[i].append(np.frombuffer(f.read(rows * types[i].itemsize), dtype=types[i]))
+
+    columns = {}
+    for i in range(len(names)):
+        columns[names[i]] = np.concatenate(chunks[i]) if chunks[i] else np.empty(0, dtype=types[i])
+    data = pd.DataFrame(columns)
+    if start is not None:
+        data = data[(data['Time'] >= start) & (data['Time'] <= end)]
+    return data
+
+def read_results(path, start=None, end=None):
+    """Reads the output file at full resolution, only between start and end if they are given."""
+    if path.endswith('.bin'):
+        return read_binary_trajectory(path, start, end)
+    if start is None:
+        return pd.read_csv(path)
+
+    windows = []
+    for chunk in pd.read_csv(path, chunksize=CSV_READ_ROWS):
+        windows.append(chunk[(chunk['Time'] >= start) & (chunk['Time'] <= end)])
+        if chunk['Time'].iloc[-1] > end:
+            break
+    return pd.concat(windows)
+
+def read_summary(path):
+    """Reads a decimated summary (see SummaryWriter.hpp). Returns the column names and the buckets of each level."""
+    with open(path, 'rb') as f:
+        contents = f.read()
+
+    if contents[:8] != SUMMARY_MAGIC:
+        raise ValueError(path + ' is not a summary file')
+    version, num_columns, _base_rows, _level_factor, num_levels = struct.unpack_from('<IIIII', contents, 8)
+    if version != 1:
+        raise ValueError('unsupported summary file version %d' % version)
+
+    offset = 28
+    names = []
+    for _ in range(num_columns):
+        (name_length,) = struct.unpack_from('<H', contents, offset)
+        offset += 2
+        names.append(contents[offset:offset + name_length].decode())
+        offset += name_length
+
+    bucket = np.dtype([('level', '<u4'), ('rows', '<u4'), ('first', '<f8'), ('last', '<f8'),
+                       ('min', '<f4', (num_columns,)), ('max', '<f4', (num_columns,))])
+    count = (len(contents) - offset) // bucket.itemsize
+    buckets = np.frombuffer(contents, dtype=bucket, count=count, offset=offset)
+
+    levels = [buckets[buckets['level'] == level] for level in range(num_levels)]
+    return names, levels
+
+class Results:
+    """Output of a run. Plots are drawn from the summary, with full resolution rows only read for small windows."""
+
+    def __init__(self, path):
+        self.path = path
+        self.summary = None
+        self.data = None
+
+        summary_path = path + '.summary'
+        if os.path.exists(summary_path):
+            names, levels = read_summary(summary_path)
+            if len(levels[0]) > 0:
+                self.summary = ({name: i for i, name in enumerate(names)}, levels)
+
+        if self.summary is None:
+            # Outputs without a summary are read in full, as before
+            self.data = read_results(path)
+
+    def columns(self):
+        if self.summary is None:
+            return list(self.data.columns)
+        return ['Time'] + list(self.summary[0].keys())
 
-        plt.title("Reaction wheel %d vs. Time" % (i+1))
-        plt.xlabel("Time [s]")
-        plt.plot(time, rw_omega, label="omega")
-        plt.plot(time, rw_alpha, label="alpha")
-        plt.legend()
-        plt.savefig(outpath + '/Reaction wheel %d alpha.png' %(i+1))
+    def time_range(self):
+        if self.summary is None:
+            return self.data['Time'].iloc[0], self.data['Time'].iloc[-1]
+        top = self.summary[1][-1]
+        return top['first'][0], top['last'][-1]
 
+    def window(self, start, end):
+        """Returns ('rows', dataframe) at full resolution, or ('buckets', buckets) of the best summary level."""
+        if self.summary is None:
+            data = self.data[(self.data['Time'] >= start) & (self.data['Time'] <= end)]
+            return 'rows', data
+
+        levels = self.summary[1]
+        in_window = lambda b: b[(b['last'] >= start) & (b['first'] <= end)]
+        if in_window(levels[0])['rows'].sum() <= MAX_FULL_RESOLUTION_ROWS:
+            return 'rows', read_results(self.path, start, end)
+
+        for level in levels:
+            buckets = in_window(level)
+            if len(buckets) <= MAX_PLOT_BUCKETS:
+                return 'buckets', buckets
+        return 'buckets', in_window(levels[-1])
+
+class DecimatedPlot:
+    """A figure of some output columns, redrawn for the visible time range when zoomed."""
+
+    def __init__(self, figure_num, results, title, ylabel, columns, labels, scale=1.0):
+        self.results = results
+        self.columns = columns
+        self.labels = labels
+        self.scale = scale
+
+        self.figure = plt.figure(figure_num)
+        self.axes = self.figure.gca()
+        self.axes.set_title(title)
+        self.axes.set_xlabel("Time [s]")
+        self.axes.set_ylabel(ylabel)
+        self.artists = []
+        self.drawn_range = None
+
+        start, end = results.time_range()
+        self.draw(start, end)
+        self.axes.set_xlim(start, end)
+        self.axes.callbacks.connect('xlim_changed', self.on_zoom)
+
+    def draw(self, start, end):
+        for artist in self.artists:
+            artist.remove()
+        self.artists = []
+        self.drawn_range = (start, end)
+
+        kind, window = self.results.window(start, end)
+        for column, label in zip(self.columns, self.labels):
+            if kind == 'rows':
+                self.artists += self.axes.plot(window['Time'], window[column] * self.scale, label=label)
+                continue
+
+            # Each bucket spans its first to last time, so the band is the exact envelope of the rows it holds
+            i = self.results.summary[0][column]
+            time = np.column_stack([window['first'], window['last']]).ravel()
+            low = np.repeat(window['min'][:, i], 2) * self.scale
+            high = np.repeat(window['max'][:, i], 2) * self.scale
+            line, = self.axes.plot(time, (low + high) / 2, label=label, linewidth=0.8)
+            self.artists.append(line)
+            self.artists.append(self.axes.fill_between(time, low, high, color=line.get_color(), alpha=0.3, linewidth=0))
+
+        if len(self.labels) > 1:
+            self.axes.legend()
+
+    def on_zoom(self, axes):
+        start, end = axes.get_xlim()
+        if self.drawn_range != (start, end):
+            self.draw(start, end)
+            self.figure.canvas.draw_idle()
+
+    def save(self, path):
+        self.figure.savefig(path)
+
+def plot_results(csv_name, outpath, window=None, interactive=False):
+    results = Results(csv_name)
+    suffix = '' if window is None else '_%g-%gs' % window
+    plots = []
+
+    def add(name, *args, **kwargs):
+        plot = DecimatedPlot(len(plots) + 1, results, *args, **kwargs)
+        if window is not None:
+            plot.axes.set_xlim(*window)
+        plot.save(outpath + '/' + name + suffix + '.png')
+        plots.append(plot)
+
+    add('Timestep_vs_Time', "Timestep vs. Time", "Timestep [ms]", ['Timestep'], ['timestep'], scale=1000)
+
+    add('Satellite_Position_vs_Time', "Satellite Position vs. Time", "Satellite Position [rad]",
+        ['Satellite theta x', 'Satellite theta y', 'Satellite theta z'], ['x', 'y', 'z'])
+    webbrowser.open(outpath + '/Satellite_Position_vs_Time' + suffix + '.png')
+
+    add('Satellite_Velocity_vs_Time', "Satellite Velocity vs. Time", "Satellite Velocity [rad/s]",
+        ['Satellite Omega x', 'Satellite Omega y', 'Satellite Omega z'], ['x', 'y', 'z'])
+
+    add('Satellite_Acceleration_vs_Time', "Satellite Acceleration vs. Time", "Satellite Acceleration [rad/s^2]",
+        ['Satellite alpha x', 'Satellite alpha y', 'Satellite alpha z'], ['x', 'y', 'z'])
+
+    add('Accelerometer_Reading_vs_Time', "Accelerometer Reading vs. Time", "Accelerometer [m/s^2]",
+        ['Accelerometer x', 'Accelerometer y', 'Accelerometer z'], ['x', 'y', 'z'])
+
+    wheel_count = len([col for col in results.columns() if "Reaction wheel" in col]) // 2
+    for i in range(wheel_count):
+        add('Reaction wheel %d alpha' % (i+1), "Reaction wheel %d vs. Time" % (i+1), "",
+            ['Reaction wheel %d Omega' % i, 'Reaction wheel %d alpha' % i], ['omega', 'alpha'])
+
+    if interactive:
+        plt.show()
 
 def main():
+    # results_visualization.py --to_csv <file.bin> converts a binary trajectory instead of plotting it
+    if (len(sys.argv) == 3 and sys.argv[1] == '--to_csv'):
+        filepath = sys.argv[2]
+        read_binary_trajectory(filepath).to_csv(os.path.splitext(filepath)[0] + '.csv', index=False)
+        return
+
+    # results_visualization.py <file> [--window <start_s> <end_s>] [--interactive]
+    #   --window        plots only the window, at full resolution if it is small enough
+    #   --interactive   shows the plots, redrawing them at the resolution of the visible range when zoomed
     filepath = sys.argv[1]
+    window = None
+    interactive = '--interactive' in sys.argv
+    if '--window' in sys.argv:
+        i = sys.argv.index('--window')
+        window = (float(sys.argv[i + 1]), float(sys.argv[i + 2]))
+
     if (not os.path.exists('plots')):
         os.mkdir('plots')
-    filename = re.search('output/(.*).csv', filepath)
+    filename = re.search(r'output/(.*)\.(csv|bin)', filepath)
     outpath = 'plots/' + filename.group(1)
     if (not os.path.exists(outpath)):
         os.mkdir(outpath)
 
-    plot_results(filepath, outpath)
+    plot_results(filepath, outpath, window, interactive)
 
 if __name__ == "__main__":
-    main()
\ No newline at end of file
+    main()
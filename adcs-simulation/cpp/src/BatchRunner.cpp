@@ -0,0 +1,575 @@
+/**
+ * @file    BatchRunner.cpp
+ *
+ * @details This file implements the BatchRunner class as defined in BatchRunner.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+#include "BatchRunner.hpp"
+#include "ConfigurationSingleton.hpp"
+#include "SimulationRun.hpp"
+
+namespace
+{
+    /**
+     * @name    combine_leaves
+     *
+     * @details builds a node with the shape of a, where each scalar is f(a, b). b is either a
+     *          scalar used for every element, or has the same shape as a.
+    **/
+    YAML::Node combine_leaves(const YAML::Node &a, const YAML::Node &b, const std::function<float(float, float)> &f)
+    {
+        if (a.IsSequence())
+        {
+            YAML::Node result(YAML::NodeType::Sequence);
+            for (size_t i = 0; i < a.size(); i++)
+            {
+                result.push_back(combine_leaves(a[i], b.IsSequence() ? b[i] : b, f));
+            }
+            return result;
+        }
+
+        return YAML::Node(f(a.as<float>(), b.as<float>()));
+    }
+
+    /**
+     * @name    flatten_leaves
+     *
+     * @details appends every scalar of a node to values, and a matching column name to names if
+     *          names is not null.
+    **/
+    void flatten_leaves(const YAML::Node &node, const std::string &name, std::vector<float> *values, std::vector<std::string> *names)
+    {
+        if (node.IsSequence())
+        {
+            for (size_t i = 0; i < node.size(); i++)
+            {
+                flatten_leaves(node[i], name + "[" + std::to_string(i) + "]", values, names);
+            }
+            return;
+        }
+
+        values->push_back(node.as<float>());
+        if (nullptr != names)
+        {
+            names->push_back(name);
+        }
+    }
+
+    /**
+     * @name    split_path
+     *
+     * @returns the keys of a dot separated path.
+    **/
+    std::vector<std::string> split_path(const std::string &path)
+    {
+        std::vector<std::string> keys;
+        std::stringstream ss(path);
+        std::string key;
+
+        while (std::getline(ss, key, '.'))
+        {
+            keys.push_back(key);
+        }
+        return keys;
+    }
+
+    /**
+     * @name    load_sweep_yaml
+     *
+     * @returns the parsed sweep yaml.
+     *
+     * @exception invalid_batch_spec the file is missing or is not yaml.
+    **/
+    YAML::Node load_sweep_yaml(const std::string &sweep_yaml_path)
+    {
+        try
+        {
+            return YAML::LoadFile(sweep_yaml_path);
+        }
+        catch (YAML::Exception &e)
+        {
+            throw invalid_batch_spec(std::string("Invalid sweep yaml " + sweep_yaml_path + ": " + e.what()).c_str());
+        }
+    }
+
+    /**
+     * @name    get_max_wheel_speeds
+     *
+     * @returns the largest angular velocity of each reaction wheel of a configuration, by id.
+    **/
+    Eigen::VectorXf get_max_wheel_speeds(const Configuration &config)
+    {
+        std::vector<std::pair<uint32_t, float>> wheels;
+        for (const auto &actuator : config.GetActuatorConfigs())
+        {
+            if (ActuatorType::ReactionWheel == actuator.second->type)
+            {
+                const ReactionWheelConfig *wheel = dynamic_cast<const ReactionWheelConfig*>(actuator.second.get());
+                wheels.push_back({wheel->id, wheel->maxAngVel});
+            }
+        }
+        std::sort(wheels.begin(), wheels.end());
+
+        Eigen::VectorXf speeds(wheels.size());
+        for (size_t i = 0; i < wheels.size(); i++)
+        {
+            speeds(i) = wheels.at(i).second;
+        }
+        return speeds;
+    }
+}
+
+void RunSummarySink::on_simulation_state(const sim_state_view &state)
+{
+    const Eigen::Vector3f offset = this->desired_position - state.satellite().theta_b;
+    const float error = offset.cwiseAbs().maxCoeff();
+
+    /* An axis overshoots once its offset changes sign from the side it started on */
+    if (!this->started)
+    {
+        this->started      = true;
+        this->initial_side = offset.array().sign().matrix();
+    }
+    this->max_overshoot = std::max(this->max_overshoot, -offset.cwiseProduct(this->initial_side).maxCoeff());
+
+    if (this->settle_tolerance < error)
+    {
+        this->out_of_tolerance = true;
+    }
+    else if (this->out_of_tolerance)
+    {
+        this->out_of_tolerance = false;
+        this->settled_since    = state.time();
+    }
+
+    const sim_reaction_wheels &wheels = state.reaction_wheels();
+    if (0 < wheels.omega.size())
+    {
+        this->peak_speed = std::max(this->peak_speed, wheels.omega.cwiseAbs().maxCoeff());
+        if (wheels.omega.size() == this->max_wheel_speeds.size())
+        {
+            this->peak_saturation = std::max(this->peak_saturation, wheels.omega.cwiseAbs().cwiseQuotient(this->max_wheel_speeds).maxCoeff());
+        }
+    }
+
+    this->last_error = error;
+    this->last_time  = state.time();
+}
+
+BatchRunner::BatchRunner(const std::string &sweep_yaml_path, Messenger *messenger) :
+    BatchRunner(load_sweep_yaml(sweep_yaml_path), messenger)
+{
+}
+
+BatchRunner::BatchRunner(const YAML::Node &sweep, Messenger *messenger) : messenger(messenger)
+{
+    try
+    {
+        base_config = YAML::LoadFile(sweep["BaseConfig"].as<std::string>());
+        if (sweep["ExitConfig"])
+        {
+            base_exit = YAML::LoadFile(sweep["ExitConfig"].as<std::string>());
+        }
+
+        num_runs         = sweep["Runs"].as<uint32_t>();
+        seed             = sweep["Seed"]            ? sweep["Seed"].as<uint64_t>()           : 0;
+        num_threads      = sweep["Threads"]         ? sweep["Threads"].as<uint32_t>()        : 0;
+        settle_tolerance = sweep["SettleTolerance"] ? sweep["SettleTolerance"].as<float>()   : -1;
+        same_noise       = sweep["SameNoise"]       ? sweep["SameNoise"].as<bool>()          : false;
+        output_path      = sweep["Output"]          ? sweep["Output"].as<std::string>()      : get_default_output_path();
+        if ("none" == output_path)
+        {
+            output_path.clear();
+        }
+
+        if (sweep["Checkpoint"])
+        {
+            checkpoint = std::make_shared<const sim_checkpoint>(Checkpoint::read(sweep["Checkpoint"].as<std::string>()));
+        }
+
+        for (const YAML::Node &p : sweep["Parameters"])
+        {
+            sweep_parameter parameter;
+            parameter.name           = p["Path"].as<std::string>();
+            parameter.keys           = split_path(parameter.name);
+            parameter.in_exit_config = ("Exit" == parameter.keys.front());
+            parameter.scale          = p["Scale"] ? p["Scale"].as<bool>() : false;
+
+            if (parameter.in_exit_config)
+            {
+                parameter.keys.erase(parameter.keys.begin());
+                if (!base_exit)
+                {
+                    throw invalid_batch_spec(std::string("Parameter " + parameter.name + " needs an ExitConfig.").c_str());
+                }
+            }
+            if (parameter.keys.empty())
+            {
+                throw invalid_batch_spec(std::string("Parameter path " + parameter.name + " is empty.").c_str());
+            }
+
+            const std::string distribution = p["Distribution"].as<std::string>();
+            if ("Uniform" == distribution)
+            {
+                parameter.distribution = Distribution::Uniform;
+                parameter.first        = p["Min"];
+                parameter.second       = p["Max"];
+            }
+            else if ("Normal" == distribution)
+            {
+                parameter.distribution = Distribution::Normal;
+                parameter.first        = p["Mean"];
+                parameter.second       = p["StdDev"];
+            }
+            else if ("Values" == distribution)
+            {
+                parameter.distribution = Distribution::Values;
+                parameter.first        = p["Values"];
+                if (!parameter.first.IsSequence() || (0 == parameter.first.size()))
+                {
+                    throw invalid_batch_spec(std::string("Parameter " + parameter.name + " needs a list of Values.").c_str());
+                }
+            }
+            else
+            {
+                throw invalid_batch_spec(std::string("Unknown distribution: " + distribution).c_str());
+            }
+
+            parameters.push_back(parameter);
+        }
+    }
+    catch (YAML::Exception &e)
+    {
+        throw invalid_batch_spec(std::string("Invalid sweep: " + std::string(e.what())).c_str());
+    }
+
+    if (0 == num_runs)
+    {
+        throw invalid_batch_spec("Sweep yaml must request at least one run.");
+    }
+
+    if (0 == num_threads)
+    {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, num_runs);
+
+    /* The first run decides the summary columns. Every run samples values of the same shape. */
+    YAML::Node config;
+    YAML::Node exit;
+    std::vector<float> values;
+    try
+    {
+        sample_parameters(0, &config, &exit, &values);
+    }
+    catch (YAML::Exception &e)
+    {
+        throw invalid_batch_spec(std::string("Unable to sample sweep parameters: " + std::string(e.what())).c_str());
+    }
+
+    /* Every run gets the same environment unless the sweep varies it, or how long the runs are */
+    bool shared_environment = true;
+    for (const sweep_parameter &parameter : parameters)
+    {
+        if (!parameter.in_exit_config && (("Environment" == parameter.keys.front()) || ("Timeout" == parameter.keys.front())))
+        {
+            shared_environment = false;
+        }
+    }
+
+    if (shared_environment)
+    {
+        std::shared_ptr<const Configuration> base = Configuration::Load(base_config, base_exit);
+        if (!base)
+        {
+            throw invalid_batch_spec("Base config yaml cannot be run.");
+        }
+        if (base->GetEnvironment().enabled)
+        {
+            timestamp duration(base->getTimeout(), 0);
+            if (checkpoint)
+            {
+                duration = checkpoint->simulator.simulation_time + duration;
+            }
+            environment = EnvironmentTable::load(base->GetEnvironment(), duration);
+        }
+    }
+}
+
+void BatchRunner::sample_parameters(uint32_t run_index, YAML::Node *config, YAML::Node *exit, std::vector<float> *values)
+{
+    std::lock_guard<std::mutex> lock(this->yaml_mutex);
+
+    /* Each run has its own generator, so the samples do not depend on which thread runs it. */
+    std::seed_seq seq{(uint64_t) this->seed, (uint64_t) run_index};
+    std::mt19937_64 rng(seq);
+
+    *config = YAML::Clone(this->base_config);
+    *exit   = this->base_exit ? YAML::Clone(this->base_exit) : YAML::Node();
+    values->clear();
+
+    const bool record_columns = this->parameter_columns.empty();
+
+    for (const sweep_parameter &parameter : this->parameters)
+    {
+        YAML::Node target = parameter.in_exit_config ? *exit : *config;
+        for (size_t k = 0; k + 1 < parameter.keys.size(); k++)
+        {
+            target.reset(target[parameter.keys.at(k)]);
+        }
+        const std::string &last_key = parameter.keys.back();
+
+        YAML::Node sample;
+        switch (parameter.distribution)
+        {
+            case Distribution::Uniform:
+                sample = combine_leaves(parameter.first, parameter.second, [&rng](float min, float max)
+                {
+                    return std::uniform_real_distribution<float>(min, max)(rng);
+                });
+                break;
+            case Distribution::Normal:
+                sample = combine_leaves(parameter.first, parameter.second, [&rng](float mean, float std_dev)
+                {
+                    return std::normal_distribution<float>(mean, std_dev)(rng);
+                });
+                break;
+            case Distribution::Values:
+                sample = YAML::Clone(parameter.first[run_index % parameter.first.size()]);
+                break;
+        }
+
+        if (parameter.scale)
+        {
+            sample = combine_leaves(target[last_key], sample, [](float base, float factor)
+            {
+                return base * factor;
+            });
+        }
+
+        target[last_key] = sample;
+        flatten_leaves(sample, parameter.name, values, record_columns ? &this->parameter_columns : nullptr);
+    }
+}
+
+void BatchRunner::run()
+{
+    this->results.assign(this->num_runs, run_result());
+    this->next_run      = 0;
+    this->finished_runs = 0;
+
+    messenger->send_message("Starting batch of " + std::to_string(this->num_runs) + " runs on " +
+                            std::to_string(this->num_threads) + " threads.", text_colour.cyan);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < this->num_threads; i++)
+    {
+        workers.emplace_back(&BatchRunner::worker, this);
+    }
+
+    /* Report progress every 10%, woken by the workers as each run finishes */
+    uint32_t reported = 0;
+    while (reported < this->num_runs)
+    {
+        uint32_t finished;
+        {
+            std::unique_lock<std::mutex> lock(this->progress_mutex);
+            this->progress_changed.wait(lock, [this, reported]() { return this->finished_runs.load() != reported; });
+            finished = this->finished_runs.load();
+        }
+        if ((finished * 10 / this->num_runs) > (reported * 10 / this->num_runs) || (finished == this->num_runs))
+        {
+            messenger->send_message(std::to_string(finished) + "/" + std::to_string(this->num_runs) + " runs finished.");
+        }
+        reported = finished;
+    }
+
+    for (std::thread &w : workers)
+    {
+        w.join();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const float seconds = std::chrono::duration<float>(end - start).count();
+
+    uint32_t failed = 0;
+    for (const run_result &result : this->results)
+    {
+        if (!result.completed)
+        {
+            failed++;
+            messenger->send_warning("Run failed: " + result.error);
+        }
+    }
+
+    std::stringstream msg;
+    msg << "Batch finished in " << seconds << " s, " << failed << " runs failed.";
+    if (!this->output_path.empty())
+    {
+        this->write_summary();
+        msg << " Summary written to " << this->output_path;
+    }
+    messenger->send_message(msg.str(), text_colour.green);
+
+    return;
+}
+
+void BatchRunner::worker()
+{
+    while (true)
+    {
+        const uint32_t run_index = this->next_run.fetch_add(1);
+        if (this->num_runs <= run_index)
+        {
+            break;
+        }
+
+        this->results.at(run_index) = this->run_one(run_index);
+        {
+            std::lock_guard<std::mutex> lock(this->progress_mutex);
+            this->finished_runs.fetch_add(1);
+        }
+        this->progress_changed.notify_one();
+    }
+}
+
+BatchRunner::run_result BatchRunner::run_one(uint32_t run_index)
+{
+    run_result result = {};
+    const auto start = std::chrono::steady_clock::now();
+
+    try
+    {
+        YAML::Node config_yaml;
+        YAML::Node exit_yaml;
+        this->sample_parameters(run_index, &config_yaml, &exit_yaml, &result.parameter_values);
+
+        /* Everything below belongs to this run only. */
+        std::shared_ptr<const Configuration> config = Configuration::Load(config_yaml, exit_yaml);
+        if (!config)
+        {
+            throw invalid_batch_spec("Config yaml cannot be run.");
+        }
+
+        Eigen::Vector3f desired_position = config->GetSatellitePosition();
+        float tolerance = this->settle_tolerance;
+
+        if (config->hasExitConditions())
+        {
+            desired_position = config->getDesiredSatellitePosition();
+            if (0 > tolerance)
+            {
+                tolerance = config->getRequiredAccuracy() * M_PI / 180;
+            }
+        }
+        if (0 > tolerance)
+        {
+            tolerance = 0.01;
+        }
+
+        Messenger run_messenger;
+        run_messenger.silence_messages();
+        run_messenger.silence_sim_prints();
+        run_messenger.silence_csv();
+
+        RunSummarySink summary(desired_position, tolerance, get_max_wheel_speeds(*config));
+        run_messenger.add_telemetry_sink(&summary);
+
+        SimulationRun run(config, &run_messenger);
+        run.set_resume_checkpoint(this->checkpoint);
+        run.set_noise_stream(this->same_noise ? 0 : run_index);
+        run.set_environment(this->environment);
+        run.execute();
+
+        result.completed             = true;
+        result.settled               = summary.settled();
+        result.settle_time           = summary.settle_time().to_seconds();
+        result.final_error           = summary.final_error();
+        result.overshoot             = summary.overshoot();
+        result.peak_wheel_speed      = summary.peak_wheel_speed();
+        result.peak_wheel_saturation = summary.peak_wheel_saturation();
+        result.end_time              = summary.end_time().to_seconds();
+    }
+    catch (adcs_exception &e)
+    {
+        result.completed = false;
+        result.error     = "run " + std::to_string(run_index) + ": " + e.message();
+    }
+    catch (YAML::Exception &e)
+    {
+        result.completed = false;
+        result.error     = "run " + std::to_string(run_index) + ": " + e.what();
+    }
+    catch (std::exception &e)
+    {
+        /* Anything else would reach the worker thread and end the whole batch */
+        result.completed = false;
+        result.error     = "run " + std::to_string(run_index) + ": " + e.what();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    result.wall_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    return result;
+}
+
+void BatchRunner::write_summary()
+{
+    std::filesystem::path path(this->output_path);
+    if (path.has_parent_path() && !std::filesystem::exists(path.parent_path()))
+    {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    std::ofstream summary(this->output_path, std::fstream::out | std::fstream::trunc);
+    if (!summary.is_open())
+    {
+        throw invalid_batch_spec(std::string("Unable to open file " + this->output_path).c_str());
+    }
+
+    summary << "Run,";
+    for (const std::string &column : this->parameter_columns)
+    {
+        summary << column << ",";
+    }
+    summary << "Completed,Settled,Settle time,Final error,Overshoot,Peak wheel speed,Peak wheel saturation,End time,Wall time ms" << std::endl;
+
+    for (uint32_t i = 0; i < this->results.size(); i++)
+    {
+        const run_result &result = this->results.at(i);
+
+        summary << i << ",";
+        for (size_t c = 0; c < this->parameter_columns.size(); c++)
+        {
+            if (c < result.parameter_values.size())
+            {
+                summary << result.parameter_values.at(c);
+            }
+            summary << ",";
+        }
+        summary << result.completed << "," << result.settled << "," << result.settle_time << ",";
+        summary << result.final_error << "," << result.overshoot << "," << result.peak_wheel_speed << ",";
+        summary << result.peak_wheel_saturation << "," << result.end_time << ",";
+        summary << result.wall_time_ms << std::endl;
+    }
+
+    summary.close();
+    return;
+}
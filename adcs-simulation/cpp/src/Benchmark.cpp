@@ -0,0 +1,284 @@
+/**
+ * @file    Benchmark.cpp
+ *
+ * @details This file implements the Benchmark class as defined in Benchmark.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Benchmark.hpp"
+#include "ConfigurationSingleton.hpp"
+#include "SimulationRun.hpp"
+
+namespace
+{
+    /**
+     * @name    to_ms
+     *
+     * @returns the duration in ms.
+    **/
+    double to_ms(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    /**
+     * @name    json_string
+     *
+     * @returns the string as a quoted json string.
+    **/
+    std::string json_string(const std::string &value)
+    {
+        std::string quoted = "\"";
+        for (char c : value)
+        {
+            if (('"' == c) || ('\\' == c))
+            {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+}
+
+Benchmark::Benchmark(Messenger *messenger, uint32_t warmup_iterations, uint32_t iterations) :
+    messenger(messenger), warmup_iterations(warmup_iterations), iterations(iterations)
+{
+    if (0 == iterations)
+    {
+        throw invalid_benchmark_args("Benchmark needs at least one timed iteration.");
+    }
+}
+
+void Benchmark::add_scenario(const std::string &name, const std::string &description, const std::string &config_path, const std::string &exit_path)
+{
+    this->scenarios.push_back({name, description, config_path, exit_path, {}});
+}
+
+void Benchmark::add_perf_tests()
+{
+    for (size_t test = 0; test < this->perf_test_descriptions.size(); test++)
+    {
+        const std::string number = std::to_string(test + 1);
+        this->add_scenario("perf_test_" + number,
+                           this->perf_test_descriptions.at(test),
+                           this->perf_test_config_yaml_path + number + ".yaml",
+                           this->perf_test_exit_yaml_path   + number + ".yaml");
+    }
+}
+
+void Benchmark::run()
+{
+    if (this->scenarios.empty())
+    {
+        throw invalid_benchmark_args("No benchmark scenarios to run.");
+    }
+
+    this->messenger->clean_csv_files();
+
+    for (scenario &run_scenario : this->scenarios)
+    {
+        this->messenger->send_message("\nBenchmark " + run_scenario.name + ":", text_colour.cyan);
+        this->messenger->send_message(run_scenario.description, text_colour.cyan);
+        this->messenger->send_message(std::to_string(this->warmup_iterations) + " warm-up and " +
+                                      std::to_string(this->iterations) + " timed iterations.", text_colour.cyan);
+
+        for (uint32_t iteration = 0; iteration < this->warmup_iterations; iteration++)
+        {
+            this->time_run(run_scenario);
+        }
+
+        run_scenario.samples.clear();
+        for (uint32_t iteration = 0; iteration < this->iterations; iteration++)
+        {
+            run_scenario.samples.push_back(this->time_run(run_scenario));
+        }
+
+        std::ostringstream summary;
+        summary << std::fixed << std::setprecision(3);
+        summary << std::left << std::setw(12) << "phase" << std::right
+                << std::setw(12) << "median ms" << std::setw(12) << "p95 ms" << std::setw(12) << "stddev ms";
+        for (const std::string &phase : this->phase_names)
+        {
+            const phase_stats stats = summarize(phase_samples(run_scenario, phase));
+            summary << "\n" << std::left << std::setw(12) << phase << std::right
+                    << std::setw(12) << stats.median << std::setw(12) << stats.p95 << std::setw(12) << stats.stddev;
+        }
+        summary << "\n" << run_scenario.samples.front().steps << " timesteps per run.\n";
+        this->messenger->send_message(summary.str(), text_colour.yellow);
+    }
+
+    this->messenger->clean_csv_files();
+}
+
+phase_timing Benchmark::time_run(const scenario &run_scenario)
+{
+    phase_timing timing;
+
+    Messenger run_messenger;
+    run_messenger.silence_messages();
+    run_messenger.silence_sim_prints();
+    run_messenger.set_csv_print_rate(this->csv_print_rate);
+
+    /* Parse the yamls on every run, otherwise only the first run would pay for it */
+    Configuration::ClearCache();
+    const auto load_start = std::chrono::steady_clock::now();
+    std::shared_ptr<const Configuration> config = Configuration::Load(run_scenario.config_path, run_scenario.exit_path);
+    const std::chrono::nanoseconds load_time = std::chrono::steady_clock::now() - load_start;
+    if (!config)
+    {
+        throw invalid_benchmark_args(std::string("Unable to load scenario " + run_scenario.config_path).c_str());
+    }
+
+    SimulationRun run(config, &run_messenger);
+    run.set_phase_timing(&timing);
+    run.execute();
+
+    timing.setup += load_time;
+    timing.total += load_time;
+    return timing;
+}
+
+std::vector<double> Benchmark::phase_samples(const scenario &run_scenario, const std::string &phase)
+{
+    std::vector<double> samples;
+    samples.reserve(run_scenario.samples.size());
+
+    for (const phase_timing &timing : run_scenario.samples)
+    {
+        if ("setup" == phase)
+        {
+            samples.push_back(to_ms(timing.setup));
+        }
+        else if ("physics" == phase)
+        {
+            samples.push_back(to_ms(timing.physics));
+        }
+        else if ("controller" == phase)
+        {
+            const std::chrono::nanoseconds controller = timing.total - timing.setup - timing.physics - timing.io;
+            samples.push_back(std::max(0.0, to_ms(controller)));
+        }
+        else if ("io" == phase)
+        {
+            samples.push_back(to_ms(timing.io));
+        }
+        else
+        {
+            samples.push_back(to_ms(timing.total));
+        }
+    }
+
+    return samples;
+}
+
+Benchmark::phase_stats Benchmark::summarize(std::vector<double> samples)
+{
+    phase_stats stats = {0, 0, 0, 0, 0, 0};
+    if (samples.empty())
+    {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const size_t count = samples.size();
+
+    stats.min    = samples.front();
+    stats.max    = samples.back();
+    stats.median = (0 == (count % 2)) ? (samples[count/2 - 1] + samples[count/2]) / 2 : samples[count/2];
+    stats.p95    = samples[static_cast<size_t>(std::ceil(0.95 * count)) - 1];
+
+    double sum = 0;
+    for (double sample : samples)
+    {
+        sum += sample;
+    }
+    stats.mean = sum / count;
+
+    if (1 < count)
+    {
+        double squares = 0;
+        for (double sample : samples)
+        {
+            squares += (sample - stats.mean) * (sample - stats.mean);
+        }
+        stats.stddev = std::sqrt(squares / (count - 1));
+    }
+
+    return stats;
+}
+
+void Benchmark::write_json(const std::string &path) const
+{
+    const std::filesystem::path json_path(path);
+    if (json_path.has_parent_path())
+    {
+        std::filesystem::create_directories(json_path.parent_path());
+    }
+
+    std::ofstream json(path);
+    if (!json)
+    {
+        this->messenger->send_error("Could not open " + path + " for writing.");
+        return;
+    }
+
+    json << std::setprecision(6) << std::fixed;
+    json << "{\n";
+    json << "  \"unit\": \"ms\",\n";
+    json << "  \"warmup_iterations\": " << this->warmup_iterations << ",\n";
+    json << "  \"iterations\": " << this->iterations << ",\n";
+    json << "  \"scenarios\": [";
+
+    for (size_t i = 0; i < this->scenarios.size(); i++)
+    {
+        const scenario &run_scenario = this->scenarios.at(i);
+
+        json << ((0 == i) ? "\n" : ",\n");
+        json << "    {\n";
+        json << "      \"name\": "        << json_string(run_scenario.name)        << ",\n";
+        json << "      \"description\": " << json_string(run_scenario.description) << ",\n";
+        json << "      \"config\": "      << json_string(run_scenario.config_path) << ",\n";
+        json << "      \"exit\": "        << json_string(run_scenario.exit_path)   << ",\n";
+        json << "      \"steps\": " << (run_scenario.samples.empty() ? 0 : run_scenario.samples.front().steps) << ",\n";
+        json << "      \"phases\": {";
+
+        for (size_t p = 0; p < this->phase_names.size(); p++)
+        {
+            const std::vector<double> samples = phase_samples(run_scenario, this->phase_names.at(p));
+            const phase_stats stats = summarize(samples);
+
+            json << ((0 == p) ? "\n" : ",\n");
+            json << "        " << json_string(this->phase_names.at(p)) << ": {";
+            json << "\"median\": " << stats.median << ", \"p95\": " << stats.p95 << ", \"mean\": " << stats.mean;
+            json << ", \"stddev\": " << stats.stddev << ", \"min\": " << stats.min << ", \"max\": " << stats.max;
+            json << ", \"samples\": [";
+            for (size_t s = 0; s < samples.size(); s++)
+            {
+                json << ((0 == s) ? "" : ", ") << samples.at(s);
+            }
+            json << "]}";
+        }
+
+        json << "\n      }\n";
+        json << "    }";
+    }
+
+    json << "\n  ]\n";
+    json << "}\n";
+
+    this->messenger->send_message("Benchmark results written to " + path);
+}
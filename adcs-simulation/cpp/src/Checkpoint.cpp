@@ -0,0 +1,307 @@
+/**
+ * @file Checkpoint.cpp
+ *
+ * @details implementation of the checkpoint file, as described in Checkpoint.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "Checkpoint.hpp"
+
+namespace
+{
+    /* Largest number of events, wheels or devices accepted from a file, to reject corrupt counts. */
+    const uint32_t max_checkpoint_count = 1 << 20;
+
+    /**
+     * @class   checkpoint_writer
+     *
+     * @details writes the fields of a checkpoint in order.
+    **/
+    class checkpoint_writer
+    {
+        public:
+            explicit checkpoint_writer(std::ofstream &file) : file(file) {}
+
+            template <typename T>
+            void value(const T &v)
+            {
+                this->file.write(reinterpret_cast<const char*>(&v), sizeof(v));
+            }
+
+            void time(timestamp t)
+            {
+                this->value<uint64_t>(t.microseconds());
+            }
+
+            template <typename Derived>
+            void floats(const Eigen::DenseBase<Derived> &m)
+            {
+                for (Eigen::Index c = 0; c < m.cols(); c++)
+                {
+                    for (Eigen::Index r = 0; r < m.rows(); r++)
+                    {
+                        this->value<float>(m(r, c));
+                    }
+                }
+            }
+
+            void times(const std::vector<timestamp> &ts)
+            {
+                this->value<uint32_t>(ts.size());
+                for (timestamp t : ts)
+                {
+                    this->time(t);
+                }
+            }
+
+        private:
+            std::ofstream &file;
+    };
+
+    /**
+     * @class   checkpoint_reader
+     *
+     * @details reads the fields of a checkpoint in order. Throws invalid_checkpoint if the file
+     *          ends early.
+    **/
+    class checkpoint_reader
+    {
+        public:
+            explicit checkpoint_reader(std::ifstream &file) : file(file) {}
+
+            template <typename T>
+            T value()
+            {
+                T v;
+                if (!this->file.read(reinterpret_cast<char*>(&v), sizeof(v)))
+                {
+                    throw invalid_checkpoint("Checkpoint file is truncated.");
+                }
+                return v;
+            }
+
+            timestamp time()
+            {
+                return timestamp::from_microseconds(this->value<uint64_t>());
+            }
+
+            uint32_t count()
+            {
+                const uint32_t n = this->value<uint32_t>();
+                if (max_checkpoint_count < n)
+                {
+                    throw invalid_checkpoint("Checkpoint file is corrupt.");
+                }
+                return n;
+            }
+
+            template <typename Derived>
+            void floats(Eigen::DenseBase<Derived> &m)
+            {
+                for (Eigen::Index c = 0; c < m.cols(); c++)
+                {
+                    for (Eigen::Index r = 0; r < m.rows(); r++)
+                    {
+                        m(r, c) = this->value<float>();
+                    }
+                }
+            }
+
+            std::vector<timestamp> times()
+            {
+                std::vector<timestamp> ts(this->count());
+                for (timestamp &t : ts)
+                {
+                    t = this->time();
+                }
+                return ts;
+            }
+
+        private:
+            std::ifstream &file;
+    };
+}
+
+void Checkpoint::write(const sim_checkpoint &checkpoint, const std::string &path)
+{
+    const std::filesystem::path checkpoint_path(path);
+    if (checkpoint_path.has_parent_path())
+    {
+        std::filesystem::create_directories(checkpoint_path.parent_path());
+    }
+
+    const std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            throw invalid_checkpoint(std::string("Unable to open file " + temporary_path).c_str());
+        }
+
+        checkpoint_writer out(file);
+        const simulator_state &sim = checkpoint.simulator;
+
+        file.write(magic, sizeof(magic));
+        out.value(format_version);
+
+        out.time(sim.simulation_time);
+        out.time(sim.timestep_length);
+        out.value<float>(sim.last_step_error);
+        out.times(sim.scheduled_events);
+        out.value<uint64_t>(sim.noise_positions.gyroscope_angle);
+        out.value<uint64_t>(sim.noise_positions.gyroscope_rate);
+        out.value<uint64_t>(sim.noise_positions.accelerometer);
+
+        const Satellite &satellite = sim.system_vals.satellite;
+        out.floats(satellite.theta_b);
+        out.floats(satellite.omega_b);
+        out.floats(satellite.alpha_b);
+        out.floats(satellite.inertia_b);
+
+        out.floats(sim.system_vals.accelerometer.measurement);
+        out.floats(sim.system_vals.accelerometer.position);
+
+        const sim_gyroscope &gyroscope = sim.system_vals.gyroscope;
+        out.floats(gyroscope.theta);
+        out.floats(gyroscope.omega);
+        out.floats(gyroscope.alpha);
+        out.floats(gyroscope.position);
+
+        const sim_reaction_wheels &wheels = sim.system_vals.reaction_wheels;
+        out.value<uint32_t>(wheels.omega.size());
+        out.floats(wheels.omega);
+        out.floats(wheels.alpha);
+        out.floats(wheels.inertia);
+        out.floats(wheels.axis_of_rotation);
+        out.floats(wheels.position);
+
+        out.times(checkpoint.gyroscope_polls);
+        out.times(checkpoint.accelerometer_polls);
+        out.times(checkpoint.reaction_wheel_polls);
+
+        out.value<uint8_t>(checkpoint.has_controller ? 1 : 0);
+        if (checkpoint.has_controller)
+        {
+            const PointingModeController::loop_state &controller = checkpoint.controller;
+            out.value<uint8_t>(controller.started ? 1 : 0);
+            out.floats(controller.initial_attitude);
+            out.time(controller.start);
+            out.time(controller.prev_time);
+            out.floats(controller.prev_error);
+            out.floats(controller.prev_derivative);
+            out.floats(controller.prev_integral);
+            out.value<uint8_t>(controller.filter.initialized ? 1 : 0);
+            out.time(controller.filter.time);
+            out.floats(controller.filter.x);
+            out.floats(controller.filter.P);
+        }
+
+        if (!file)
+        {
+            throw invalid_checkpoint(std::string("Unable to write file " + temporary_path).c_str());
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error)
+    {
+        throw invalid_checkpoint(std::string("Unable to write file " + path).c_str());
+    }
+
+    return;
+}
+
+sim_checkpoint Checkpoint::read(const std::string &path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        throw invalid_checkpoint(std::string("Unable to open checkpoint " + path).c_str());
+    }
+
+    checkpoint_reader in(file);
+
+    char file_magic[sizeof(magic)];
+    if (!file.read(file_magic, sizeof(file_magic)) || (0 != std::memcmp(file_magic, magic, sizeof(magic))))
+    {
+        throw invalid_checkpoint(std::string(path + " is not a checkpoint file.").c_str());
+    }
+    if (format_version != in.value<uint32_t>())
+    {
+        throw invalid_checkpoint(std::string(path + " was written by a different version of the simulator.").c_str());
+    }
+
+    sim_checkpoint checkpoint;
+    simulator_state &sim = checkpoint.simulator;
+
+    sim.simulation_time  = in.time();
+    sim.timestep_length  = in.time();
+    sim.last_step_error  = in.value<float>();
+    sim.scheduled_events = in.times();
+    sim.noise_positions.gyroscope_angle = in.value<uint64_t>();
+    sim.noise_positions.gyroscope_rate  = in.value<uint64_t>();
+    sim.noise_positions.accelerometer   = in.value<uint64_t>();
+
+    Satellite &satellite = sim.system_vals.satellite;
+    in.floats(satellite.theta_b);
+    in.floats(satellite.omega_b);
+    in.floats(satellite.alpha_b);
+    in.floats(satellite.inertia_b);
+
+    in.floats(sim.system_vals.accelerometer.measurement);
+    in.floats(sim.system_vals.accelerometer.position);
+
+    sim_gyroscope &gyroscope = sim.system_vals.gyroscope;
+    in.floats(gyroscope.theta);
+    in.floats(gyroscope.omega);
+    in.floats(gyroscope.alpha);
+    in.floats(gyroscope.position);
+
+    sim_reaction_wheels &wheels = sim.system_vals.reaction_wheels;
+    const uint32_t num_wheels = in.count();
+    wheels.omega.resize(num_wheels);
+    wheels.alpha.resize(num_wheels);
+    wheels.inertia.resize(num_wheels);
+    wheels.axis_of_rotation.resize(3, num_wheels);
+    wheels.position.resize(3, num_wheels);
+    in.floats(wheels.omega);
+    in.floats(wheels.alpha);
+    in.floats(wheels.inertia);
+    in.floats(wheels.axis_of_rotation);
+    in.floats(wheels.position);
+
+    checkpoint.gyroscope_polls      = in.times();
+    checkpoint.accelerometer_polls  = in.times();
+    checkpoint.reaction_wheel_polls = in.times();
+
+    checkpoint.has_controller = (0 != in.value<uint8_t>());
+    checkpoint.controller     = {false, Eigen::Vector3f::Zero(), 0, 0, Eigen::Vector3f::Zero(), Eigen::Vector3f::Zero(), Eigen::Vector3f::Zero(),
+                                 {false, 0, Eigen::Matrix<float, 2, 3>::Zero(), Eigen::Matrix2f::Zero()}};
+    if (checkpoint.has_controller)
+    {
+        PointingModeController::loop_state &controller = checkpoint.controller;
+        controller.started = (0 != in.value<uint8_t>());
+        in.floats(controller.initial_attitude);
+        controller.start     = in.time();
+        controller.prev_time = in.time();
+        in.floats(controller.prev_error);
+        in.floats(controller.prev_derivative);
+        in.floats(controller.prev_integral);
+        controller.filter.initialized = (0 != in.value<uint8_t>());
+        controller.filter.time        = in.time();
+        in.floats(controller.filter.x);
+        in.floats(controller.filter.P);
+    }
+
+    return checkpoint;
+}
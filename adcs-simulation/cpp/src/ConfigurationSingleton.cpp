@@ -1,17 +1,21 @@
 /**
  * @file ConfigurationSingleton.cpp
  *
- * @details singleton class used to configure the user's sensor/actuator inputs
+ * @details immutable configuration of the user's sensor/actuator inputs, and the cache of
+ *          loaded configurations
  *
  * @authors Lily de Loe
  *
  * Last Edited
- * 2022-11-08
+ * 2026-10-14
  *
 **/
 
 #include "ConfigurationSingleton.hpp"
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <sys/stat.h>
 
 ReactionWheelConfig::ReactionWheelConfig(const YAML::Node &node) : ActuatorConfig(ActuatorType::ReactionWheel) {
     momentOfInertia = node["Moment"].as<float>();
@@ -36,14 +40,159 @@ ReactionWheelConfig::ReactionWheelConfig(const YAML::Node &node) : ActuatorConfi
     acceleration = node["Acceleration"].as<float>();
 }
 
-bool Configuration::Load(const std::string &configFile) {
-    //load the yaml config file
+namespace
+{
+    /* Process noise of the attitude filter if the yaml does not set one, in rad/s^2 */
+    const float default_filter_process_noise = 0.001;
+
+    /**
+     * @name    read_gain
+     *
+     * @details reads one gain of the controller, either one value for every axis or a value per axis.
+    **/
+    Eigen::Vector3f read_gain(const YAML::Node &node)
+    {
+        if (!node.IsSequence())
+        {
+            return Eigen::Vector3f::Constant(node.as<float>());
+        }
+
+        Eigen::Vector3f gain;
+        if (3 != node.size())
+        {
+            throw YAML::RepresentationException(node.Mark(), "a gain needs one value or one per axis");
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            gain(i) = node[i].as<float>();
+        }
+        return gain;
+    }
+
+    /* Orbit of the environment models if the yaml does not set one: a 500 km sun synchronous orbit, in km and degrees */
+    const double default_orbit_altitude    = 500;
+    const double default_orbit_inclination = 97.4;
+
+    /* Time between two samples of the environment table if the yaml does not set one, in s */
+    const float default_environment_grid_step = 10;
+
+    /**
+     * @struct  file_stamp
+     *
+     * @details identifies one version of a file on disk.
+    **/
+    typedef struct
+    {
+        bool    exists;
+        int64_t modified_ns;
+        int64_t size;
+    } file_stamp;
+
+    /**
+     * @struct  cache_entry
+     *
+     * @details a cached configuration, with the versions of the files it was loaded from.
+    **/
+    typedef struct
+    {
+        file_stamp                           config_stamp;
+        file_stamp                           exit_stamp;
+        std::shared_ptr<const Configuration> config;
+    } cache_entry;
+
+    /* Loaded configurations, keyed by config file path and exit file path */
+    std::unordered_map<std::string, cache_entry> config_cache;
+
+    /* Guards config_cache, as runs may load their configuration from separate threads */
+    std::mutex config_cache_mutex;
+
+    file_stamp get_file_stamp(const std::string &fileName)
+    {
+        file_stamp stamp = {false, 0, 0};
+        struct stat info;
+        if (0 == stat(fileName.c_str(), &info))
+        {
+            stamp.exists      = true;
+            stamp.modified_ns = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+            stamp.size        = info.st_size;
+        }
+        return stamp;
+    }
+
+    bool same_file_version(const file_stamp &a, const file_stamp &b)
+    {
+        return a.exists && b.exists && (a.modified_ns == b.modified_ns) && (a.size == b.size);
+    }
+}
+
+bool Configuration::load_yaml_file(const std::string &fileName, YAML::Node *node) {
     try {
-        top = YAML::LoadFile(configFile);
+        *node = YAML::LoadFile(fileName);
     } catch (YAML::Exception &e) {
-        std::cout << "YAML File Load failure for file: " << configFile << " : " << e.what() << std::endl;
+        std::cout << "YAML File Load failure for file: " << fileName << " : " << e.what() << std::endl;
         return false;
     }
+    return true;
+}
+
+std::shared_ptr<const Configuration> Configuration::Load(const std::string &configFile, const std::string &exitFile) {
+    const std::string key          = configFile + '\n' + exitFile;
+    const file_stamp  config_stamp = get_file_stamp(configFile);
+    const file_stamp  exit_stamp   = exitFile.empty() ? file_stamp{true, 0, 0} : get_file_stamp(exitFile);
+
+    {
+        std::lock_guard<std::mutex> lock(config_cache_mutex);
+        const auto it = config_cache.find(key);
+        if ((config_cache.end() != it) &&
+            same_file_version(it->second.config_stamp, config_stamp) &&
+            same_file_version(it->second.exit_stamp, exit_stamp))
+        {
+            return it->second.config;
+        }
+    }
+
+    //load the yaml files
+    YAML::Node config;
+    YAML::Node exit;
+    if (!load_yaml_file(configFile, &config)) {
+        return nullptr;
+    }
+    if (!exitFile.empty() && !load_yaml_file(exitFile, &exit)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<const Configuration> loaded = Load(config, exit);
+
+    {
+        std::lock_guard<std::mutex> lock(config_cache_mutex);
+        config_cache[key] = {config_stamp, exit_stamp, loaded};
+    }
+
+    return loaded;
+}
+
+std::shared_ptr<const Configuration> Configuration::Load(const YAML::Node &config, const YAML::Node &exit) {
+    /* The constructor is private, so make_shared cannot be used */
+    std::shared_ptr<Configuration> loaded(new Configuration());
+
+    if (!loaded->parse_config(config)) {
+        return nullptr;
+    }
+    if (exit.IsDefined() && !exit.IsNull()) {
+        loaded->parse_exit(exit);
+        loaded->exitConditionsLoaded = true;
+    }
+
+    return loaded;
+}
+
+void Configuration::ClearCache() {
+    std::lock_guard<std::mutex> lock(config_cache_mutex);
+    config_cache.clear();
+}
+
+bool Configuration::parse_config(const YAML::Node &top) {
+    bool valid = true;
 
     //load initial satellite configuration
     try {
@@ -80,16 +229,53 @@ bool Configuration::Load(const std::string &configFile) {
         std::cout << "YAML ERROR ON VARIABLE TIMESTEP: " << e.what() <<std::endl;
     }
 
+    //load the integrator, Euler is used if none is provided
+    integratorType = IntegratorType::Euler;
+    try {
+        YAML::Node integrator = top["Integrator"];
+        if (integrator) {
+            const std::string type = integrator.as<std::string>();
+            if (type == "Euler") {
+                integratorType = IntegratorType::Euler;
+            } else if (type == "RK4") {
+                integratorType = IntegratorType::RK4;
+            } else if (type == "DormandPrince") {
+                integratorType = IntegratorType::DormandPrince;
+            } else {
+                std::cout << "Unknown integrator type: " << type << ", using Euler" << std::endl;
+            }
+        }
+    } catch (YAML::Exception &e){
+        std::cout << "YAML ERROR ON INTEGRATOR: " << e.what() <<std::endl;
+    }
+
+    //the adaptive integrator always sizes its own timestep
+    if (integratorType == IntegratorType::DormandPrince) {
+        useVariableTimestep = true;
+    }
+
     if (useVariableTimestep == true) {
-    //load max and min timestep
+    //load max and min timestep, the max defaults to the fixed timestep and the min to a thousandth of the max
         try {
             YAML::Node max = top["TimeStepMax"];
-            timeStepMax = max.as<int>();
+            YAML::Node time = top["TimeStep"];
+            if (max) {
+                timeStepMax = max.as<float>();
+            } else if (time) {
+                timeStepMax = time.as<float>();
+            }
             YAML::Node min = top["TimeStepMin"];
-            timeStepMin = min.as<int>();
+            timeStepMin = min ? min.as<float>() : timeStepMax / 1000;
         } catch (YAML::Exception &e){
             std::cout << "YAML ERROR ON TIMESTEP BOUNDS: " << e.what() <<std::endl;
         }
+
+        //a variable timestep cannot run without a usable range
+        if (!(0 < timeStepMax) || !(0 < timeStepMin) || (timeStepMax < timeStepMin)) {
+            std::cout << "YAML ERROR ON TIMESTEP BOUNDS: need 0 < TimeStepMin <= TimeStepMax, got TimeStepMin "
+                      << timeStepMin << " and TimeStepMax " << timeStepMax << std::endl;
+            valid = false;
+        }
     }
     else
     {
@@ -110,54 +296,141 @@ bool Configuration::Load(const std::string &configFile) {
         std::cout << "YAML ERROR ON TIMEOUT: " << e.what() <<std::endl;
     }
 
-    //load sensors
+    //load sensors, each gets the next id of its type in the order of the yaml file
     try {
+        std::map<SensorType, uint32_t> next_sensor_id;
         YAML::Node sensors = top["Sensors"];
         for (const auto &n : sensors) {
             const std::string type = n.second["type"].as<std::string>();
+            std::shared_ptr<SensorConfig> sensor;
             if (type == "Gyroscope") {
-                sensorConfigs[n.first.as<std::string>()] = std::make_shared<GyroConfig>(n.second);
+                sensor = std::make_shared<GyroConfig>(n.second);
             } else if (type == "Accelerometer") {
-                sensorConfigs[n.first.as<std::string>()] = std::make_shared<AccelerometerConfig>(n.second);
+                sensor = std::make_shared<AccelerometerConfig>(n.second);
             } else {
                 std::cout << "Error unknown sensor type: " << type << std::endl;
+                continue;
             }
+            sensor->id = next_sensor_id[sensor->type]++;
+            sensorConfigs[n.first.as<std::string>()] = sensor;
           }
     } catch (YAML::Exception &e) {
         std::cout << "YAML ERROR ON SENSORS: " << e.what() << std::endl;
     }
 
-    //load actuators
+    //load actuators, each gets the next id of its type in the order of the yaml file
     try {
+        std::map<ActuatorType, uint32_t> next_actuator_id;
         YAML::Node actuatorsYaml = top["Actuators"];
         for (const auto &n : actuatorsYaml) {
             const std::string type = n.second["type"].as<std::string>();
+            std::shared_ptr<ActuatorConfig> actuator;
             if (type == "ReactionWheel") {
-                actuatorConfigs[n.first.as<std::string>()] = std::make_shared<ReactionWheelConfig>(n.second);
+                actuator = std::make_shared<ReactionWheelConfig>(n.second);
             } else {
                 std::cout << "Unkown actuator type: " << type << std::endl;
+                continue;
             }
+            actuator->id = next_actuator_id[actuator->type]++;
+            actuatorConfigs[n.first.as<std::string>()] = actuator;
         }
     } catch (YAML::Exception &e) {
         std::cout << "YAML ERROR ON ACTUATORS: " << e.what() << std::endl;
     }
 
-    return true;
-}
+    //load the noise seed, 0 if none is provided
+    noiseSeed = 0;
+    try {
+        YAML::Node seed = top["NoiseSeed"];
+        if (seed) {
+            noiseSeed = seed.as<uint64_t>();
+        }
+    } catch (YAML::Exception &e) {
+        std::cout << "YAML ERROR ON NOISE SEED: " << e.what() << std::endl;
+    }
 
-bool Configuration::load_exit_file(const std::string &fileName)
-{
-    /* load the yaml config file */
-    try 
-    {
-        top = YAML::LoadFile(fileName);
-    } 
-    catch (YAML::Exception &e)
-    {
-        std::cout << "YAML File Load failure for file: " << fileName << " : " << e.what() << std::endl;
-        return false;
+    //load the controller rate, 0 if none is provided
+    controllerRate = 0;
+    try {
+        YAML::Node rate = top["ControllerRate"];
+        if (rate) {
+            controllerRate = rate.as<float>();
+        }
+    } catch (YAML::Exception &e) {
+        std::cout << "YAML ERROR ON CONTROLLER RATE: " << e.what() << std::endl;
     }
 
+    //load the controller gains, the defaults are used for any that are not provided
+    controllerGains = default_controller_gains();
+    try {
+        YAML::Node gains = top["ControllerGains"];
+        if (gains) {
+            if (gains["Kp"]) {
+                controllerGains.kp = read_gain(gains["Kp"]);
+            }
+            if (gains["Kd"]) {
+                controllerGains.kd = read_gain(gains["Kd"]);
+            }
+            if (gains["Ki"]) {
+                controllerGains.ki = read_gain(gains["Ki"]);
+            }
+            if (gains["N"]) {
+                controllerGains.N = gains["N"].as<float>();
+            }
+        }
+    } catch (YAML::Exception &e) {
+        std::cout << "YAML ERROR ON CONTROLLER GAINS: " << e.what() << std::endl;
+    }
+
+    //load the attitude filter, its measurement noise defaults to the noise of the first gyroscope
+    attitudeFilter = {false, 0, 0, 0};
+    try {
+        YAML::Node filter = top["AttitudeFilter"];
+        if (filter) {
+            for (const auto &sensor : sensorConfigs) {
+                if ((SensorType::Gyroscope == sensor.second->type) && (0 == sensor.second->id)) {
+                    const GyroConfig *gyro = dynamic_cast<const GyroConfig*>(sensor.second.get());
+                    attitudeFilter.angle_noise = gyro->noiseStdDev;
+                    attitudeFilter.rate_noise  = gyro->rateNoiseStdDev;
+                }
+            }
+            attitudeFilter.enabled       = true;
+            attitudeFilter.process_noise = filter["ProcessNoise"] ? filter["ProcessNoise"].as<float>() : default_filter_process_noise;
+            if (filter["AngleNoise"]) {
+                attitudeFilter.angle_noise = filter["AngleNoise"].as<float>();
+            }
+            if (filter["RateNoise"]) {
+                attitudeFilter.rate_noise = filter["RateNoise"].as<float>();
+            }
+        }
+    } catch (YAML::Exception &e) {
+        std::cout << "YAML ERROR ON ATTITUDE FILTER: " << e.what() << std::endl;
+    }
+
+    //load the environment models, unused if there is no Environment section
+    environment = {false, 0, 0, 0, 0, 0, timestamp(0, 0), ""};
+    try {
+        YAML::Node env = top["Environment"];
+        if (env) {
+            const double deg = M_PI / 180;
+            environment.enabled                      = true;
+            environment.altitude                     = (env["Altitude"] ? env["Altitude"].as<double>() : default_orbit_altitude) * 1000;
+            environment.inclination                  = (env["Inclination"] ? env["Inclination"].as<double>() : default_orbit_inclination) * deg;
+            environment.right_ascension              = (env["RightAscension"] ? env["RightAscension"].as<double>() : 0) * deg;
+            environment.initial_argument_of_latitude = (env["ArgumentOfLatitude"] ? env["ArgumentOfLatitude"].as<double>() : 0) * deg;
+            environment.epoch                        = env["Epoch"] ? env["Epoch"].as<double>() : 0;
+            environment.grid_step                    = timestamp(env["GridStep"] ? env["GridStep"].as<float>() : default_environment_grid_step);
+            environment.table_path                   = env["Table"] ? env["Table"].as<std::string>() : "";
+        }
+    } catch (YAML::Exception &e) {
+        std::cout << "YAML ERROR ON ENVIRONMENT: " << e.what() << std::endl;
+    }
+
+    return valid;
+}
+
+void Configuration::parse_exit(const YAML::Node &top)
+{
     /* get the final satellite configuration */
     try
     {
@@ -214,6 +487,4 @@ bool Configuration::load_exit_file(const std::string &fileName)
     {
         std::cout << "YAML ERROR ON HoldTime: " << e.what() <<std::endl;
     }
-
-    return true;
 }
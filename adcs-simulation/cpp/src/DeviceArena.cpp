@@ -0,0 +1,173 @@
+/**
+ * @file    DeviceArena.cpp
+ *
+ * @details This file implements the DeviceArena class as defined in DeviceArena.hpp
+ *
+ * @authors Aidan Sheedy, Lily de Loe
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <new>
+
+#include "DeviceArena.hpp"
+#include "SensorActuatorFactory.hpp"
+
+namespace
+{
+    /**
+     * @name    count_matching
+     *
+     * @returns the number of configs of one device type.
+    **/
+    template <typename Config, typename Predicate>
+    size_t count_matching(const std::unordered_map<std::string, std::shared_ptr<const Config>> &configs, Predicate matches)
+    {
+        size_t count = 0;
+        for (const auto &config : configs)
+        {
+            if (matches(*config.second))
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @name    order_by_id
+     *
+     * @details lists the configs of one device type in id order.
+     *
+     * @param   configs every config of the device type, by name.
+     * @param   matches true for the configs of the device type.
+     * @param   ordered populated with the configs of the device type, each at the index of its id.
+    **/
+    template <typename Config, typename Predicate>
+    void order_by_id(const std::unordered_map<std::string, std::shared_ptr<const Config>> &configs, Predicate matches, std::vector<const Config *> *ordered)
+    {
+        const size_t count = count_matching(configs, matches);
+
+        ordered->assign(count, nullptr);
+        for (const auto &config : configs)
+        {
+            if (matches(*config.second))
+            {
+                if ((count <= config.second->id) || (nullptr != (*ordered)[config.second->id]))
+                {
+                    throw invalid_adcs_param("Device ids are not dense.");
+                }
+                (*ordered)[config.second->id] = config.second.get();
+            }
+        }
+    }
+}
+
+thread_local DeviceArena::device_storage DeviceArena::thread_storage = {nullptr, 0, {}, {}, {}, false};
+
+template <typename Device>
+size_t DeviceArena::blocks_for(size_t count)
+{
+    static_assert(alignof(Device) <= alignof(std::max_align_t), "Devices must fit the alignment of the buffer.");
+    return (count * sizeof(Device) + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+}
+
+DeviceArena::DeviceArena(const Configuration &config, Simulator *sim)
+{
+    /* The thread's storage is only borrowed by one arena at a time */
+    if (thread_storage.in_use)
+    {
+        this->own_storage = std::make_unique<device_storage>();
+        this->storage = this->own_storage.get();
+    }
+    else
+    {
+        this->storage = &thread_storage;
+    }
+    this->storage->in_use = true;
+
+    const auto is_gyroscope      = [](const SensorConfig &c)   { return SensorType::Gyroscope == c.type; };
+    const auto is_accelerometer  = [](const SensorConfig &c)   { return SensorType::Accelerometer == c.type; };
+    const auto is_reaction_wheel = [](const ActuatorConfig &c) { return ActuatorType::ReactionWheel == c.type; };
+
+    const size_t num_gyroscopes      = count_matching(config.GetSensorConfigs(), is_gyroscope);
+    const size_t num_accelerometers  = count_matching(config.GetSensorConfigs(), is_accelerometer);
+    const size_t num_reaction_wheels = count_matching(config.GetActuatorConfigs(), is_reaction_wheel);
+
+    /* One block of buffer for every device, only grown when a run has more than the last */
+    const size_t gyroscope_blocks     = blocks_for<Gyroscope>(num_gyroscopes);
+    const size_t accelerometer_blocks = blocks_for<Accelerometer>(num_accelerometers);
+    const size_t blocks = gyroscope_blocks + accelerometer_blocks + blocks_for<Reaction_wheel>(num_reaction_wheels);
+    if (this->storage->capacity < blocks)
+    {
+        this->storage->buffer   = std::make_unique<std::max_align_t[]>(blocks);
+        this->storage->capacity = blocks;
+    }
+
+    std::max_align_t *buffer = this->storage->buffer.get();
+    this->gyroscopes      = reinterpret_cast<Gyroscope *>(buffer);
+    this->accelerometers  = reinterpret_cast<Accelerometer *>(buffer + gyroscope_blocks);
+    this->reaction_wheels = reinterpret_cast<Reaction_wheel *>(buffer + gyroscope_blocks + accelerometer_blocks);
+
+    /* The registry only lists the devices that have been built, so a failed device destroys the rest */
+    device_registry &registry = this->storage->registry;
+    try
+    {
+        order_by_id(config.GetSensorConfigs(), is_gyroscope, &this->storage->sensor_order);
+        for (const SensorConfig *gyroscope : this->storage->sensor_order)
+        {
+            Gyroscope *device = new (this->gyroscopes + registry.gyroscopes.size()) Gyroscope(SensorActuatorFactory::CreateGyroscope(*gyroscope, sim));
+            registry.gyroscopes.push_back(device);
+        }
+
+        order_by_id(config.GetSensorConfigs(), is_accelerometer, &this->storage->sensor_order);
+        for (const SensorConfig *accelerometer : this->storage->sensor_order)
+        {
+            Accelerometer *device = new (this->accelerometers + registry.accelerometers.size()) Accelerometer(SensorActuatorFactory::CreateAccelerometer(*accelerometer, sim));
+            registry.accelerometers.push_back(device);
+        }
+
+        order_by_id(config.GetActuatorConfigs(), is_reaction_wheel, &this->storage->actuator_order);
+        for (const ActuatorConfig *wheel : this->storage->actuator_order)
+        {
+            Reaction_wheel *device = new (this->reaction_wheels + registry.reaction_wheels.size()) Reaction_wheel(SensorActuatorFactory::CreateReactionWheel(dynamic_cast<const ReactionWheelConfig &>(*wheel), sim));
+            registry.reaction_wheels.push_back(device);
+        }
+    }
+    catch (...)
+    {
+        this->release();
+        throw;
+    }
+}
+
+DeviceArena::~DeviceArena()
+{
+    this->release();
+}
+
+void DeviceArena::release()
+{
+    device_registry &registry = this->storage->registry;
+
+    for (auto it = registry.reaction_wheels.rbegin(); it != registry.reaction_wheels.rend(); ++it)
+    {
+        (*it)->~Reaction_wheel();
+    }
+    for (auto it = registry.accelerometers.rbegin(); it != registry.accelerometers.rend(); ++it)
+    {
+        (*it)->~Accelerometer();
+    }
+    for (auto it = registry.gyroscopes.rbegin(); it != registry.gyroscopes.rend(); ++it)
+    {
+        (*it)->~Gyroscope();
+    }
+
+    /* Clearing keeps the capacity for the next run */
+    registry.gyroscopes.clear();
+    registry.accelerometers.clear();
+    registry.reaction_wheels.clear();
+    this->storage->in_use = false;
+}
@@ -6,7 +6,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-14
+ * 2026-10-14
 **/
 
 #include <iostream>
@@ -29,8 +29,13 @@ void DummyController::begin()
 
     while(this->timeout > time)
     {
-        timer->sleep(timestamp(0,1));
+        timer->sleep(this->step());
     }
 
     return;
 }
+
+timestamp DummyController::step()
+{
+    return timestamp(0,1);
+}
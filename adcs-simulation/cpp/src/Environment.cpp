@@ -0,0 +1,308 @@
+/**
+ * @file Environment.cpp
+ *
+ * @details implementation of the environment models and tables, as described in Environment.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Environment.hpp"
+
+namespace
+{
+    /* Gravitational parameter of the Earth, in m^3/s^2 */
+    const double earth_mu = 3.986004418e14;
+
+    /* Equatorial radius of the Earth, in m. Used for the orbit and its shadow. */
+    const double earth_radius = 6378137.0;
+
+    /* Reference radius of the IGRF coefficients, in m */
+    const double igrf_reference_radius = 6371200.0;
+
+    /* Dipole coefficients of IGRF-13 at epoch 2020, in nT, ordered as an Earth fixed vector (g11, h11, g10) */
+    const Eigen::Vector3d igrf_dipole(-1450.9, 4652.5, -29404.8);
+
+    /* Astronomical unit, in m, and the solar irradiance at 1 AU, in W/m^2 */
+    const double astronomical_unit = 1.495978707e11;
+    const double solar_constant    = 1361.0;
+
+    const double seconds_per_day = 86400.0;
+    const double rad_per_deg     = M_PI / 180.0;
+
+    /* Size of the header of a table file, a multiple of 4 so the samples after it are aligned */
+    const size_t table_header_size = 72;
+
+    /* Largest number of samples accepted from a file, to reject corrupt counts */
+    const uint64_t max_table_samples = uint64_t(1) << 32;
+
+    /**
+     * @name    earth_rotation
+     *
+     * @returns the Greenwich mean sidereal angle, in rad, that rotates the inertial frame to the
+     *          Earth fixed frame about the z axis.
+    **/
+    double earth_rotation(double days_since_j2000)
+    {
+        return std::fmod(280.46061837 + 360.98564736629 * days_since_j2000, 360.0) * rad_per_deg;
+    }
+
+    /**
+     * @name    sun_position
+     *
+     * @returns the position of the sun from the centre of the Earth, in the inertial frame, in m.
+    **/
+    Eigen::Vector3d sun_position(double days_since_j2000)
+    {
+        const double n         = days_since_j2000;
+        const double mean_long = (280.460 + 0.9856474 * n) * rad_per_deg;
+        const double anomaly   = (357.528 + 0.9856003 * n) * rad_per_deg;
+        const double ecliptic  = mean_long + (1.915 * std::sin(anomaly) + 0.020 * std::sin(2 * anomaly)) * rad_per_deg;
+        const double obliquity = (23.439 - 0.0000004 * n) * rad_per_deg;
+        const double distance  = (1.00014 - 0.01671 * std::cos(anomaly) - 0.00014 * std::cos(2 * anomaly)) * astronomical_unit;
+
+        return distance * Eigen::Vector3d(std::cos(ecliptic),
+                                          std::cos(obliquity) * std::sin(ecliptic),
+                                          std::sin(obliquity) * std::sin(ecliptic));
+    }
+
+    /**
+     * @name    read_header_value
+     *
+     * @details copies a value out of the mapped header, which is not aligned for it.
+    **/
+    template <typename T>
+    T read_header_value(const char *header, size_t *offset)
+    {
+        T value;
+        std::memcpy(&value, header + *offset, sizeof(T));
+        *offset += sizeof(T);
+        return value;
+    }
+}
+
+environment_sample EnvironmentModels::evaluate(const environment_config &config, timestamp time)
+{
+    const double t    = time.to_seconds();
+    const double days = config.epoch + t / seconds_per_day;
+
+    /* Circular orbit */
+    const double r        = earth_radius + config.altitude;
+    const double u        = config.initial_argument_of_latitude + std::sqrt(earth_mu / (r * r * r)) * t;
+    const double cos_raan = std::cos(config.right_ascension);
+    const double sin_raan = std::sin(config.right_ascension);
+    const double cos_inc  = std::cos(config.inclination);
+    const double sin_inc  = std::sin(config.inclination);
+    const Eigen::Vector3d position = r * Eigen::Vector3d(cos_raan * std::cos(u) - sin_raan * std::sin(u) * cos_inc,
+                                                         sin_raan * std::cos(u) + cos_raan * std::sin(u) * cos_inc,
+                                                         std::sin(u) * sin_inc);
+
+    /* Dipole field, evaluated in the Earth fixed frame */
+    const Eigen::Matrix3d to_earth_fixed = Eigen::AngleAxisd(-earth_rotation(days), Eigen::Vector3d::UnitZ()).toRotationMatrix();
+    const Eigen::Vector3d r_hat          = (to_earth_fixed * position).normalized();
+    const double          scale          = std::pow(igrf_reference_radius / r, 3) * 1e-9;
+    const Eigen::Vector3d field          = scale * (3 * igrf_dipole.dot(r_hat) * r_hat - igrf_dipole);
+
+    /* Sun, and the cylindrical shadow of the Earth */
+    const Eigen::Vector3d sun       = sun_position(days);
+    const Eigen::Vector3d sun_hat   = sun.normalized();
+    const Eigen::Vector3d to_sun    = sun - position;
+    const double          along_sun = position.dot(sun_hat);
+    const bool            eclipsed  = (0 > along_sun) && ((position - along_sun * sun_hat).norm() < earth_radius);
+    const double          distance  = to_sun.norm() / astronomical_unit;
+
+    environment_sample sample;
+    sample.position       = position.cast<float>();
+    sample.magnetic_field = (to_earth_fixed.transpose() * field).cast<float>();
+    sample.sun_direction  = to_sun.normalized().cast<float>();
+    sample.sun_irradiance = eclipsed ? 0 : static_cast<float>(solar_constant / (distance * distance));
+    return sample;
+}
+
+std::shared_ptr<const EnvironmentTable> EnvironmentTable::build(const environment_config &config, timestamp duration)
+{
+    if (0 == config.grid_step)
+    {
+        throw invalid_environment_table("The environment grid step must be greater than 0.");
+    }
+
+    std::shared_ptr<EnvironmentTable> table(new EnvironmentTable());
+    table->config       = config;
+    table->step         = config.grid_step.microseconds();
+    table->inverse_step = 1.0f / static_cast<float>(table->step);
+
+    /* One sample past the duration, so every time up to it is between two samples */
+    table->num_samples = duration.microseconds() / table->step + 2;
+    table->owned.resize(table->num_samples * values_per_sample);
+
+    for (uint64_t i = 0; i < table->num_samples; i++)
+    {
+        const environment_sample s = EnvironmentModels::evaluate(config, timestamp::from_microseconds(i * table->step));
+        float *v = table->owned.data() + i * values_per_sample;
+
+        for (int j = 0; j < 3; j++)
+        {
+            v[j]     = s.position(j);
+            v[3 + j] = s.magnetic_field(j);
+            v[6 + j] = s.sun_direction(j);
+        }
+        v[9] = s.sun_irradiance;
+    }
+
+    table->values = table->owned.data();
+    return table;
+}
+
+std::shared_ptr<const EnvironmentTable> EnvironmentTable::map(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (0 > fd)
+    {
+        throw invalid_environment_table(std::string("Unable to open environment table " + path).c_str());
+    }
+
+    struct stat info;
+    if ((0 != fstat(fd, &info)) || (static_cast<size_t>(info.st_size) < table_header_size))
+    {
+        close(fd);
+        throw invalid_environment_table(std::string(path + " is not an environment table.").c_str());
+    }
+
+    const size_t size    = static_cast<size_t>(info.st_size);
+    void        *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == mapping)
+    {
+        throw invalid_environment_table(std::string("Unable to map environment table " + path).c_str());
+    }
+
+    /* Owns the mapping from here, so it is unmapped if the file is rejected */
+    std::shared_ptr<EnvironmentTable> table(new EnvironmentTable());
+    table->mapping      = mapping;
+    table->mapping_size = size;
+
+    const char *header = static_cast<const char*>(mapping);
+    if (0 != std::memcmp(header, magic, sizeof(magic)))
+    {
+        throw invalid_environment_table(std::string(path + " is not an environment table.").c_str());
+    }
+
+    size_t offset = sizeof(magic);
+    if ((format_version != read_header_value<uint32_t>(header, &offset)) ||
+        (values_per_sample != read_header_value<uint32_t>(header, &offset)))
+    {
+        throw invalid_environment_table(std::string(path + " was written by a different version of the simulator.").c_str());
+    }
+
+    table->step        = read_header_value<uint64_t>(header, &offset);
+    table->num_samples = read_header_value<uint64_t>(header, &offset);
+
+    environment_config &config = table->config;
+    config.enabled                      = true;
+    config.altitude                     = read_header_value<double>(header, &offset);
+    config.inclination                  = read_header_value<double>(header, &offset);
+    config.right_ascension              = read_header_value<double>(header, &offset);
+    config.initial_argument_of_latitude = read_header_value<double>(header, &offset);
+    config.epoch                        = read_header_value<double>(header, &offset);
+    config.grid_step                    = timestamp::from_microseconds(table->step);
+    config.table_path                   = path;
+
+    if ((0 == table->step) || (2 > table->num_samples) || (max_table_samples < table->num_samples) ||
+        (size != table_header_size + table->num_samples * values_per_sample * sizeof(float)))
+    {
+        throw invalid_environment_table(std::string(path + " is truncated or corrupt.").c_str());
+    }
+
+    table->inverse_step = 1.0f / static_cast<float>(table->step);
+    table->values       = reinterpret_cast<const float*>(header + table_header_size);
+    return table;
+}
+
+std::shared_ptr<const EnvironmentTable> EnvironmentTable::load(const environment_config &config, timestamp duration)
+{
+    std::shared_ptr<const EnvironmentTable> table = config.table_path.empty() ? build(config, duration) : map(config.table_path);
+
+    if (table->get_duration() < duration)
+    {
+        throw invalid_environment_table(std::string("The environment table " + config.table_path + " covers " +
+                                                    std::to_string(table->get_duration().to_seconds()) + " s, the run needs " +
+                                                    std::to_string(duration.to_seconds()) + " s.").c_str());
+    }
+
+    return table;
+}
+
+void EnvironmentTable::write(const std::string &path) const
+{
+    const std::filesystem::path table_path(path);
+    if (table_path.has_parent_path())
+    {
+        std::filesystem::create_directories(table_path.parent_path());
+    }
+
+    const std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            throw invalid_environment_table(std::string("Unable to open file " + temporary_path).c_str());
+        }
+
+        const auto value = [&file](const auto &v)
+        {
+            file.write(reinterpret_cast<const char*>(&v), sizeof(v));
+        };
+
+        file.write(magic, sizeof(magic));
+        value(format_version);
+        value(values_per_sample);
+        value(this->step);
+        value(this->num_samples);
+        value(this->config.altitude);
+        value(this->config.inclination);
+        value(this->config.right_ascension);
+        value(this->config.initial_argument_of_latitude);
+        value(this->config.epoch);
+        file.write(reinterpret_cast<const char*>(this->values), this->num_samples * values_per_sample * sizeof(float));
+
+        if (!file.good())
+        {
+            throw invalid_environment_table(std::string("Unable to write file " + temporary_path).c_str());
+        }
+    }
+
+    std::filesystem::rename(temporary_path, path);
+}
+
+EnvironmentTable::~EnvironmentTable()
+{
+    if (nullptr != this->mapping)
+    {
+        munmap(this->mapping, this->mapping_size);
+    }
+}
+
+environment_sample EnvironmentTable::sample_at(uint64_t index) const
+{
+    const float *v = this->values + index * values_per_sample;
+
+    environment_sample s;
+    s.position       = Eigen::Vector3f(v[0], v[1], v[2]);
+    s.magnetic_field = Eigen::Vector3f(v[3], v[4], v[5]);
+    s.sun_direction  = Eigen::Vector3f(v[6], v[7], v[8]).normalized();
+    s.sun_irradiance = v[9];
+    return s;
+}
@@ -0,0 +1,301 @@
+/**
+ * @file    ExecutionPacer.cpp
+ *
+ * @details This file implements the ExecutionPacer class as defined in ExecutionPacer.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ExecutionPacer.hpp"
+
+namespace
+{
+    /* Longest the tick thread waits for input before checking if it should stop, in ms */
+    const int tick_poll_timeout_ms = 100;
+
+    /**
+     * @name    to_us
+     *
+     * @returns the duration in us.
+    **/
+    double to_us(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    }
+}
+
+ExecutionPacer::ExecutionPacer(ExecutionMode mode, double real_time_factor) : mode(mode), real_time_factor(real_time_factor)
+{
+    if (!(0 < real_time_factor) || !std::isfinite(real_time_factor))
+    {
+        throw invalid_execution_mode("The real time factor must be a positive number.");
+    }
+}
+
+ExecutionPacer::~ExecutionPacer()
+{
+    this->stop();
+}
+
+void ExecutionPacer::begin(timestamp simulation_time)
+{
+    this->start_wall       = clock::now();
+    this->start_simulation = simulation_time;
+    this->last_deadline    = this->start_wall;
+    this->last_simulation  = simulation_time;
+
+    this->paced_steps   = 0;
+    this->overruns      = 0;
+    this->max_overrun   = std::chrono::nanoseconds(0);
+    this->max_jitter    = std::chrono::nanoseconds(0);
+    this->jitter_sum    = 0;
+    this->jitter_sum_sq = 0;
+
+    std::lock_guard<std::mutex> lock(this->tick_mutex);
+    this->granted   = simulation_time;
+    this->released  = false;
+    this->ticks     = 0;
+    this->tick_wait = std::chrono::nanoseconds(0);
+}
+
+timestamp ExecutionPacer::limit(timestamp simulation_time)
+{
+    if (ExecutionMode::Lockstep != this->mode)
+    {
+        return unlimited;
+    }
+
+    std::unique_lock<std::mutex> lock(this->tick_mutex);
+    if (!this->released && (this->granted <= simulation_time))
+    {
+        const clock::time_point wait_start = clock::now();
+        this->tick_received.wait(lock, [&]() { return this->released || (simulation_time < this->granted); });
+        this->tick_wait += clock::now() - wait_start;
+    }
+
+    return this->released ? unlimited : this->granted;
+}
+
+void ExecutionPacer::pace(timestamp simulation_time)
+{
+    this->last_simulation = simulation_time;
+    if (ExecutionMode::Paced != this->mode)
+    {
+        return;
+    }
+
+    const double wall_us = (simulation_time - this->start_simulation).microseconds() / this->real_time_factor;
+    const clock::time_point deadline = this->start_wall + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::micro>(wall_us));
+    if (deadline - this->last_deadline < min_pace_interval)
+    {
+        return;
+    }
+    this->last_deadline = deadline;
+    this->paced_steps++;
+
+    const clock::time_point now = clock::now();
+    if (deadline < now)
+    {
+        this->overruns++;
+        this->max_overrun = std::max(this->max_overrun, std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline));
+        return;
+    }
+
+    std::this_thread::sleep_until(deadline);
+
+    const std::chrono::nanoseconds jitter = clock::now() - deadline;
+    const double jitter_ns = jitter.count();
+    this->max_jitter     = std::max(this->max_jitter, jitter);
+    this->jitter_sum    += jitter_ns;
+    this->jitter_sum_sq += jitter_ns * jitter_ns;
+}
+
+void ExecutionPacer::tick(timestamp duration)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->tick_mutex);
+        this->granted += duration;
+        this->ticks++;
+    }
+    this->tick_received.notify_all();
+}
+
+void ExecutionPacer::release()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->tick_mutex);
+        this->released = true;
+    }
+    this->tick_received.notify_all();
+}
+
+void ExecutionPacer::read_ticks(const std::string &path)
+{
+    this->join_tick_thread();
+
+    /* A pipe is opened for writing as well, so it is not closed when a writer disconnects */
+    struct stat file_info;
+    const bool is_pipe = (0 == ::stat(path.c_str(), &file_info)) && S_ISFIFO(file_info.st_mode);
+    const int fd = ::open(path.c_str(), (is_pipe ? O_RDWR : O_RDONLY) | O_NONBLOCK);
+    if (0 > fd)
+    {
+        throw invalid_execution_mode(std::string("Unable to open tick file " + path).c_str());
+    }
+
+    this->stopping    = false;
+    this->tick_thread = std::thread(&ExecutionPacer::tick_reader, this, fd);
+}
+
+void ExecutionPacer::stop()
+{
+    this->join_tick_thread();
+    this->release();
+}
+
+void ExecutionPacer::join_tick_thread()
+{
+    this->stopping = true;
+    if (this->tick_thread.joinable())
+    {
+        this->tick_thread.join();
+    }
+}
+
+void ExecutionPacer::tick_reader(int fd)
+{
+    std::string line;
+    char buffer[256];
+    bool done = false;
+
+    while (!done && !this->stopping)
+    {
+        struct pollfd request = {fd, POLLIN, 0};
+        if (0 >= ::poll(&request, 1, tick_poll_timeout_ms))
+        {
+            continue;
+        }
+
+        const ssize_t length = ::read(fd, buffer, sizeof(buffer));
+        if (0 >= length)
+        {
+            /* The end of a regular file, or an error */
+            done = (0 == length) || ((EAGAIN != errno) && (EINTR != errno));
+            continue;
+        }
+
+        for (ssize_t i = 0; (i < length) && !done; i++)
+        {
+            if ('\n' != buffer[i])
+            {
+                line.push_back(buffer[i]);
+                continue;
+            }
+
+            if ("end" == line)
+            {
+                done = true;
+            }
+            else if (!line.empty())
+            {
+                try
+                {
+                    const double milliseconds = std::stod(line);
+                    if (0 < milliseconds)
+                    {
+                        this->tick(timestamp::from_microseconds(std::llround(milliseconds * 1000)));
+                    }
+                }
+                catch (std::exception &)
+                {
+                    /* Lines that are not a number are ignored */
+                }
+            }
+            line.clear();
+        }
+    }
+
+    ::close(fd);
+    this->release();
+}
+
+pacing_stats ExecutionPacer::get_stats() const
+{
+    pacing_stats stats = {};
+    stats.paced_steps    = this->paced_steps;
+    stats.overruns       = this->overruns;
+    stats.max_overrun    = this->max_overrun;
+    stats.max_jitter     = this->max_jitter;
+    stats.simulated_time = this->last_simulation - this->start_simulation;
+    stats.wall_time      = clock::now() - this->start_wall;
+
+    const uint64_t on_time = this->paced_steps - this->overruns;
+    if (0 < on_time)
+    {
+        const double mean     = this->jitter_sum / on_time;
+        const double variance = std::max(0.0, (this->jitter_sum_sq / on_time) - (mean * mean));
+        stats.mean_jitter   = std::chrono::nanoseconds(std::llround(mean));
+        stats.jitter_stddev = std::chrono::nanoseconds(std::llround(std::sqrt(variance)));
+    }
+
+    std::lock_guard<std::mutex> lock(this->tick_mutex);
+    stats.ticks     = this->ticks;
+    stats.tick_wait = this->tick_wait;
+
+    return stats;
+}
+
+std::string ExecutionPacer::summary() const
+{
+    const pacing_stats stats = this->get_stats();
+    const double wall_seconds = std::chrono::duration<double>(stats.wall_time).count();
+
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(3);
+    text << mode_name(this->mode) << " execution: " << stats.simulated_time.to_seconds() << " s simulated in "
+         << wall_seconds << " s";
+    if (0 < wall_seconds)
+    {
+        text << " (" << (stats.simulated_time.to_seconds() / wall_seconds) << "x real time)";
+    }
+    text << "\n";
+
+    if (ExecutionMode::Paced == this->mode)
+    {
+        text << "target " << this->real_time_factor << "x real time, " << stats.paced_steps << " paced steps, "
+             << stats.overruns << " overruns (max " << to_us(stats.max_overrun) << " us late)\n";
+        text << "wake up jitter: mean " << to_us(stats.mean_jitter) << " us, stddev " << to_us(stats.jitter_stddev)
+             << " us, max " << to_us(stats.max_jitter) << " us\n";
+    }
+    else if (ExecutionMode::Lockstep == this->mode)
+    {
+        text << stats.ticks << " ticks received, " << (to_us(stats.tick_wait) / 1000) << " ms spent waiting for ticks\n";
+    }
+
+    return text.str();
+}
+
+const char *ExecutionPacer::mode_name(ExecutionMode mode)
+{
+    switch (mode)
+    {
+        case ExecutionMode::AsFastAsPossible: return "As fast as possible";
+        case ExecutionMode::Paced:            return "Paced";
+        case ExecutionMode::Lockstep:         return "Lockstep";
+        default:                              return "unknown";
+    }
+}
@@ -0,0 +1,402 @@
+/**
+ * @file    GainTuner.cpp
+ *
+ * @details This file implements the GainTuner class as defined in GainTuner.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "GainTuner.hpp"
+
+namespace
+{
+    /* Number of values of each parameter of a grid if the yaml does not set one */
+    const uint32_t default_grid_steps = 5;
+
+    /* First step of the compass search, as a fraction of the range of each parameter */
+    const float initial_compass_step = 0.25;
+
+    /* The compass search stops once its step is below this fraction of the range of each parameter */
+    const float min_compass_step = 1.0 / 64;
+}
+
+GainTuner::GainTuner(const std::string &tuning_yaml_path, Messenger *messenger) : messenger(messenger)
+{
+    try
+    {
+        YAML::Node tuning = YAML::LoadFile(tuning_yaml_path);
+
+        if (!tuning["ExitConfig"])
+        {
+            throw invalid_tuning_spec("Tuning yaml needs an ExitConfig, the candidates are scored on how the controller reaches it.");
+        }
+
+        /* These are the same for each batch, see BatchRunner.hpp */
+        batch_base                = YAML::Node(YAML::NodeType::Map);
+        batch_base["BaseConfig"]  = tuning["BaseConfig"].as<std::string>();
+        batch_base["ExitConfig"]  = tuning["ExitConfig"].as<std::string>();
+        batch_base["SameNoise"]   = true;
+        for (const std::string key : {"Checkpoint", "Threads", "SettleTolerance"})
+        {
+            if (tuning[key])
+            {
+                batch_base[key] = tuning[key];
+            }
+        }
+
+        output_path = tuning["Output"] ? tuning["Output"].as<std::string>() : get_default_output_path();
+        rounds      = tuning["Rounds"] ? tuning["Rounds"].as<uint32_t>()    : rounds;
+
+        const std::string search_name = tuning["Search"] ? tuning["Search"].as<std::string>() : "Grid";
+        if ("Grid" == search_name)
+        {
+            search = Search::Grid;
+        }
+        else if ("Compass" == search_name)
+        {
+            search = Search::Compass;
+        }
+        else
+        {
+            throw invalid_tuning_spec(std::string("Unknown search: " + search_name).c_str());
+        }
+
+        const YAML::Node cost = tuning["Cost"];
+        if (cost)
+        {
+            weights.settle_time = cost["SettleTime"] ? cost["SettleTime"].as<float>() : weights.settle_time;
+            weights.overshoot   = cost["Overshoot"]  ? cost["Overshoot"].as<float>()  : weights.overshoot;
+            weights.saturation  = cost["Saturation"] ? cost["Saturation"].as<float>() : weights.saturation;
+            weights.unsettled   = cost["Unsettled"]  ? cost["Unsettled"].as<float>()  : weights.unsettled;
+        }
+
+        for (const YAML::Node &p : tuning["Parameters"])
+        {
+            tuning_parameter parameter;
+            parameter.path  = p["Path"].as<std::string>();
+            parameter.min   = p["Min"].as<float>();
+            parameter.max   = p["Max"].as<float>();
+            parameter.steps = p["Steps"] ? p["Steps"].as<uint32_t>() : default_grid_steps;
+            parameter.log   = p["Log"]   ? p["Log"].as<bool>()       : false;
+            parameter.scale = p["Scale"] ? p["Scale"].as<bool>()     : false;
+
+            if (!(parameter.min < parameter.max))
+            {
+                throw invalid_tuning_spec(std::string("Parameter " + parameter.path + " needs a Min below its Max.").c_str());
+            }
+            if (parameter.log && !(0 < parameter.min))
+            {
+                throw invalid_tuning_spec(std::string("Parameter " + parameter.path + " needs a positive Min to be Log spaced.").c_str());
+            }
+            if (0 == parameter.steps)
+            {
+                throw invalid_tuning_spec(std::string("Parameter " + parameter.path + " needs at least one Step.").c_str());
+            }
+
+            parameter.initial = p["Initial"] ? p["Initial"].as<float>() : to_value(parameter, 0.5);
+            if ((parameter.initial < parameter.min) || (parameter.max < parameter.initial))
+            {
+                throw invalid_tuning_spec(std::string("The Initial value of parameter " + parameter.path + " is outside its range.").c_str());
+            }
+
+            parameters.push_back(parameter);
+        }
+    }
+    catch (YAML::Exception &e)
+    {
+        throw invalid_tuning_spec(std::string("Invalid tuning yaml " + tuning_yaml_path + ": " + e.what()).c_str());
+    }
+
+    if (parameters.empty())
+    {
+        throw invalid_tuning_spec("Tuning yaml must have at least one parameter.");
+    }
+}
+
+void GainTuner::run()
+{
+    this->evaluations.clear();
+    this->evaluated.clear();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (Search::Grid == this->search)
+    {
+        this->grid_search();
+    }
+    else
+    {
+        this->compass_search();
+    }
+
+    const float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+    this->write_results();
+
+    const auto best = std::min_element(this->evaluations.begin(), this->evaluations.end(), [](const evaluation &a, const evaluation &b)
+    {
+        return a.cost < b.cost;
+    });
+
+    std::stringstream summary;
+    summary << "Tuning finished in " << seconds << " s, " << this->evaluations.size() << " candidates. Results written to " << this->output_path;
+    messenger->send_message(summary.str(), text_colour.green);
+
+    if ((this->evaluations.end() == best) || std::isinf(best->cost))
+    {
+        messenger->send_warning("No candidate completed its run.");
+        return;
+    }
+
+    std::stringstream msg;
+    msg << "Best candidate, cost " << best->cost << ":";
+    for (size_t i = 0; i < this->parameters.size(); i++)
+    {
+        msg << " " << this->parameters.at(i).path << " = " << best->values.at(i);
+    }
+    msg << "\n" << (best->result.settled ? "Settled at " : "Not settled by ") << (best->result.settled ? best->result.settle_time : best->result.end_time);
+    msg << " s, with " << best->result.overshoot << " rad of overshoot and a peak wheel speed of ";
+    msg << best->result.peak_wheel_saturation << " of the max.";
+    messenger->send_message(msg.str(), text_colour.green);
+
+    return;
+}
+
+void GainTuner::grid_search()
+{
+    size_t num_points = 1;
+    for (const tuning_parameter &parameter : this->parameters)
+    {
+        num_points *= parameter.steps;
+    }
+
+    messenger->send_message("Tuning " + std::to_string(this->parameters.size()) + " parameters on a grid of " +
+                            std::to_string(num_points) + " candidates.", text_colour.cyan);
+
+    /* Point i counts through the steps of each parameter like the digits of a number */
+    std::vector<std::vector<float>> points;
+    for (size_t i = 0; i < num_points; i++)
+    {
+        std::vector<float> point;
+        size_t remainder = i;
+        for (const tuning_parameter &parameter : this->parameters)
+        {
+            const uint32_t step = remainder % parameter.steps;
+            remainder /= parameter.steps;
+
+            if (1 == parameter.steps)
+            {
+                point.push_back(to_position(parameter, parameter.initial));
+            }
+            else
+            {
+                point.push_back(static_cast<float>(step) / (parameter.steps - 1));
+            }
+        }
+        points.push_back(point);
+    }
+
+    this->evaluate(0, points);
+}
+
+void GainTuner::compass_search()
+{
+    messenger->send_message("Tuning " + std::to_string(this->parameters.size()) + " parameters with a compass search of up to " +
+                            std::to_string(this->rounds) + " rounds.", text_colour.cyan);
+
+    std::vector<float> start;
+    for (const tuning_parameter &parameter : this->parameters)
+    {
+        start.push_back(to_position(parameter, parameter.initial));
+    }
+
+    size_t best = this->evaluate(0, {start});
+    float  step = initial_compass_step;
+
+    for (uint32_t round = 1; (round <= this->rounds) && (min_compass_step <= step); round++)
+    {
+        const std::vector<float> centre = this->evaluations.at(best).point;
+
+        std::vector<std::vector<float>> points;
+        for (size_t i = 0; i < centre.size(); i++)
+        {
+            for (const float direction : {-1.0f, 1.0f})
+            {
+                std::vector<float> point = centre;
+                point.at(i) = std::clamp(centre.at(i) + direction * step, 0.0f, 1.0f);
+                if (point != centre)
+                {
+                    points.push_back(point);
+                }
+            }
+        }
+
+        const size_t candidate = this->evaluate(round, points);
+        if (this->evaluations.at(candidate).cost < this->evaluations.at(best).cost)
+        {
+            best = candidate;
+        }
+        else
+        {
+            step /= 2;
+        }
+
+        std::stringstream msg;
+        msg << "Round " << round << ": best cost " << this->evaluations.at(best).cost << ", step " << step << ".";
+        messenger->send_message(msg.str());
+    }
+}
+
+size_t GainTuner::evaluate(uint32_t round, const std::vector<std::vector<float>> &points)
+{
+    /* Candidates already run are not run again */
+    std::vector<std::vector<float>> new_points;
+    for (const std::vector<float> &point : points)
+    {
+        if ((this->evaluated.end() == this->evaluated.find(point)) &&
+            (new_points.end() == std::find(new_points.begin(), new_points.end(), point)))
+        {
+            new_points.push_back(point);
+        }
+    }
+
+    if (!new_points.empty())
+    {
+        YAML::Node sweep = YAML::Clone(this->batch_base);
+        sweep["Runs"]    = new_points.size();
+        sweep["Output"]  = "none";
+
+        YAML::Node sweep_parameters(YAML::NodeType::Sequence);
+        for (size_t j = 0; j < this->parameters.size(); j++)
+        {
+            const tuning_parameter &parameter = this->parameters.at(j);
+
+            YAML::Node values(YAML::NodeType::Sequence);
+            for (const std::vector<float> &point : new_points)
+            {
+                values.push_back(to_value(parameter, point.at(j)));
+            }
+
+            YAML::Node sweep_parameter;
+            sweep_parameter["Path"]         = parameter.path;
+            sweep_parameter["Distribution"] = "Values";
+            sweep_parameter["Values"]       = values;
+            sweep_parameter["Scale"]        = parameter.scale;
+            sweep_parameters.push_back(sweep_parameter);
+        }
+        sweep["Parameters"] = sweep_parameters;
+
+        BatchRunner batch(sweep, this->messenger);
+        batch.run();
+
+        const std::vector<BatchRunner::run_result> &results = batch.get_results();
+        for (size_t i = 0; i < new_points.size(); i++)
+        {
+            evaluation candidate;
+            candidate.round  = round;
+            candidate.point  = new_points.at(i);
+            candidate.result = results.at(i);
+            candidate.cost   = this->cost(candidate.result);
+            for (size_t j = 0; j < this->parameters.size(); j++)
+            {
+                candidate.values.push_back(to_value(this->parameters.at(j), candidate.point.at(j)));
+            }
+
+            this->evaluated[candidate.point] = this->evaluations.size();
+            this->evaluations.push_back(candidate);
+        }
+    }
+
+    size_t best = this->evaluated.at(points.front());
+    for (const std::vector<float> &point : points)
+    {
+        const size_t index = this->evaluated.at(point);
+        if (this->evaluations.at(index).cost < this->evaluations.at(best).cost)
+        {
+            best = index;
+        }
+    }
+
+    return best;
+}
+
+float GainTuner::to_value(const tuning_parameter &parameter, float position) const
+{
+    if (parameter.log)
+    {
+        return parameter.min * std::pow(parameter.max / parameter.min, position);
+    }
+    return parameter.min + position * (parameter.max - parameter.min);
+}
+
+float GainTuner::to_position(const tuning_parameter &parameter, float value) const
+{
+    if (parameter.log)
+    {
+        return std::log(value / parameter.min) / std::log(parameter.max / parameter.min);
+    }
+    return (value - parameter.min) / (parameter.max - parameter.min);
+}
+
+float GainTuner::cost(const BatchRunner::run_result &result) const
+{
+    if (!result.completed)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    const float time = result.settled ? result.settle_time : result.end_time;
+    return this->weights.settle_time * time +
+           this->weights.overshoot   * result.overshoot +
+           this->weights.saturation  * result.peak_wheel_saturation +
+           (result.settled ? 0 : this->weights.unsettled);
+}
+
+void GainTuner::write_results()
+{
+    std::filesystem::path path(this->output_path);
+    if (path.has_parent_path() && !std::filesystem::exists(path.parent_path()))
+    {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    std::ofstream results(this->output_path, std::fstream::out | std::fstream::trunc);
+    if (!results.is_open())
+    {
+        throw invalid_tuning_spec(std::string("Unable to open file " + this->output_path).c_str());
+    }
+
+    results << "Round,";
+    for (const tuning_parameter &parameter : this->parameters)
+    {
+        results << parameter.path << ",";
+    }
+    results << "Completed,Settled,Settle time,Overshoot,Peak wheel saturation,End time,Cost" << std::endl;
+
+    for (const evaluation &candidate : this->evaluations)
+    {
+        results << candidate.round << ",";
+        for (const float value : candidate.values)
+        {
+            results << value << ",";
+        }
+        results << candidate.result.completed << "," << candidate.result.settled << "," << candidate.result.settle_time << ",";
+        results << candidate.result.overshoot << "," << candidate.result.peak_wheel_saturation << ",";
+        results << candidate.result.end_time << "," << candidate.cost << std::endl;
+    }
+
+    results.close();
+    return;
+}
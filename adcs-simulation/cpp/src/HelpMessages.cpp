@@ -20,6 +20,9 @@ namespace HelpMessages
             "simulations, plot the results, and run various other tests:\n" +
             text_colour.yellow + 
             "    start_sim <config_yaml> <exit_yaml>\n"
+            "    batch_sim <sweep_yaml>\n"
+            "    tune_gains <tuning_yaml>\n"
+            "    build_env <config_yaml> <table_path>\n"
             "    resume_sim\n"
             "    exit\n"
             "    clean_out\n"
@@ -131,17 +134,100 @@ namespace HelpMessages
             "    --print_rate <rate> " + text_colour.reset  + "sets the terminal print rate to the supplied rate in ms.\n"
             "      shorthand: "        + text_colour.yellow + "-p\n"
             "    --silence_plots     " + text_colour.reset  + "prevents the simulation from printing to the output csv.\n"
-            "      shorthand: "        + text_colour.yellow + "-sp\n" +
+            "      shorthand: "        + text_colour.yellow + "-sp\n"
+            "    --run_to_timeout    " + text_colour.reset  + "keeps running until the timeout after the satellite has held the target of\n"
+            "                        the exit yaml for its HoldTime. Runs end as soon as it has otherwise.\n"
+            "      shorthand: "        + text_colour.yellow + "-rto\n"
+            "    --binary            " + text_colour.reset  + "writes the output as a binary trajectory file (.bin) that is streamed to\n"
+            "                        disk during the run, instead of a csv held in memory. Use this for long runs.\n"
+            "      shorthand: "        + text_colour.yellow + "-b\n"
+            "    --drop_telemetry    " + text_colour.reset  + "drops output samples (and reports how many) instead of pausing the simulation\n"
+            "                        when the output writer falls behind.\n"
+            "      shorthand: "        + text_colour.yellow + "-dt\n"
+            "    --shared_memory <name> " + text_colour.reset + "publishes the state of every timestep to a POSIX shared memory\n"
+            "                        ring, eg for a visualizer or hardware in the loop rig. See inc/SharedTelemetry.hpp.\n"
+            "      shorthand: "        + text_colour.yellow + "-shm\n"
+            "    --trace <path>      " + text_colour.reset  + "writes every profiled scope of the run to a Chrome trace json at the path,\n"
+            "                        for chrome://tracing or ui.perfetto.dev. Needs a build with -DADCS_PROFILING=ON.\n"
+            "      shorthand: "        + text_colour.yellow + "-tr\n"
+            "    --paced <factor>    " + text_colour.reset  + "holds the simulation to <factor> times real time, eg 1 for hardware in the\n"
+            "                        loop, and reports the wake up jitter and overruns. Runs are as fast as possible otherwise.\n"
+            "      shorthand: "        + text_colour.yellow + "-rt\n"
+            "    --lockstep <ticks>  " + text_colour.reset  + "only simulates as far as the ticks read from the file or named pipe allow.\n"
+            "                        Each line is a number of ms to advance, and a line \"end\" releases the simulation.\n"
+            "      shorthand: "        + text_colour.yellow + "-ls\n"
+            "    --checkpoint <path> " + text_colour.reset  + "writes the checkpoint used by resume_sim to the path instead of\n"
+            "                        output/sim_checkpoint.ckpt. \"none\" writes no checkpoint.\n"
+            "      shorthand: "        + text_colour.yellow + "-ck\n"
+            "    --checkpoint_rate <rate> " + text_colour.reset + "also writes the checkpoint every <rate> ms of simulation time, not only\n"
+            "                        when the run ends.\n"
+            "      shorthand: "        + text_colour.yellow + "-cr\n" +
             text_colour.reset
         };
 
+        std::string batch_sim_help =
+        {
+            text_colour.yellow + 
+            "batch_sim " + text_colour.reset + "(shorthand: " + text_colour.yellow + "bs" + text_colour.reset + ")\n\n"
+            "Runs many independent simulations in parallel, one per core, and writes one summary row per run\n"
+            "(settle time, final error, peak wheel speed) to " + text_colour.yellow + "output/batch_summary.csv" + text_colour.reset + ".\n"
+            "The same sweep can be run without the terminal with " + text_colour.yellow + "./bin/simulator --batch <sweep_yaml>\n\n" +
+            text_colour.reset +
+            "Mandatory arguments:\n" +
+            text_colour.yellow +
+            "    <sweep_yaml>     " + text_colour.reset + "The path to the sweep yaml. This yaml names a base config yaml and exit yaml,\n"
+            "                     the number of runs, and the parameters to vary between runs. For an example, see\n"
+            "                     unit_tests/batch/example_sweep.yaml.\n"
+        };
+
+        std::string tune_gains_help =
+        {
+            text_colour.yellow + 
+            "tune_gains " + text_colour.reset + "(shorthand: " + text_colour.yellow + "tg" + text_colour.reset + ")\n\n"
+            "Searches for the controller gains, or any other parameters of a config yaml, with the lowest cost of\n"
+            "settle time, overshoot and reaction wheel saturation. The candidates of each round run in parallel as a\n"
+            "batch, each ending as soon as it holds the target of the exit yaml, and one row per candidate is written\n"
+            "to " + text_colour.yellow + "output/tuning_results.csv" + text_colour.reset + ". The same search can be run without the terminal with\n" +
+            text_colour.yellow + "./bin/simulator --tune <tuning_yaml>\n\n" +
+            text_colour.reset +
+            "Mandatory arguments:\n" +
+            text_colour.yellow +
+            "    <tuning_yaml>    " + text_colour.reset + "The path to the tuning yaml. This yaml names a base config yaml and exit yaml,\n"
+            "                     the search, the cost weights, and the range of each parameter. For an example, see\n"
+            "                     unit_tests/batch/example_tuning.yaml.\n"
+        };
+
+        std::string build_env_help =
+        {
+            text_colour.yellow + 
+            "build_env " + text_colour.reset + "(shorthand: " + text_colour.yellow + "be" + text_colour.reset + ")\n\n"
+            "Evaluates the orbit, magnetic field and sun models of the Environment section of a config yaml over\n"
+            "its timeout, and writes them as a table file. A config whose Environment section names the table\n"
+            "with " + text_colour.yellow + "Table: <table_path>" + text_colour.reset + " memory maps it instead of evaluating the models again, so\n"
+            "every run and batch sweep of the same orbit shares one read-only copy.\n\n"
+            "Mandatory arguments:\n" +
+            text_colour.yellow +
+            "    <config_yaml>    " + text_colour.reset + "The path to a config yaml with an Environment section.\n" +
+            text_colour.yellow +
+            "    <table_path>     " + text_colour.reset + "The path of the table file to write.\n"
+        };
+
         std::string resume_sim_help =
         {
             text_colour.yellow + 
-            "resume_sim " + text_colour.reset + "(shorthand: " + text_colour.yellow + "rs" + text_colour.reset + ")\n\n" +
-            text_colour.red + 
-            "NOT IMPLEMENTED\n" +
-            text_colour.reset
+            "resume_sim " + text_colour.reset + "(shorthand: " + text_colour.yellow + "rs" + text_colour.reset + ")\n\n"
+            "Continues a simulation from a checkpoint, with the same clock, satellite state, device poll times and\n"
+            "controller state it was saved with. The timeout of the exit yaml counts from the checkpoint time.\n"
+            "With no arguments, the checkpoint of the last start_sim or resume_sim is resumed with the same yamls.\n\n"
+            "Optional arguments:\n" +
+            text_colour.yellow +
+            "    <checkpoint>     " + text_colour.reset + "The path to a checkpoint written by start_sim.\n" +
+            text_colour.yellow +
+            "    <config_yaml>    " + text_colour.reset + "The config yaml the checkpoint was made with. Required with <checkpoint>.\n" +
+            text_colour.yellow +
+            "    <exit_yaml>      " + text_colour.reset + "The exit yaml to continue with.\n"
+            "Flags:\n"
+            "    Every start_sim flag is accepted.\n"
         };
 
         std::string exit_help =
@@ -165,12 +251,15 @@ namespace HelpMessages
             "unit_test " + text_colour.reset + "(shorthand: " + text_colour.yellow + "ut" + text_colour.reset + ")\n\n"
             "Runs a predefined set of tests to ensure the simulation is working properly. The first 6 are\n"
             "scenarios that have been calculated analytically. The results are compared against the exptected\n"
-            "results and a pass/fail is assigned. The last three tests use the controller, in the following three\n"
+            "results and a pass/fail is assigned. The last four tests use the controller, in the following four\n"
             "scenarios:\n"
             "    1. The satellite is given an initial state of rest, and is asked to stay in that state for 600\n"
             "       seconds\n"
             "    2. The satellite is given an initial velocity, and is asked to return to it's original state.\n"
-            "    3. The satellite is at rest, and is requested to change attidue by around 30 degrees.\n\n"
+            "    3. The satellite is at rest, and is requested to change attidue by around 30 degrees.\n"
+            "    4. The same change of attitude with five reaction wheels, one of which polls slower than the\n"
+            "       controller runs.\n\n"
+            "The tests of each group run in parallel, and the first 6 stop as soon as they pass or fail.\n\n"
             "The output directory and plotting directories are cleared before running the tests, so make sure to\n"
             "save any results you want before running this test.\n"
         };
@@ -180,8 +269,10 @@ namespace HelpMessages
             text_colour.yellow + 
             "perf_test " + text_colour.reset + "(shorthand: " + text_colour.yellow + "pt" + text_colour.reset + ")\n\n"
             "Runs a predefined set of tests in order to benchmark the efficiency of the simulator. Three tests\n"
-            "are run ten times each and their run time is then averaged and displayed to the user. This should be\n"
-            "used to determine how changes to the simulator effect efficiency.\n\n"
+            "are run twice to warm up, then timed ten times each. The median, 95th percentile and standard\n"
+            "deviation of the setup, physics, controller and I/O time are displayed to the user and written to\n"
+            "output/benchmark.json. This should be used to determine how changes to the simulator effect\n"
+            "efficiency. The same benchmark can be run without the terminal with ./bin/benchmark.\n\n"
             "The output directory and plotting directories are cleared before running the tests, so make sure to\n"
             "save any results you want before running this test.\n"
         };
@@ -197,6 +288,9 @@ namespace HelpMessages
         std::unordered_map<std::string, std::string> command_to_help_map = 
         {
             {"start_sim",   start_sim_help},
+            {"batch_sim",   batch_sim_help},
+            {"tune_gains",  tune_gains_help},
+            {"build_env",   build_env_help},
             {"resume_sim",  resume_sim_help},
             {"exit",        exit_help},
             {"clean_out",   clean_out_help},
@@ -205,6 +299,9 @@ namespace HelpMessages
             {"clean_plots", clean_plots_help},
 
             {"ss",  start_sim_help},
+            {"bs",  batch_sim_help},
+            {"tg",  tune_gains_help},
+            {"be",  build_env_help},
             {"rs",  resume_sim_help},
             {"q",   exit_help},
             {"co",  clean_out_help},
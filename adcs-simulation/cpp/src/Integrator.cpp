@@ -0,0 +1,117 @@
+/**
+ * @file Integrator.cpp
+ *
+ * @details implements the integrators as defined in Integrator.hpp
+ *
+ * @authors Lily de Loe, Justin Paoli, Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+
+#include "Integrator.hpp"
+
+float EulerIntegrator::step(const rigid_body_dynamics &dynamics, float dt, Satellite *satellite)
+{
+    satellite->alpha_b = body_acceleration(dynamics, 0, satellite->omega_b);
+
+    satellite->omega_b += satellite->alpha_b * dt;
+    satellite->theta_b += satellite->omega_b * dt;
+
+    return 0;
+}
+
+float RK4Integrator::step(const rigid_body_dynamics &dynamics, float dt, Satellite *satellite)
+{
+    const Eigen::Vector3f omega = satellite->omega_b;
+
+    /* The body acceleration does not depend on position, so each stage only needs a velocity. */
+    Eigen::Vector3f k1 = body_acceleration(dynamics, 0,      omega);
+    Eigen::Vector3f w2 = omega + k1 * (dt / 2);
+    Eigen::Vector3f k2 = body_acceleration(dynamics, dt / 2, w2);
+    Eigen::Vector3f w3 = omega + k2 * (dt / 2);
+    Eigen::Vector3f k3 = body_acceleration(dynamics, dt / 2, w3);
+    Eigen::Vector3f w4 = omega + k3 * dt;
+    Eigen::Vector3f k4 = body_acceleration(dynamics, dt,     w4);
+
+    satellite->alpha_b  = k1;
+    satellite->theta_b += (omega + 2 * w2 + 2 * w3 + w4) * (dt / 6);
+    satellite->omega_b += (k1 + 2 * k2 + 2 * k3 + k4) * (dt / 6);
+
+    return 0;
+}
+
+float DormandPrinceIntegrator::step(const rigid_body_dynamics &dynamics, float dt, Satellite *satellite)
+{
+    /* Butcher tableau for Dormand-Prince 5(4) */
+    static const float c[7] = {0, 1.0f/5, 3.0f/10, 4.0f/5, 8.0f/9, 1, 1};
+    static const float a[7][6] =
+    {
+        {0,               0,                0,               0,             0,                0},
+        {1.0f/5,          0,                0,               0,             0,                0},
+        {3.0f/40,         9.0f/40,          0,               0,             0,                0},
+        {44.0f/45,        -56.0f/15,        32.0f/9,         0,             0,                0},
+        {19372.0f/6561,   -25360.0f/2187,   64448.0f/6561,   -212.0f/729,   0,                0},
+        {9017.0f/3168,    -355.0f/33,       46732.0f/5247,   49.0f/176,     -5103.0f/18656,   0},
+        {35.0f/384,       0,                500.0f/1113,     125.0f/192,    -2187.0f/6784,    11.0f/84}
+    };
+    /* Difference between the fifth and fourth order weights */
+    static const float e[7] = {71.0f/57600, 0, -71.0f/16695, 71.0f/1920, -17253.0f/339200, 22.0f/525, -1.0f/40};
+
+    const Eigen::Vector3f omega = satellite->omega_b;
+
+    /* The body acceleration does not depend on position, so each stage only needs a velocity. */
+    Eigen::Vector3f w[7];
+    Eigen::Vector3f k[7];
+    for (int i = 0; i < 7; i++)
+    {
+        w[i] = omega;
+        for (int j = 0; j < i; j++)
+        {
+            w[i] += k[j] * (a[i][j] * dt);
+        }
+        k[i] = body_acceleration(dynamics, c[i] * dt, w[i]);
+    }
+
+    /* The last stage velocity is the fifth order velocity, and its weights are the fifth order weights */
+    Eigen::Vector3f theta_error = Eigen::Vector3f::Zero();
+    Eigen::Vector3f omega_error = Eigen::Vector3f::Zero();
+    for (int i = 0; i < 7; i++)
+    {
+        if (i < 6)
+        {
+            satellite->theta_b += w[i] * (a[6][i] * dt);
+        }
+        theta_error += w[i] * (e[i] * dt);
+        omega_error += k[i] * (e[i] * dt);
+    }
+
+    satellite->alpha_b = k[0];
+    satellite->omega_b = w[6];
+
+    /* A velocity error grows into a position error over the length of the step */
+    return std::max(theta_error.cwiseAbs().maxCoeff(), omega_error.cwiseAbs().maxCoeff() * dt);
+}
+
+std::unique_ptr<Integrator> make_integrator(IntegratorType type)
+{
+    std::unique_ptr<Integrator> ret;
+
+    switch (type)
+    {
+        case IntegratorType::Euler:
+            ret = std::make_unique<EulerIntegrator>();
+            break;
+        case IntegratorType::RK4:
+            ret = std::make_unique<RK4Integrator>();
+            break;
+        case IntegratorType::DormandPrince:
+            ret = std::make_unique<DormandPrinceIntegrator>();
+            break;
+    }
+
+    return ret;
+}
@@ -6,7 +6,7 @@
  * @authors Aidan Sheedy
  *
  * Last Edited
- * 2022-11-09
+ * 2026-10-14
  *
 **/
 
@@ -15,6 +15,7 @@
 #include <fstream>
 #include <filesystem>
 #include <tgmath.h>
+#include <algorithm>
 
 #include "Messenger.hpp"
 
@@ -26,6 +27,11 @@ void Messenger::send_message(std::string msg, std::string colour)
         throw invalid_message("Message to send to UI is empty.");
     }
 
+    if (silent_messages)
+    {
+        return;
+    }
+
     // This can be formatted nicely later.
     std::cout << colour << msg << text_colour.reset << std::endl;
     return;
@@ -39,6 +45,11 @@ void Messenger::send_warning(std::string msg)
         throw invalid_message("Warning to send to UI is empty.");
     }
 
+    if (silent_messages)
+    {
+        return;
+    }
+
     // This can be formatted nicely later.
     std::cout << text_colour.yellow << "WARNING: " << msg << text_colour.reset << std::endl;
     return;
@@ -58,20 +69,135 @@ void Messenger::send_error(std::string msg)
     return;
 }
 
+void Messenger::send_profile_summary(const Profiler &profiler)
+{
+    this->send_message(profiler.summary(), text_colour.cyan);
+    return;
+}
+
+Messenger::Messenger() : telemetry_queue(std::make_unique<telemetry_queue_t>()) {}
+
+Messenger::~Messenger()
+{
+    this->stop_writer();
+}
+
 void Messenger::start_new_sim(uint32_t num_reaction_wheels)
 {
+    /* Headers and files are set up by this thread, so any previous writer must be finished first. */
+    this->stop_writer();
+
+    this->stop_is_requested = false;
+    this->stop_reason.clear();
+
+    /**
+     * One omega and one alpha per wheel for each queue slot, plus one for samples written
+     * without the writer thread. Only reallocated if the run has more wheels than any before it.
+    **/
+    this->num_telemetry_wheels = num_reaction_wheels;
+    this->wheel_storage.resize((telemetry_queue_t::capacity() + 1) * 2 * num_reaction_wheels);
+
     if (!silent_sim_prints)
     {
         write_cout_header(num_reaction_wheels);
     }
     if (!silent_csv_prints)
     {
-        write_csv_header(num_reaction_wheels);
+        std::vector<std::string> columns = this->output_column_names(num_reaction_wheels);
+        this->output_row.assign(columns.size() - 1, 0);
+
+        if (OutputFormat::Binary == this->output_format)
+        {
+            /* The binary output is streamed, so its summary can be too */
+            this->output_file_path_string = this->next_output_file_path(this->binary_ext);
+            this->trajectory_writer.open(this->output_file_path_string, columns);
+            this->summary_writer.open(SummaryWriter::get_summary_path(this->output_file_path_string), columns);
+        }
+        else
+        {
+            /* The csv is only named when it is saved, so its summary is kept in memory until then */
+            write_csv_header(num_reaction_wheels);
+            this->summary_writer.open("", columns);
+        }
+    }
+
+    if (this->shared_memory_name.empty())
+    {
+        this->shared_telemetry.reset();
+    }
+    else
+    {
+        /* Readers stay attached to the same segment from one simulation to the next */
+        if (!this->shared_telemetry || (this->shared_telemetry->get_name() != this->shared_memory_name))
+        {
+            this->shared_telemetry.reset();
+            this->shared_telemetry = std::make_unique<SharedTelemetryPublisher>(this->shared_memory_name);
+        }
+        this->shared_telemetry->begin_run();
     }
 
+    /* A run with every output silenced has nothing for a writer to do. */
+    if (!silent_sim_prints || !silent_csv_prints)
+    {
+        this->start_writer();
+    }
+
+    return;
+}
+
+timestamp Messenger::next_update_time(timestamp now) const
+{
+    if (!this->telemetry_sinks.empty() || this->shared_telemetry)
+    {
+        return now;
+    }
+
+    /* Mirrors the rate checks of update_simulation_state, where a write time after now (from a previous run) is always due */
+    const auto next_write = [now](timestamp previous, timestamp rate)
+    {
+        return (now < previous) ? now : (previous + rate);
+    };
+
+    timestamp next = timestamp::from_microseconds(std::numeric_limits<uint64_t>::max());
+    if (!silent_sim_prints)
+    {
+        next = std::min(next, next_write(previous_terminal_write, terminal_print_rate));
+    }
+    if (!silent_csv_prints)
+    {
+        next = std::min(next, next_write(previous_csv_write, csv_print_rate));
+    }
+
+    return next;
+}
+
+void Messenger::resume_output_at(timestamp time)
+{
+    this->previous_csv_write      = time;
+    this->previous_terminal_write = time;
     return;
 }
 
+std::vector<std::string> Messenger::output_column_names(uint32_t num_reaction_wheels)
+{
+    std::vector<std::string> columns =
+    {
+        "Time", "Timestep",
+        "Satellite theta x", "Satellite theta y", "Satellite theta z",
+        "Satellite Omega x", "Satellite Omega y", "Satellite Omega z",
+        "Satellite alpha x", "Satellite alpha y", "Satellite alpha z",
+        "Accelerometer x",   "Accelerometer y",   "Accelerometer z"
+    };
+
+    for (uint32_t i = 0; i < num_reaction_wheels; i++)
+    {
+        columns.push_back("Reaction wheel " + std::to_string(i) + " Omega");
+        columns.push_back("Reaction wheel " + std::to_string(i) + " alpha");
+    }
+
+    return columns;
+}
+
 void Messenger::write_cout_header(uint32_t num_reaction_wheels)
 {
     if(!silent_sim_prints)
@@ -100,11 +226,9 @@ void Messenger::write_csv_header(uint32_t num_reaction_wheels)
     this->output_file_buffer.str(std::string());
 
     /* Write the new header */
-    this->output_file_buffer << "Time,Timestep,Satellite theta x,Satellite theta y,Satellite theta z,Satellite Omega x,Satellite Omega y,Satellite Omega z,";
-    this->output_file_buffer << "Satellite alpha x,Satellite alpha y,Satellite alpha z,Accelerometer x,Accelerometer y,Accelerometer z,";//Gyro x,Gyro y,Gyro z,";
-    for (uint32_t i = 0; i < num_reaction_wheels; i++)
+    for (const std::string &column : this->output_column_names(num_reaction_wheels))
     {
-        this->output_file_buffer << "Reaction wheel " << i << " Omega,Reaction wheel " << i << " alpha,";
+        this->output_file_buffer << column << ",";
     }
     this->output_file_buffer << std::endl;
 
@@ -112,40 +236,182 @@ void Messenger::write_csv_header(uint32_t num_reaction_wheels)
 }
 
 
-void Messenger::update_simulation_state(sim_config state, timestamp time, timestamp timestep)
+void Messenger::update_simulation_state(const sim_state_view &state)
 {
-    if ( (!silent_sim_prints) &&
-         (terminal_print_rate <= (time - previous_terminal_write)) )
+    ADCS_PROFILE_SCOPE(messenger_update);
+
+    for (TelemetrySink *sink : this->telemetry_sinks)
     {
-        this->append_cout_output(state, time, timestep);
-        previous_terminal_write = time;
+        sink->on_simulation_state(state);
+    }
+    if (this->shared_telemetry)
+    {
+        this->publish_shared_frame(state);
     }
 
-    if ( (!silent_csv_prints) &&
-         (csv_print_rate <= (time - previous_csv_write)) )
+    const timestamp time = state.time();
+    const bool to_terminal = (!silent_sim_prints) &&
+                             (terminal_print_rate <= (time - previous_terminal_write));
+    const bool to_file     = (!silent_csv_prints) &&
+                             (csv_print_rate <= (time - previous_csv_write));
+
+    if (!to_terminal && !to_file)
+    {
+        return;
+    }
+
+    if (to_terminal)
+    {
+        previous_terminal_write = time;
+    }
+    if (to_file)
     {
-        this->append_csv_output(state, time, timestep);
         previous_csv_write = time;
     }
 
+    /* The sample is written in place, in its queue slot or the slot past the end of the queue */
+    const bool queued = this->writer_running.load(std::memory_order_relaxed);
+    size_t slot = telemetry_queue_t::capacity();
+    if (queued && (BackpressurePolicy::Drop == this->backpressure_policy))
+    {
+        slot = this->telemetry_queue->try_claim();
+        if (telemetry_queue_t::capacity() == slot)
+        {
+            this->dropped_samples++;
+            return;
+        }
+    }
+    else if (queued)
+    {
+        while (telemetry_queue_t::capacity() == (slot = this->telemetry_queue->try_claim()))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    telemetry_sample direct_sample;
+    telemetry_sample &sample = queued ? this->telemetry_queue->slot(slot) : direct_sample;
+    sample.time        = time;
+    sample.timestep    = state.timestep();
+    sample.to_terminal = to_terminal;
+    sample.to_file     = to_file;
+
+    for (int i = 0; i < 3; i++)
+    {
+        sample.theta_b[i]       = state.satellite().theta_b(i);
+        sample.omega_b[i]       = state.satellite().omega_b(i);
+        sample.alpha_b[i]       = state.satellite().alpha_b(i);
+        sample.accelerometer[i] = state.accelerometer().measurement(i);
+    }
+
+    const sim_reaction_wheels &wheels = state.reaction_wheels();
+    sample.num_reaction_wheels = std::min<uint32_t>(wheels.omega.size(), this->num_telemetry_wheels);
+    sample.rw_omega            = this->wheel_storage.data() + slot * 2 * this->num_telemetry_wheels;
+    sample.rw_alpha            = sample.rw_omega + this->num_telemetry_wheels;
+    for (uint32_t i = 0; i < sample.num_reaction_wheels; i++)
+    {
+        sample.rw_omega[i] = wheels.omega(i);
+        sample.rw_alpha[i] = wheels.alpha(i);
+    }
+
+    if (queued)
+    {
+        this->telemetry_queue->publish();
+    }
+    else
+    {
+        this->write_sample(sample);
+    }
+
     return;
 }
 
-void Messenger::append_cout_output(sim_config state, timestamp time, timestamp timestep)
+void Messenger::start_writer()
 {
-    std::cout << text_colour.reset << time.pretty_string() << "\t" << timestep.pretty_string() << "\t";
-    std::cout << state.satellite.theta_b.x() << ", " << state.satellite.theta_b.y() << ", " << state.satellite.theta_b.z() << ";\t\t";
-    std::cout << state.satellite.omega_b.x() << ", " << state.satellite.omega_b.y() << ", " << state.satellite.omega_b.z() << ";\t\t";
-    std::cout << state.satellite.alpha_b.x() << ", " << state.satellite.alpha_b.y() << ", " << state.satellite.alpha_b.z() << ";\t";
+    this->stop_writer();
+
+    this->dropped_samples = 0;
+    this->writer_running.store(true, std::memory_order_release);
+    this->writer_thread = std::thread(&Messenger::writer_loop, this);
 
-    std::cout << state.accelerometer.measurement.x() << ", " << state.accelerometer.measurement.y() << ", " << state.accelerometer.measurement.z() << ";\t";
-    // std::cout << state.gyroscope.measurement.x()     << ", " << state.gyroscope.measurement.y()     << ", " << state.gyroscope.measurement.z() << ";";
+    return;
+}
+
+void Messenger::stop_writer()
+{
+    if (this->writer_thread.joinable())
+    {
+        /* The writer drains the queue before it exits, so joining is the flush barrier. */
+        this->writer_running.store(false, std::memory_order_release);
+        this->writer_thread.join();
+    }
+
+    return;
+}
 
-    for (uint32_t i = 0; i < state.reaction_wheels.size(); i++)
+void Messenger::writer_loop()
+{
+    while (true)
     {
-        std::cout << "\t" << state.reaction_wheels.at(i).omega << ", " << state.reaction_wheels.at(i).alpha << ";";
+        /* Read the flag before draining, so nothing pushed before stop_writer() can be missed. */
+        const bool running = this->writer_running.load(std::memory_order_acquire);
+
+        size_t slot;
+        while (telemetry_queue_t::capacity() != (slot = this->telemetry_queue->try_peek()))
+        {
+            this->write_sample(this->telemetry_queue->slot(slot));
+            this->telemetry_queue->release();
+        }
 
-        if (i < state.reaction_wheels.size() - 1)
+        if (!running)
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(writer_idle_period);
+    }
+
+    return;
+}
+
+void Messenger::write_sample(const telemetry_sample &sample)
+{
+    if (sample.to_terminal)
+    {
+        this->append_cout_output(sample);
+    }
+
+    if (sample.to_file)
+    {
+        this->fill_output_row(sample);
+        if (OutputFormat::Binary == this->output_format)
+        {
+            this->append_binary_output(sample);
+        }
+        else
+        {
+            this->append_csv_output(sample);
+        }
+        this->summary_writer.append_row(sample.time.microseconds() * 1e-6, this->output_row.data());
+    }
+
+    return;
+}
+
+void Messenger::append_cout_output(const telemetry_sample &sample)
+{
+    std::cout << text_colour.reset << sample.time.pretty_string() << "\t" << sample.timestep.pretty_string() << "\t";
+    std::cout << sample.theta_b[0] << ", " << sample.theta_b[1] << ", " << sample.theta_b[2] << ";\t\t";
+    std::cout << sample.omega_b[0] << ", " << sample.omega_b[1] << ", " << sample.omega_b[2] << ";\t\t";
+    std::cout << sample.alpha_b[0] << ", " << sample.alpha_b[1] << ", " << sample.alpha_b[2] << ";\t";
+
+    std::cout << sample.accelerometer[0] << ", " << sample.accelerometer[1] << ", " << sample.accelerometer[2] << ";\t";
+
+    for (uint32_t i = 0; i < sample.num_reaction_wheels; i++)
+    {
+        std::cout << "\t" << sample.rw_omega[i] << ", " << sample.rw_alpha[i] << ";";
+
+        if (i < sample.num_reaction_wheels - 1)
         {
             std::cout << "\t";
         }
@@ -155,29 +421,77 @@ void Messenger::append_cout_output(sim_config state, timestamp time, timestamp t
     return;
 }
 
-void Messenger::append_csv_output(sim_config state, timestamp time, timestamp timestep)
+void Messenger::append_csv_output(const telemetry_sample &sample)
+{
+    format_csv_row(sample, this->output_file_buffer);
+
+    return;
+}
+
+void Messenger::format_csv_row(const telemetry_sample &sample, std::ostream &out)
 {
-    this->output_file_buffer << (float)time << "," << (float)timestep <<",";
-    this->output_file_buffer << state.satellite.theta_b.x() << "," << state.satellite.theta_b.y() << "," << state.satellite.theta_b.z() << ",";
-    this->output_file_buffer << state.satellite.omega_b.x() << "," << state.satellite.omega_b.y() << "," << state.satellite.omega_b.z() << ",";
-    this->output_file_buffer << state.satellite.alpha_b.x() << "," << state.satellite.alpha_b.y() << "," << state.satellite.alpha_b.z() << ",";
+    out << sample.time.to_seconds() << "," << sample.timestep.to_seconds() <<",";
+    out << sample.theta_b[0] << "," << sample.theta_b[1] << "," << sample.theta_b[2] << ",";
+    out << sample.omega_b[0] << "," << sample.omega_b[1] << "," << sample.omega_b[2] << ",";
+    out << sample.alpha_b[0] << "," << sample.alpha_b[1] << "," << sample.alpha_b[2] << ",";
 
-    this->output_file_buffer << state.accelerometer.measurement.x() << "," << state.accelerometer.measurement.y() << "," << state.accelerometer.measurement.z() << ",";
-    // output_file << state.gyroscope.measurement.x()     << "," << state.gyroscope.measurement.y()     << "," << state.gyroscope.measurement.z()     << ",";
+    out << sample.accelerometer[0] << "," << sample.accelerometer[1] << "," << sample.accelerometer[2] << ",";
 
-    for (uint32_t i = 0; i < state.reaction_wheels.size(); i++)
+    for (uint32_t i = 0; i < sample.num_reaction_wheels; i++)
     {
-        this->output_file_buffer << state.reaction_wheels.at(i).omega << "," << state.reaction_wheels.at(i).alpha << ",";
+        out << sample.rw_omega[i] << "," << sample.rw_alpha[i] << ",";
     }
-    this->output_file_buffer << std::endl;
+    out << "\n";
 
     return;
 }
 
-void Messenger::write_output_buffer()
+void Messenger::fill_output_row(const telemetry_sample &sample)
 {
-    /* Determine output file name */
-    // std::string cwd = std::filesystem::current_path();
+    float *row = this->output_row.data();
+    uint32_t c = 0;
+
+    row[c++] = sample.timestep.to_seconds();
+    for (int i = 0; i < 3; i++) row[c++] = sample.theta_b[i];
+    for (int i = 0; i < 3; i++) row[c++] = sample.omega_b[i];
+    for (int i = 0; i < 3; i++) row[c++] = sample.alpha_b[i];
+    for (int i = 0; i < 3; i++) row[c++] = sample.accelerometer[i];
+
+    /* The schema is fixed at the start of the simulation, so never write past it. */
+    for (uint32_t i = 0; (i < sample.num_reaction_wheels) && (c + 1 < this->output_row.size()); i++)
+    {
+        row[c++] = sample.rw_omega[i];
+        row[c++] = sample.rw_alpha[i];
+    }
+
+    return;
+}
+
+void Messenger::append_binary_output(const telemetry_sample &sample)
+{
+    if (!this->trajectory_writer.is_open())
+    {
+        return;
+    }
+
+    this->trajectory_writer.append_row(sample.time.microseconds() * 1e-6, this->output_row.data());
+
+    return;
+}
+
+std::string Messenger::next_output_file_path(const std::string &extension)
+{
+    if (!this->output_path_override.empty())
+    {
+        const std::filesystem::path path(this->output_path_override);
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path());
+        }
+        std::filesystem::remove(path);
+        return this->output_path_override;
+    }
+
     std::string csv_path = "./" + this->default_csv_path;
     std::string suffix = "";
     uint32_t suffix_num = 0;
@@ -190,21 +504,52 @@ void Messenger::write_output_buffer()
     csv_path += this->default_csv_name;
 
     /* search for file if it exists, increment if it does */
-    while(std::filesystem::exists(csv_path + suffix + this->csv_ext))
+    while(std::filesystem::exists(csv_path + suffix + extension))
     {
         if (UINT32_MAX <= suffix_num)
         {
             this->output_file_path_string = "-1";
-            throw invalid_messagenger_param("Unable to create output CSV, too many files exist.");
+            throw invalid_messagenger_param("Unable to create output file, too many files exist.");
         }
         suffix_num++;
         suffix = std::to_string(suffix_num);
     }
 
+    return csv_path + suffix + extension;
+}
+
+void Messenger::write_output_buffer()
+{
+    /* Flush barrier: every sample queued so far is formatted before the output is finished. */
+    this->stop_writer();
+
+    if (0 < this->dropped_samples)
+    {
+        send_warning(std::to_string(this->dropped_samples) + " telemetry samples were dropped because the writer fell behind.");
+        this->dropped_samples = 0;
+    }
+
+    /* Nothing was recorded if the csv output was silenced. */
+    if (this->silent_csv_prints)
+    {
+        return;
+    }
+
+    /* The binary output is already on disk, it only needs its last chunk written. */
+    if (OutputFormat::Binary == this->output_format)
+    {
+        this->trajectory_writer.close();
+        this->close_summary("");
+        return;
+    }
+
+    /* Determine output file name */
+    std::string output_path = this->next_output_file_path(this->csv_ext);
+
     /* Open the file and write out the buffer */
     if ("-1" != this->output_file_path_string)
     {
-        this->output_file_path_string = csv_path + suffix + this->csv_ext;
+        this->output_file_path_string = output_path;
 
         std::ofstream output_file(output_file_path_string, std::fstream::out | std::fstream::app);
         if (output_file.is_open())
@@ -213,12 +558,9 @@ void Messenger::write_output_buffer()
             {
                 send_error("output buffer is empty");
             }
-            std::string line;
-            while (getline(this->output_file_buffer, line))
-            {
-                output_file << line << std::endl;
-            }
+            output_file << this->output_file_buffer.rdbuf();
             output_file.close();
+            this->close_summary(SummaryWriter::get_summary_path(output_file_path_string));
         }
         else
         {
@@ -227,6 +569,18 @@ void Messenger::write_output_buffer()
     }
 }
 
+void Messenger::close_summary(const std::string &path)
+{
+    try
+    {
+        this->summary_writer.close(path);
+    }
+    catch (summary_write_error &e)
+    {
+        send_error(e.message());
+    }
+}
+
 void Messenger::clean_csv_files()
 {
     if (std::filesystem::exists(default_csv_path))
@@ -240,6 +594,31 @@ void Messenger::clean_csv_files()
     return;
 }
 
+void Messenger::silence_messages()
+{
+    this->silent_messages = true;
+    return;
+}
+
+void Messenger::add_telemetry_sink(TelemetrySink *sink)
+{
+    this->telemetry_sinks.push_back(sink);
+    return;
+}
+
+void Messenger::request_stop(const std::string &reason)
+{
+    this->stop_is_requested = true;
+    this->stop_reason       = reason;
+    return;
+}
+
+void Messenger::set_output_path(const std::string &path)
+{
+    this->output_path_override = path;
+    return;
+}
+
 void Messenger::silence_sim_prints()
 {
     this->silent_sim_prints = true;
@@ -253,6 +632,12 @@ void Messenger::reset_defaults()
     this->csv_print_rate      = default_csv_print_rate;
     this->terminal_print_rate = default_terminal_print_rate;
     this->silent_csv_prints   = default_silent_csv_prints;
+    this->output_format       = default_output_format;
+    this->backpressure_policy = default_backpressure_policy;
+    this->silent_messages     = false;
+    this->telemetry_sinks.clear();
+    this->shared_memory_name.clear();
+    this->output_path_override.clear();
     return;
 }
 
@@ -270,6 +655,70 @@ void Messenger::set_terminal_print_rate(uint32_t terminal_rate)
     return;
 }
 
+void Messenger::set_output_format(OutputFormat format)
+{
+    this->output_format = format;
+    if (OutputFormat::Binary == format)
+    {
+        this->send_message("Output will be written as a binary trajectory file.");
+    }
+    return;
+}
+
+void Messenger::set_backpressure_policy(BackpressurePolicy policy)
+{
+    this->backpressure_policy = policy;
+    if (BackpressurePolicy::Drop == policy)
+    {
+        this->send_message("Telemetry samples will be dropped if the writer falls behind.");
+    }
+    return;
+}
+
+void Messenger::set_shared_memory_output(const std::string &name)
+{
+    this->shared_memory_name = ((!name.empty()) && ('/' != name.front())) ? ("/" + name) : name;
+    if (!this->shared_memory_name.empty())
+    {
+        this->send_message("Telemetry will be published to shared memory " + this->shared_memory_name + ".");
+    }
+    return;
+}
+
+void Messenger::close_shared_memory()
+{
+    this->shared_telemetry.reset();
+    return;
+}
+
+void Messenger::publish_shared_frame(const sim_state_view &state)
+{
+    shared_telemetry_frame frame;
+    frame.time     = state.time().microseconds();
+    frame.timestep = state.timestep().microseconds();
+
+    const sim_gyroscope &gyroscope = state.gyroscope();
+    for (int i = 0; i < 3; i++)
+    {
+        frame.theta_b[i]         = state.satellite().theta_b(i);
+        frame.omega_b[i]         = state.satellite().omega_b(i);
+        frame.alpha_b[i]         = state.satellite().alpha_b(i);
+        frame.accelerometer[i]   = state.accelerometer().measurement(i);
+        frame.gyroscope_theta[i] = gyroscope.theta(i);
+        frame.gyroscope_omega[i] = gyroscope.omega(i);
+    }
+
+    const sim_reaction_wheels &wheels = state.reaction_wheels();
+    frame.num_reaction_wheels = std::min<uint32_t>(wheels.omega.size(), max_shared_reaction_wheels);
+    for (uint32_t i = 0; i < max_shared_reaction_wheels; i++)
+    {
+        frame.rw_omega[i] = (i < frame.num_reaction_wheels) ? wheels.omega(i) : 0;
+        frame.rw_alpha[i] = (i < frame.num_reaction_wheels) ? wheels.alpha(i) : 0;
+    }
+
+    this->shared_telemetry->publish(frame);
+}
+
 void Messenger::silence_csv()
 {
     this->silent_csv_prints = true;
@@ -0,0 +1,163 @@
+/**
+ * @file    Profiler.cpp
+ *
+ * @details This file implements the Profiler class as defined in Profiler.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Profiler.hpp"
+
+namespace
+{
+    /**
+     * @name    to_ms
+     *
+     * @returns the duration in ms.
+    **/
+    double to_ms(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+Profiler &Profiler::thread_instance()
+{
+    thread_local Profiler profiler;
+    return profiler;
+}
+
+void Profiler::reset(bool record_trace)
+{
+    this->zones          = {};
+    this->counters       = {};
+    this->epoch          = clock::now();
+    this->record_trace   = record_trace;
+    this->dropped_events = 0;
+    this->events.clear();
+}
+
+void Profiler::add_zone(ProfileZone zone, clock::time_point start, clock::time_point end)
+{
+    const std::chrono::nanoseconds duration = end - start;
+
+    zone_stats &stats = this->zones[static_cast<size_t>(zone)];
+    stats.calls++;
+    stats.total += duration;
+    stats.max    = std::max(stats.max, duration);
+
+    if (this->record_trace)
+    {
+        if (max_trace_events <= this->events.size())
+        {
+            this->dropped_events++;
+        }
+        else
+        {
+            const std::chrono::nanoseconds since_epoch = start - this->epoch;
+            this->events.push_back({zone, static_cast<uint64_t>(since_epoch.count()), static_cast<uint64_t>(duration.count())});
+        }
+    }
+}
+
+std::string Profiler::summary() const
+{
+    std::ostringstream table;
+    table << std::fixed << std::setprecision(3);
+
+    table << "Profile of the last " << to_ms(clock::now() - this->epoch) << " ms:\n";
+    table << std::left << std::setw(22) << "zone" << std::right
+          << std::setw(12) << "calls" << std::setw(14) << "total ms" << std::setw(14) << "mean us" << std::setw(14) << "max us" << "\n";
+    for (size_t i = 0; i < num_zones; i++)
+    {
+        const zone_stats &stats = this->zones[i];
+        const double mean_us = (0 == stats.calls) ? 0 : (to_ms(stats.total) * 1000 / stats.calls);
+
+        table << std::left << std::setw(22) << zone_name(static_cast<ProfileZone>(i)) << std::right
+              << std::setw(12) << stats.calls << std::setw(14) << to_ms(stats.total)
+              << std::setw(14) << mean_us << std::setw(14) << (to_ms(stats.max) * 1000) << "\n";
+    }
+
+    table << std::left << std::setw(22) << "counter" << std::right << std::setw(12) << "count" << "\n";
+    for (size_t i = 0; i < num_counters; i++)
+    {
+        table << std::left << std::setw(22) << counter_name(static_cast<ProfileCounter>(i)) << std::right
+              << std::setw(12) << this->counters[i] << "\n";
+    }
+
+    if (0 < this->dropped_events)
+    {
+        table << this->dropped_events << " trace events were dropped once the trace was full.\n";
+    }
+
+    return table.str();
+}
+
+bool Profiler::write_chrome_trace(const std::string &path) const
+{
+    const std::filesystem::path trace_path(path);
+    if (trace_path.has_parent_path())
+    {
+        std::filesystem::create_directories(trace_path.parent_path());
+    }
+
+    std::ofstream trace(path);
+    if (!trace)
+    {
+        return false;
+    }
+
+    /* Chrome trace times are in us. Each zone gets its own row so nested zones stay readable. */
+    trace << std::fixed << std::setprecision(3);
+    trace << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    for (size_t i = 0; i < num_zones; i++)
+    {
+        trace << ((0 == i) ? "\n" : ",\n");
+        trace << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << i
+              << ", \"args\": {\"name\": \"" << zone_name(static_cast<ProfileZone>(i)) << "\"}}";
+    }
+    for (const trace_event &event : this->events)
+    {
+        trace << ",\n{\"name\": \"" << zone_name(event.zone) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << static_cast<size_t>(event.zone)
+              << ", \"ts\": " << (event.start_ns / 1000.0) << ", \"dur\": " << (event.duration_ns / 1000.0) << "}";
+    }
+    trace << "\n]}\n";
+
+    return true;
+}
+
+const char *Profiler::zone_name(ProfileZone zone)
+{
+    switch (zone)
+    {
+        case ProfileZone::timestep:           return "timestep";
+        case ProfileZone::determine_timestep: return "determine_timestep";
+        case ProfileZone::messenger_update:   return "messenger_update";
+        case ProfileZone::controller_cycle:   return "controller_cycle";
+        case ProfileZone::device_poll:        return "device_poll";
+        default:                              return "unknown";
+    }
+}
+
+const char *Profiler::counter_name(ProfileCounter counter)
+{
+    switch (counter)
+    {
+        case ProfileCounter::timesteps:           return "timesteps";
+        case ProfileCounter::shortened_timesteps: return "shortened_timesteps";
+        case ProfileCounter::controller_cycles:   return "controller_cycles";
+        case ProfileCounter::device_polls:        return "device_polls";
+        case ProfileCounter::device_not_ready:    return "device_not_ready";
+        default:                                  return "unknown";
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * @file    RateScheduler.cpp
+ *
+ * @details This file implements the RateScheduler class as defined in RateScheduler.hpp.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include "RateScheduler.hpp"
+
+size_t RateScheduler::add_task(task_function run, timestamp due)
+{
+    this->tasks.push_back({std::move(run), due});
+    this->update_earliest();
+
+    return this->tasks.size() - 1;
+}
+
+void RateScheduler::set_due(size_t task, timestamp due)
+{
+    this->tasks.at(task).due = due;
+    this->update_earliest();
+}
+
+void RateScheduler::run_tasks(timestamp now)
+{
+    for (task &t : this->tasks)
+    {
+        if (t.due <= now)
+        {
+            t.due = t.run(now);
+        }
+    }
+    this->update_earliest();
+}
+
+void RateScheduler::update_earliest()
+{
+    this->earliest = never;
+    for (const task &t : this->tasks)
+    {
+        if (t.due < this->earliest)
+        {
+            this->earliest = t.due;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * @file    SensorNoise.cpp
+ *
+ * @details This file implements the NoiseStream class as defined in SensorNoise.hpp.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <cmath>
+
+#include "SensorNoise.hpp"
+
+namespace
+{
+    /**
+     * @name    mix
+     *
+     * @details the splitmix64 finalizer. Consecutive inputs give statistically independent
+     *          outputs, so a counter hashed with it is a random stream.
+    **/
+    inline uint64_t mix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x  = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x  = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @name    to_unit
+     *
+     * @returns the top 24 bits of a hash as a float in (0, 1). Never 0, so its log is finite.
+    **/
+    inline float to_unit(uint64_t hash)
+    {
+        return (static_cast<float>(hash >> 40) + 0.5f) * (1.0f / 16777216.0f);
+    }
+}
+
+void NoiseStream::reset(uint64_t seed, uint64_t stream, float std_dev)
+{
+    this->key          = mix(mix(seed) ^ stream);
+    this->std_dev      = std_dev;
+    this->position     = 0;
+    this->filled_block = std::numeric_limits<uint64_t>::max();
+}
+
+void NoiseStream::fill_block(uint64_t block_index)
+{
+    constexpr uint32_t pairs = block_size / 2;
+    alignas(32) float radius[pairs];
+    alignas(32) float angle[pairs];
+
+    const uint64_t counter = this->key + (block_index * block_size);
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        radius[i] = to_unit(mix(counter + (2 * i)));
+        angle[i]  = to_unit(mix(counter + (2 * i) + 1));
+    }
+
+    /* Box-Muller: each pair of uniforms becomes two independent standard normals */
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        const float r = std::sqrt(-2.0f * std::log(radius[i]));
+        const float a = static_cast<float>(2 * M_PI) * angle[i];
+        this->block[2 * i]     = r * std::cos(a);
+        this->block[2 * i + 1] = r * std::sin(a);
+    }
+
+    this->filled_block = block_index;
+}
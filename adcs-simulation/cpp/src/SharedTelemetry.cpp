@@ -0,0 +1,148 @@
+/**
+ * @file SharedTelemetry.cpp
+ *
+ * @details implementation of the shared memory telemetry bridge, as described in SharedTelemetry.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <cerrno>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SharedTelemetry.hpp"
+
+namespace
+{
+    /**
+     * @name    segment_name
+     *
+     * @returns the name with the leading '/' POSIX shared memory names need.
+    **/
+    std::string segment_name(const std::string &name)
+    {
+        return ((!name.empty()) && ('/' == name.front())) ? name : ("/" + name);
+    }
+
+    /**
+     * @name    segment_size
+     *
+     * @returns the size of a segment of capacity slots.
+    **/
+    size_t segment_size(uint32_t capacity)
+    {
+        return sizeof(shared_telemetry_header) + static_cast<size_t>(capacity) * sizeof(shared_telemetry_slot);
+    }
+}
+
+SharedTelemetryPublisher::SharedTelemetryPublisher(const std::string &name, uint32_t capacity) : name(segment_name(name))
+{
+    this->capacity = 1;
+    while (this->capacity < capacity)
+    {
+        this->capacity <<= 1;
+    }
+
+    /* Readers of a previous segment of the same name keep it, new readers get this one */
+    shm_unlink(this->name.c_str());
+    const int fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (0 > fd)
+    {
+        throw invalid_shared_telemetry(std::string("Unable to create shared memory " + this->name + ": " + std::strerror(errno)).c_str());
+    }
+
+    this->mapping_size = segment_size(this->capacity);
+    if (0 != ftruncate(fd, static_cast<off_t>(this->mapping_size)))
+    {
+        close(fd);
+        shm_unlink(this->name.c_str());
+        throw invalid_shared_telemetry(std::string("Unable to size shared memory " + this->name + ": " + std::strerror(errno)).c_str());
+    }
+
+    void *mapping = mmap(nullptr, this->mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == mapping)
+    {
+        shm_unlink(this->name.c_str());
+        throw invalid_shared_telemetry(std::string("Unable to map shared memory " + this->name + ": " + std::strerror(errno)).c_str());
+    }
+    this->mapping = mapping;
+
+    /* The new segment is zero filled, so every slot starts with sequence 0: no frame */
+    this->header = new (mapping) shared_telemetry_header;
+    this->slots  = reinterpret_cast<shared_telemetry_slot*>(static_cast<char*>(mapping) + sizeof(shared_telemetry_header));
+    for (uint32_t i = 0; i < this->capacity; i++)
+    {
+        new (&this->slots[i]) shared_telemetry_slot;
+        this->slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+
+    std::memcpy(this->header->magic, magic, sizeof(magic));
+    this->header->version    = format_version;
+    this->header->capacity   = this->capacity;
+    this->header->frame_size = sizeof(shared_telemetry_frame);
+    this->header->slot_size  = sizeof(shared_telemetry_slot);
+    this->header->run.store(0, std::memory_order_relaxed);
+    this->header->published.store(0, std::memory_order_release);
+}
+
+SharedTelemetryPublisher::~SharedTelemetryPublisher()
+{
+    munmap(this->mapping, this->mapping_size);
+    shm_unlink(this->name.c_str());
+}
+
+SharedTelemetryReader::SharedTelemetryReader(const std::string &name)
+{
+    const std::string path = segment_name(name);
+    const int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (0 > fd)
+    {
+        throw invalid_shared_telemetry(std::string("Unable to open shared memory " + path + ": " + std::strerror(errno)).c_str());
+    }
+
+    struct stat info;
+    if ((0 != fstat(fd, &info)) || (static_cast<size_t>(info.st_size) < sizeof(shared_telemetry_header)))
+    {
+        close(fd);
+        throw invalid_shared_telemetry(std::string(path + " is not a telemetry segment.").c_str());
+    }
+
+    this->mapping_size = static_cast<size_t>(info.st_size);
+    const void *mapping = mmap(nullptr, this->mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == mapping)
+    {
+        throw invalid_shared_telemetry(std::string("Unable to map shared memory " + path + ": " + std::strerror(errno)).c_str());
+    }
+    this->mapping = mapping;
+
+    this->header = static_cast<const shared_telemetry_header*>(mapping);
+    this->slots  = reinterpret_cast<const shared_telemetry_slot*>(static_cast<const char*>(mapping) + sizeof(shared_telemetry_header));
+
+    const uint32_t capacity = this->header->capacity;
+    if ((0 != std::memcmp(this->header->magic, SharedTelemetryPublisher::magic, sizeof(SharedTelemetryPublisher::magic))) ||
+        (SharedTelemetryPublisher::format_version != this->header->version) ||
+        (sizeof(shared_telemetry_frame) != this->header->frame_size) ||
+        (sizeof(shared_telemetry_slot) != this->header->slot_size) ||
+        (0 == capacity) || (0 != (capacity & (capacity - 1))) ||
+        (segment_size(capacity) > this->mapping_size))
+    {
+        munmap(const_cast<void*>(this->mapping), this->mapping_size);
+        throw invalid_shared_telemetry(std::string(path + " has a different telemetry layout.").c_str());
+    }
+    this->capacity = capacity;
+}
+
+SharedTelemetryReader::~SharedTelemetryReader()
+{
+    munmap(const_cast<void*>(this->mapping), this->mapping_size);
+}
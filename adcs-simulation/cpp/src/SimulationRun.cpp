@@ -0,0 +1,331 @@
+/**
+ * @file    SimulationRun.cpp
+ *
+ * @details This file implements the SimulationRun class as defined in SimulationRun.hpp
+ *
+ * @authors Aidan Sheedy, Lily de Loe
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <cmath>
+
+#include "SimulationRun.hpp"
+#include "DeviceArena.hpp"
+#include "PointingModeController.hpp"
+#include "DummyController.hpp"
+#include "Profiler.hpp"
+
+SimulationRun::SimulationRun(std::shared_ptr<const Configuration> config, Messenger *messenger) :
+    config(std::move(config)), messenger(messenger), simulator(messenger)
+{
+}
+
+void SimulationRun::set_phase_timing(phase_timing *timing)
+{
+    this->phase_times = timing;
+    this->simulator.set_phase_timing(timing);
+}
+
+SimulationRun::~SimulationRun() = default;
+
+void SimulationRun::execute()
+{
+    this->start();
+    this->advance();
+    this->finish();
+
+    return;
+}
+
+void SimulationRun::start()
+{
+    this->run_start = std::chrono::steady_clock::now();
+
+    /* Anything left of a previous run goes before the devices and the timer it uses */
+    this->controller_task = nullptr;
+    this->pointing_controller.reset();
+    this->dummy_controller.reset();
+    this->convergence.reset();
+    this->devices.reset();
+
+#ifdef ADCS_PROFILING
+    Profiler::thread_instance().reset(!this->trace_path.empty());
+#endif
+
+    simulator.init(*config);
+    if (this->resume_from)
+    {
+        simulator.restore_state(this->resume_from->simulator);
+        messenger->send_message("Resuming from " + this->resume_from->simulator.simulation_time.pretty_string());
+    }
+    this->setup_environment();
+
+    /* Timer used for control code */
+    this->timer = std::make_unique<ADCS_timer>(&simulator);
+
+    /**
+     * If exit conditions are provided, run the pointing mode controller. Otherwise, run the dummy
+     * controller until the time runs out.
+    **/
+    if (!config->hasExitConditions())
+    {
+        messenger->send_message("No exit yaml supplied for controller. Will run sim with no controller until timeout.");
+
+        this->dummy_controller = std::make_unique<DummyController>(this->timer.get());
+        if (!this->checkpoint_path.empty())
+        {
+            simulator.set_checkpoint_handler(this->checkpoint_period, [this]() { this->save_checkpoint(nullptr, nullptr); });
+        }
+        this->controller_task = [this]() { return this->dummy_controller->step(); };
+    }
+    else
+    {
+        /* Every device of the run, alive until finish */
+        this->devices = std::make_unique<DeviceArena>(*config, &simulator);
+
+        Eigen::Vector3f final_sat_position  = config->getDesiredSatellitePosition();
+
+        /* The exit yaml gives the accuracy in degrees, the jitter in degrees/second, and the hold time in ms */
+        if (this->stop_on_convergence && (0 < config->getRequiredAccuracy()))
+        {
+            const float rad_per_deg = M_PI / 180;
+            this->convergence = std::make_unique<ConvergenceMonitor>(final_sat_position,
+                                                                     config->getRequiredAccuracy() * rad_per_deg,
+                                                                     config->getAllowedJitter() * rad_per_deg,
+                                                                     timestamp(config->getHoldTime(), 0));
+            simulator.set_convergence_monitor(this->convergence.get());
+        }
+
+        const device_registry &registry = this->devices->get_registry();
+        if (this->resume_from)
+        {
+            this->restore_devices(registry);
+        }
+
+        /* Start control code */
+        this->pointing_controller = std::make_unique<PointingModeController>(registry, this->timer.get(), config->GetAttitudeFilter(),
+                                                                             config->GetControllerGains());
+        PointingModeController *controller = this->pointing_controller.get();
+        if (0 < config->GetControllerRate())
+        {
+            controller->set_period(timestamp(1.0f / config->GetControllerRate()));
+        }
+        if (!this->checkpoint_path.empty())
+        {
+            simulator.set_checkpoint_handler(this->checkpoint_period, [this, &registry, controller]() { this->save_checkpoint(&registry, controller); });
+        }
+
+        if (this->resume_from && this->resume_from->has_controller)
+        {
+            controller->start_from(final_sat_position, ramp_time, this->resume_from->controller);
+        }
+        else
+        {
+            controller->start(final_sat_position, ramp_time);
+        }
+        this->controller_task = [controller]() { return controller->step(); };
+    }
+
+    this->end_setup();
+    this->start_pacer();
+
+    return;
+}
+
+bool SimulationRun::advance(timestamp until)
+{
+    return RunOutcome::Running == simulator.run_task(this->controller_task, until);
+}
+
+void SimulationRun::finish()
+{
+    switch (simulator.get_outcome())
+    {
+        case RunOutcome::Converged:
+            messenger->send_message(simulator.get_outcome_message(), text_colour.green);
+            break;
+        case RunOutcome::Running:
+            messenger->send_message("Simulation finished at " + simulator.update_simulation().pretty_string() + ", before it ended.");
+            break;
+        default:
+            messenger->send_message(simulator.get_outcome_message());
+            break;
+    }
+
+    simulator.set_checkpoint_handler(0, nullptr);
+    simulator.set_convergence_monitor(nullptr);
+
+    /* The controllers use the devices, which use the timer */
+    this->controller_task = nullptr;
+    this->pointing_controller.reset();
+    this->dummy_controller.reset();
+    this->convergence.reset();
+    this->devices.reset();
+    this->timer.reset();
+
+    this->stop_pacer();
+
+    if (!this->checkpoint_path.empty())
+    {
+        messenger->send_message("Checkpoint written to " + this->checkpoint_path);
+    }
+
+    if (nullptr != this->phase_times)
+    {
+        this->phase_times->total += std::chrono::steady_clock::now() - this->run_start;
+    }
+
+#ifdef ADCS_PROFILING
+    messenger->send_profile_summary(Profiler::thread_instance());
+    if (!this->trace_path.empty())
+    {
+        if (Profiler::thread_instance().write_chrome_trace(this->trace_path))
+        {
+            messenger->send_message("Profile trace written to " + this->trace_path);
+        }
+        else
+        {
+            messenger->send_error("Could not write the profile trace to " + this->trace_path);
+        }
+    }
+#else
+    if (!this->trace_path.empty())
+    {
+        messenger->send_warning("The simulator was built without ADCS_PROFILING, no profile trace was written.");
+    }
+#endif
+
+    return;
+}
+
+void SimulationRun::set_execution_mode(ExecutionMode mode, double real_time_factor, const std::string &tick_path)
+{
+    this->pacer.reset();
+    if (ExecutionMode::AsFastAsPossible != mode)
+    {
+        this->pacer = std::make_unique<ExecutionPacer>(mode, real_time_factor);
+    }
+    this->tick_path = tick_path;
+}
+
+void SimulationRun::start_pacer()
+{
+    if (!this->pacer)
+    {
+        return;
+    }
+
+    this->pacer->begin(simulator.update_simulation());
+    if ((ExecutionMode::Lockstep == this->pacer->get_mode()) && !this->tick_path.empty())
+    {
+        this->pacer->read_ticks(this->tick_path);
+    }
+    simulator.set_pacer(this->pacer.get());
+
+    messenger->send_message(std::string(ExecutionPacer::mode_name(this->pacer->get_mode())) + " execution.");
+}
+
+void SimulationRun::stop_pacer()
+{
+    if (!this->pacer)
+    {
+        return;
+    }
+
+    simulator.set_pacer(nullptr);
+    this->pacer->stop();
+    messenger->send_message(this->pacer->summary(), text_colour.cyan);
+}
+
+void SimulationRun::set_checkpoint_output(const std::string &path, timestamp period)
+{
+    this->checkpoint_path   = path;
+    this->checkpoint_period = period;
+}
+
+void SimulationRun::save_checkpoint(const device_registry *devices, const PointingModeController *controller)
+{
+    sim_checkpoint checkpoint;
+    checkpoint.simulator      = this->simulator.get_state();
+    checkpoint.has_controller = (nullptr != controller);
+    if (nullptr != controller)
+    {
+        checkpoint.controller = controller->get_loop_state();
+    }
+
+    if (nullptr != devices)
+    {
+        for (const Gyroscope *gyro : devices->gyroscopes)
+        {
+            checkpoint.gyroscope_polls.push_back(gyro->get_last_polled());
+        }
+        for (const Accelerometer *accelerometer : devices->accelerometers)
+        {
+            checkpoint.accelerometer_polls.push_back(accelerometer->get_last_polled());
+        }
+        for (const Reaction_wheel *wheel : devices->reaction_wheels)
+        {
+            checkpoint.reaction_wheel_polls.push_back(wheel->get_last_polled());
+        }
+    }
+
+    try
+    {
+        Checkpoint::write(checkpoint, this->checkpoint_path);
+    }
+    catch (invalid_checkpoint &e)
+    {
+        messenger->send_error(e.message());
+    }
+}
+
+void SimulationRun::setup_environment()
+{
+    if (!this->environment && config->GetEnvironment().enabled)
+    {
+        this->environment = EnvironmentTable::load(config->GetEnvironment(), simulator.get_timeout());
+    }
+
+    if (this->environment && (this->environment->get_duration() < simulator.get_timeout()))
+    {
+        throw invalid_environment_table(std::string("The environment table ends at " + this->environment->get_duration().pretty_string() +
+                                                    ", before the run does.").c_str());
+    }
+
+    simulator.set_environment(this->environment.get());
+}
+
+void SimulationRun::restore_devices(const device_registry &devices)
+{
+    const sim_checkpoint &checkpoint = *this->resume_from;
+    if ((checkpoint.gyroscope_polls.size()      != devices.gyroscopes.size())     ||
+        (checkpoint.accelerometer_polls.size()  != devices.accelerometers.size()) ||
+        (checkpoint.reaction_wheel_polls.size() != devices.reaction_wheels.size()))
+    {
+        throw invalid_checkpoint("The checkpoint does not have the same devices as the configuration.");
+    }
+
+    for (size_t i = 0; i < devices.gyroscopes.size(); i++)
+    {
+        devices.gyroscopes.at(i)->restore_poll_time(checkpoint.gyroscope_polls.at(i));
+    }
+    for (size_t i = 0; i < devices.accelerometers.size(); i++)
+    {
+        devices.accelerometers.at(i)->restore_poll_time(checkpoint.accelerometer_polls.at(i));
+    }
+    for (size_t i = 0; i < devices.reaction_wheels.size(); i++)
+    {
+        devices.reaction_wheels.at(i)->restore_poll_time(checkpoint.reaction_wheel_polls.at(i));
+    }
+}
+
+void SimulationRun::end_setup()
+{
+    if (nullptr != this->phase_times)
+    {
+        this->phase_times->setup += std::chrono::steady_clock::now() - this->run_start;
+    }
+}
@@ -6,59 +6,279 @@
  * @authors Lily de Loe, Justin Paoli, Aidan Sheedy
  *
  * Last Edited
- * 2022-12-01
+ * 2026-10-14
  *
 **/
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 
 #include "ConfigurationSingleton.hpp"
 #include "SensorActuatorFactory.hpp"
 #include "PointingModeController.hpp"
 #include "Simulator.hpp"
+#include "Profiler.hpp"
 
-Simulator::Simulator(Messenger *messenger)
+namespace
 {
+    /**
+     * @details the reaction wheel parts of a timestep, for N wheels. N is either the fixed number
+     *          of wheels, so Eigen uses fixed size types and unrolls every loop, or Eigen::Dynamic.
+     *          The dynamically sized storage is mapped in place, nothing is copied.
+    **/
+    template <int N>
+    void sum_wheel_momentum_n(const physics_context &physics, const sim_reaction_wheels &wheels, rigid_body_dynamics *dynamics)
+    {
+        const Eigen::Index num_wheels = wheels.omega.size();
+        Eigen::Map<const Eigen::Matrix<float, 3, N>> axes(physics.rw_momentum_axes.data(), 3, num_wheels);
+        Eigen::Map<const Eigen::Matrix<float, N, 1>> alpha(wheels.alpha.data(), num_wheels);
+        Eigen::Map<const Eigen::Matrix<float, N, 1>> omega(wheels.omega.data(), num_wheels);
+
+        dynamics->rw_torque   = axes * alpha;
+        dynamics->rw_momentum = axes * omega;
+    }
+
+    template <int N>
+    void integrate_wheels_n(sim_reaction_wheels *wheels, float dt)
+    {
+        const Eigen::Index num_wheels = wheels->omega.size();
+        Eigen::Map<const Eigen::Matrix<float, N, 1>> alpha(wheels->alpha.data(), num_wheels);
+        Eigen::Map<Eigen::Matrix<float, N, 1>>       omega(wheels->omega.data(), num_wheels);
+
+        omega += alpha * dt;
+    }
+}
+
+Simulator::Simulator(Messenger *messenger) : sensors(&system_vals)
+{
+    this->telemetry_task = this->tasks.add_task([this](timestamp now)
+    {
+        this->messenger->update_simulation_state(sim_state_view(this->system_vals, this->sensors, now, this->timestep_length));
+        return this->messenger->next_update_time(now);
+    });
+
+    this->checkpoint_task = this->tasks.add_task([this](timestamp now)
+    {
+        this->checkpoint_handler();
+        while (this->next_checkpoint <= now)
+        {
+            this->next_checkpoint += this->checkpoint_period;
+        }
+        return this->next_checkpoint;
+    });
+
     if (nullptr != messenger)
     {
         this->messenger = messenger;
     }
 }
 
-void Simulator::init(sim_config initial_values, timestamp timeout, timestamp initial_timestep, bool variableTimestep, timestamp max_timestep, timestamp min_timestep)
+void Simulator::init(sim_config initial_values, timestamp timeout, timestamp initial_timestep, bool variableTimestep, timestamp max_timestep, timestamp min_timestep,
+                     IntegratorType integrator_type)
 {
     /* TODO may need a check here**/
     this->system_vals = initial_values;
     this->timeout     = timeout;
+    this->sensors.reset();
 
     this->simulation_time = 0;
     this->timestep_length = initial_timestep;
-    this->last_called     = -1;
+    this->scheduled_events = {};
+    this->next_checkpoint  = this->checkpoint_period;
+    this->outcome          = RunOutcome::Running;
+    this->outcome_message.clear();
+    this->task_wake        = 0;
 
     this->variableTimestep = variableTimestep;
     this->max_timestep     = max_timestep;
     this->min_timestamp    = min_timestep;
 
+    this->integrator      = make_integrator(integrator_type);
+    this->last_step_error = 0;
+    if (this->integrator->is_adaptive())
+    {
+        this->timestep_length = min_timestep;
+    }
+
+    this->gyroscope_angle_noise.reset(0, 0, 0);
+    this->gyroscope_rate_noise.reset(0, 0, 0);
+    this->accelerometer_noise.reset(0, 0, 0);
+
+    this->rebuild_physics_context();
+
     messenger->send_message("Starting simulation, timeout: " + this->timeout.pretty_string());
-    messenger->start_new_sim(initial_values.reaction_wheels.size());
+    messenger->start_new_sim(initial_values.reaction_wheels.omega.size());
+    this->schedule_periodic_tasks();
 }
 
-timestamp Simulator::update_simulation() {
-    timestamp time_passed = this->determine_time_passed();
-    this->simulate(time_passed);
+void Simulator::init(const Configuration &config)
+{
+    timestamp timeout(config.getTimeout(),0);
+    timestamp initial_timestep = timestamp(config.GetTimestepInMilliSeconds(),0);
+    if (0 == initial_timestep)
+    {
+        initial_timestep = timestamp(1,0);
+    }
+
+    bool variableTimestep = config.GetTimestepDecision();
+    timestamp max_timestep = timestamp(0,0);
+    timestamp min_timestamp = timestamp(0,0);
+
+    if (true == variableTimestep)
+    {
+        max_timestep  = timestamp(config.GetMaxTimestep() / 1000);
+        min_timestamp = timestamp(config.GetMinTimestep() / 1000);
+    }
 
+    this->init(get_sim_config(config), timeout, initial_timestep, variableTimestep, max_timestep, min_timestamp, config.GetIntegratorType());
+
+    /* Each noisy channel has its own stream of the run, so adding noise to one sensor does not change the noise of the others */
+    const uint64_t seed = config.GetNoiseSeed();
+    for (const auto &sensor : config.GetSensorConfigs())
+    {
+        const auto &sensor_config = sensor.second;
+        switch (sensor_config->type)
+        {
+            case SensorType::Gyroscope:
+            {
+                const GyroConfig *gyro_config = dynamic_cast<const GyroConfig*>(sensor_config.get());
+                this->gyroscope_angle_noise.reset(seed, (this->noise_stream << 2) | 0, gyro_config->noiseStdDev);
+                this->gyroscope_rate_noise.reset(seed, (this->noise_stream << 2) | 1, gyro_config->rateNoiseStdDev);
+                break;
+            }
+            case SensorType::Accelerometer:
+                this->accelerometer_noise.reset(seed, (this->noise_stream << 2) | 2, sensor_config->noiseStdDev);
+                break;
+        }
+    }
+}
+
+sim_config Simulator::get_sim_config(const Configuration &config)
+{
+    sim_config initial_values;
+    initial_values.satellite.alpha_b   = Eigen::Vector3f::Zero();
+    initial_values.satellite.omega_b   = config.GetSatelliteVelocity();
+    initial_values.satellite.theta_b   = config.GetSatellitePosition();
+    initial_values.satellite.inertia_b = config.GetSatelliteMoment();
+
+    for (const auto &sensor : config.GetSensorConfigs())
+    {
+        const auto & sensor_config = sensor.second;
+        switch(sensor_config->type)
+        {
+            case SensorType::Accelerometer:
+                initial_values.accelerometer.position = sensor_config->position;
+                initial_values.accelerometer.measurement = Eigen::Vector3f::Zero();
+                break;
+            case SensorType::Gyroscope:
+                initial_values.gyroscope.position = sensor_config->position;
+                initial_values.gyroscope.alpha = Eigen::Vector3f::Zero();
+                initial_values.gyroscope.omega = Eigen::Vector3f::Zero();
+                initial_values.gyroscope.theta = Eigen::Vector3f::Zero();
+                break;
+        }
+    }
+
+    /* Size the reaction wheel arrays up front, then fill one column per wheel */
+    Eigen::Index num_reaction_wheels = 0;
+    for (const auto &actuator : config.GetActuatorConfigs())
+    {
+        if (ActuatorType::ReactionWheel == actuator.second->type)
+        {
+            num_reaction_wheels++;
+        }
+    }
+
+    sim_reaction_wheels &wheels = initial_values.reaction_wheels;
+    wheels.omega.resize(num_reaction_wheels);
+    wheels.alpha.resize(num_reaction_wheels);
+    wheels.inertia.resize(num_reaction_wheels);
+    wheels.axis_of_rotation.resize(3, num_reaction_wheels);
+    wheels.position.resize(3, num_reaction_wheels);
+
+    /* Each wheel goes in the column of its id, so the devices can address it directly */
+    for (const auto &actuator : config.GetActuatorConfigs()) {
+        const auto & actuator_config = actuator.second;
+        switch(actuator_config->type)
+        {
+            case ActuatorType::ReactionWheel:
+            {
+                const ReactionWheelConfig* reaction_config = dynamic_cast<const ReactionWheelConfig*>(actuator_config.get());
+                const Eigen::Index wheel_num           = reaction_config->id;
+                wheels.alpha(wheel_num)                = reaction_config->acceleration;
+                wheels.omega(wheel_num)                = reaction_config->velocity;
+                wheels.inertia(wheel_num)              = reaction_config->momentOfInertia;
+                wheels.position.col(wheel_num)         = reaction_config->position;
+                wheels.axis_of_rotation.col(wheel_num) = reaction_config->axisOfRotation;
+            }
+        }
+    }
+    return initial_values;
+}
+
+void Simulator::rebuild_physics_context()
+{
+    const sim_reaction_wheels &wheels = this->system_vals.reaction_wheels;
+
+    this->physics.inertia_b_inverse = this->system_vals.satellite.inertia_b.inverse();
+    this->physics.rw_momentum_axes  = wheels.axis_of_rotation * wheels.inertia.asDiagonal();
+
+    /* Almost every satellite has 3 or 4 wheels, which get their own fixed size kernels */
+    switch (wheels.omega.size())
+    {
+        case 3:
+            this->sum_wheel_momentum = &sum_wheel_momentum_n<3>;
+            this->integrate_wheels   = &integrate_wheels_n<3>;
+            break;
+        case 4:
+            this->sum_wheel_momentum = &sum_wheel_momentum_n<4>;
+            this->integrate_wheels   = &integrate_wheels_n<4>;
+            break;
+        default:
+            this->sum_wheel_momentum = &sum_wheel_momentum_n<Eigen::Dynamic>;
+            this->integrate_wheels   = &integrate_wheels_n<Eigen::Dynamic>;
+            break;
+    }
+}
+
+timestamp Simulator::update_simulation() {
     return this->simulation_time;
 }
 
 void Simulator::determine_timestep() 
 {
+    ADCS_PROFILE_SCOPE(determine_timestep);
+
+    if (this->integrator->is_adaptive())
+    {
+        // standard step size controller: scale by (tolerance/error)^(1/order), limited to a factor of 5 either way
+        float scale = 5;
+        if (0 < this->last_step_error)
+        {
+            scale = 0.9 * std::pow(max_error_in_rad / this->last_step_error, 1 / this->integrator->order());
+            scale = std::min(5.0f, std::max(0.2f, scale));
+        }
+
+        timestamp t(this->timestep_length.to_seconds() * scale);
+
+        this->timestep_length = t;
+        if ((timestep_length > max_timestep))
+        {
+            this->timestep_length = max_timestep;
+        }
+        else if (timestep_length < min_timestamp)
+        {
+            this->timestep_length = min_timestamp;
+        }
+    }
     //2*max error is defined as 2*0.005 degrees = 0.01 degrees
-    if (true == this->variableTimestep)
+    else if (true == this->variableTimestep)
     {
-        // formula is: timestep = 2 * error / acceleration. Result is in seconds, *1000 to conver to ms
-        float calculated_timestep_in_ms = (2 * max_error_in_rad)/(this->system_vals.satellite.alpha_b.cwiseAbs().maxCoeff())*1000;
-        timestamp t(calculated_timestep_in_ms,0);
+        // formula is: timestep = 2 * error / acceleration. Result is in seconds
+        float calculated_timestep = (2 * max_error_in_rad)/(this->system_vals.satellite.alpha_b.cwiseAbs().maxCoeff());
+        timestamp t(calculated_timestep);
 
         this->timestep_length = t;
         if ((timestep_length > max_timestep))
@@ -75,108 +295,348 @@ void Simulator::determine_timestep()
 }
 
 timestamp Simulator::set_adcs_sleep(timestamp duration) {
-    timestamp time_passed = this->determine_time_passed();
-    this->simulate(time_passed + duration);
+    if (!this->advance_to(this->simulation_time + duration))
+    {
+        if (RunOutcome::Converged == this->outcome)
+        {
+            throw simulation_converged(this->outcome_message.c_str());
+        }
+        throw simulation_timeout(this->outcome_message.c_str());
+    }
 
     return this->simulation_time;
 }
 
-timestamp Simulator::determine_time_passed() {
-    if (this->last_called == -1) return 0;
+RunOutcome Simulator::run_task(const std::function<timestamp()> &task, timestamp until) {
+    while (RunOutcome::Running == this->outcome)
+    {
+        if (this->task_wake <= this->simulation_time)
+        {
+            timestamp sleep;
+            {
+                ADCS_PROFILE_SCOPE(controller_cycle);
+                sleep = task();
+            }
+            ADCS_PROFILE_COUNT(controller_cycles);
+
+            /* A task that asks to run again straight away waits for the next timestep, so time always moves on */
+            if (0 == sleep)
+            {
+                sleep = this->timestep_length;
+            }
+            this->task_wake = this->simulation_time + sleep;
+        }
 
-    using namespace std::chrono;
-    uint32_t ms = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
-    timestamp now = (timestamp) ms;
-    timestamp time_passed = now - this->last_called;
-    this->last_called = now;
-    return time_passed;
+        if (until <= this->simulation_time)
+        {
+            break;
+        }
+        this->advance_to(std::min(this->task_wake, until));
+    }
+
+    return this->outcome;
 }
 
-void Simulator::simulate(timestamp t) {
-    timestamp end = this->simulation_time + t;
+simulator_state Simulator::get_state() const {
+    simulator_state state;
+    state.system_vals     = this->system_vals;
+    this->sensors.derive_stale(&state.system_vals);
+    state.simulation_time = this->simulation_time;
+    state.timestep_length = this->timestep_length;
+    state.last_step_error = this->last_step_error;
+    state.noise_positions = {this->gyroscope_angle_noise.get_position(),
+                             this->gyroscope_rate_noise.get_position(),
+                             this->accelerometer_noise.get_position()};
+
+    auto events = this->scheduled_events;
+    while (!events.empty())
+    {
+        state.scheduled_events.push_back(events.top());
+        events.pop();
+    }
+
+    return state;
+}
+
+void Simulator::restore_state(const simulator_state &state) {
+    if (state.system_vals.reaction_wheels.omega.size() != this->system_vals.reaction_wheels.omega.size())
+    {
+        throw invalid_adcs_param("The checkpoint does not have the same number of reaction wheels as the configuration.");
+    }
+
+    this->system_vals     = state.system_vals;
+    this->sensors.reset();
+    this->timeout         = state.simulation_time + this->timeout;
+    this->simulation_time = state.simulation_time;
+    this->timestep_length = state.timestep_length;
+    this->last_step_error = state.last_step_error;
+
+    this->gyroscope_angle_noise.seek(state.noise_positions.gyroscope_angle);
+    this->gyroscope_rate_noise.seek(state.noise_positions.gyroscope_rate);
+    this->accelerometer_noise.seek(state.noise_positions.accelerometer);
+
+    this->scheduled_events = {};
+    for (timestamp event : state.scheduled_events)
+    {
+        this->scheduled_events.push(event);
+    }
+
+    this->next_checkpoint = this->simulation_time + this->checkpoint_period;
+
+    this->rebuild_physics_context();
+    this->messenger->resume_output_at(this->simulation_time);
+    this->schedule_periodic_tasks();
+}
+
+void Simulator::set_checkpoint_handler(timestamp period, std::function<void()> handler) {
+    this->checkpoint_period  = period;
+    this->next_checkpoint    = this->simulation_time + period;
+    this->checkpoint_handler = std::move(handler);
+    this->schedule_periodic_tasks();
+}
+
+void Simulator::schedule_periodic_tasks() {
+    this->tasks.set_due(this->telemetry_task, this->messenger->next_update_time(this->simulation_time));
+
+    const bool periodic_checkpoints = this->checkpoint_handler && (0 < this->checkpoint_period);
+    this->tasks.set_due(this->checkpoint_task, periodic_checkpoints ? this->next_checkpoint : RateScheduler::never);
+}
+
+void Simulator::schedule_event(timestamp time) {
+    if (this->simulation_time < time)
+    {
+        this->scheduled_events.push(time);
+    }
+}
+
+bool Simulator::advance_to(timestamp target) {
+    if (RunOutcome::Running != this->outcome)
+    {
+        return false;
+    }
+
+    while (this->simulation_time < target) {
+        /* Events already reached are done, the next one bounds this timestep */
+        while (!this->scheduled_events.empty() && (this->scheduled_events.top() <= this->simulation_time))
+        {
+            this->scheduled_events.pop();
+        }
+
+        timestamp next_stop = target;
+        if (!this->scheduled_events.empty() && (this->scheduled_events.top() < next_stop))
+        {
+            next_stop = this->scheduled_events.top();
+        }
+
+        /* In lockstep, the ticks received so far bound this timestep as well */
+        if (nullptr != this->pacer)
+        {
+            const timestamp allowed = this->pacer->limit(this->simulation_time);
+            if (allowed < next_stop)
+            {
+                next_stop = allowed;
+            }
+        }
 
-    while (this->simulation_time <= end) {
         this->determine_timestep();
-        this->simulation_time = this->simulation_time + this->timestep_length;
-        this->timestep();
-        this->messenger->update_simulation_state(this->system_vals, this->simulation_time, this->timestep_length);
-        
-        /* end simulation if the timeout is reached. */
-        if (this->timeout < this->simulation_time)
+
+        /* A zero length timestep would never reach the next stop */
+        if (0 == this->timestep_length)
+        {
+            this->timestep_length = timestamp::from_microseconds(1);
+        }
+
+        /**
+         * Shorten the timestep to land on the next stop. The planned timestep is kept for the
+         * next one, so a short step to an event does not slow down the rest of the run.
+        **/
+        const timestamp planned_timestep = this->timestep_length;
+        const timestamp remaining        = next_stop - this->simulation_time;
+        const bool      shortened        = (remaining < this->timestep_length);
+        if (shortened)
+        {
+            this->timestep_length = remaining;
+            ADCS_PROFILE_COUNT(shortened_timesteps);
+        }
+        ADCS_PROFILE_COUNT(timesteps);
+
+        if (nullptr == this->phase_times)
+        {
+            this->timestep();
+            this->simulation_time = this->simulation_time + this->timestep_length;
+            this->tasks.run_due(this->simulation_time);
+        }
+        else
+        {
+            const auto physics_start = std::chrono::steady_clock::now();
+            this->timestep();
+            this->simulation_time = this->simulation_time + this->timestep_length;
+            const auto io_start = std::chrono::steady_clock::now();
+            this->tasks.run_due(this->simulation_time);
+
+            this->phase_times->physics += io_start - physics_start;
+            this->phase_times->io      += std::chrono::steady_clock::now() - io_start;
+            this->phase_times->steps++;
+        }
+
+        if (shortened && (remaining == this->timestep_length))
         {
+            this->timestep_length = planned_timestep;
+        }
+
+        if (nullptr != this->pacer)
+        {
+            this->pacer->pace(this->simulation_time);
+        }
+
+        /* end simulation if the timeout is reached, the hold condition is met, or the messenger was asked to stop it. */
+        const bool stop_requested = this->messenger->stop_requested();
+        const bool converged      = (nullptr != this->convergence) &&
+                                    this->convergence->update(this->simulation_time, this->system_vals.satellite.theta_b, this->system_vals.satellite.omega_b);
+        if (stop_requested || converged || (this->timeout < this->simulation_time))
+        {
+            if (this->checkpoint_handler)
+            {
+                this->checkpoint_handler();
+            }
+
+            const auto io_start = std::chrono::steady_clock::now();
             this->messenger->write_output_buffer();
-            throw simulation_timeout("Timeout reached.");
+            if (nullptr != this->phase_times)
+            {
+                this->phase_times->io += std::chrono::steady_clock::now() - io_start;
+            }
+            if (converged)
+            {
+                this->outcome         = RunOutcome::Converged;
+                this->outcome_message = "Converged at " + this->simulation_time.pretty_string() + ", the target was held since " +
+                                        this->convergence->get_held_since().pretty_string() + ".";
+            }
+            else if (stop_requested)
+            {
+                this->outcome         = RunOutcome::Stopped;
+                this->outcome_message = "Stopped at " + this->simulation_time.pretty_string() + ": " + this->messenger->get_stop_reason();
+            }
+            else
+            {
+                this->outcome         = RunOutcome::TimedOut;
+                this->outcome_message = "Timeout reached.";
+            }
+            return false;
         }
     }
+
+    return true;
 }
 
 void Simulator::timestep() {
-    Eigen::Matrix3f inertia_b_inverse = system_vals.satellite.inertia_b.inverse();
-    Eigen::Vector3f sum_rw = Eigen::Vector3f::Zero();
-
-    for (sim_reaction_wheel &wheel : system_vals.reaction_wheels) {
-        
-        // This assumes that w_rw and I_rw are both scalars, and can thus be multiplied by the axis of rotation to achieve the right matrix dimensions
-        // change this if either w_rw or I_rw become a matrix!
-        sum_rw += (wheel.inertia * wheel.alpha * wheel.axis_of_rotation) 
-            + system_vals.satellite.omega_b.cross(wheel.axis_of_rotation * wheel.omega * wheel.inertia);
-
-
+    ADCS_PROFILE_SCOPE(timestep);
+
+    Satellite &satellite        = system_vals.satellite;
+    sim_reaction_wheels &wheels = system_vals.reaction_wheels;
+
+    // This assumes that w_rw and I_rw are both scalars, and can thus be multiplied by the axis of rotation to achieve the right matrix dimensions
+    // change this if either w_rw or I_rw become a matrix!
+    // Summed over every wheel, (I_rw * a_rw * axis) and (I_rw * w_rw * axis) are each a single
+    // product with the cached momentum axes.
+    rigid_body_dynamics dynamics;
+    dynamics.inertia_b         = satellite.inertia_b;
+    dynamics.inertia_b_inverse = physics.inertia_b_inverse;
+    this->sum_wheel_momentum(physics, wheels, &dynamics);
+
+    Satellite start = satellite;
+    float error = this->integrator->step(dynamics, this->timestep_length.to_seconds(), &satellite);
+
+    // Reject and retry steps that are too inaccurate, down to the minimum timestep
+    while ( this->integrator->is_adaptive()            &&
+            (max_error_in_rad < error)                  &&
+            (min_timestamp < this->timestep_length) )
+    {
+        float scale = std::max(0.2f, 0.9f * std::pow(max_error_in_rad / error, 1 / this->integrator->order()));
+        this->timestep_length = timestamp(this->timestep_length.to_seconds() * scale);
+        if (this->timestep_length < min_timestamp)
+        {
+            this->timestep_length = min_timestamp;
+        }
 
-        // Update reaction wheel velocity 
-        wheel.omega += wheel.alpha * (float) this->timestep_length;
-        //we need to consider alpha but this will be done by the controller
-        //wheel.alpha +=  rw_jerk * (float) this->timestep_length;
+        satellite = start;
+        error = this->integrator->step(dynamics, this->timestep_length.to_seconds(), &satellite);
     }
-    
-    system_vals.satellite.alpha_b = (-inertia_b_inverse * system_vals.satellite.omega_b).cross(system_vals.satellite.inertia_b * system_vals.satellite.omega_b)
-        - inertia_b_inverse * sum_rw;
+    this->last_step_error = error;
 
-    system_vals.satellite.omega_b += system_vals.satellite.alpha_b * (float) timestep_length;
-    system_vals.satellite.theta_b += system_vals.satellite.omega_b * (float) timestep_length;
+    // Update reaction wheel velocity 
+    this->integrate_wheels(&wheels, this->timestep_length.to_seconds());
+    //we need to consider alpha but this will be done by the controller
+    //wheel.alpha +=  rw_jerk * (float) this->timestep_length;
 
-    // Update new internal sensor and actuator values
-    system_vals.accelerometer.measurement = system_vals.satellite.alpha_b.cross(system_vals.accelerometer.position);
-    
-    system_vals.gyroscope.alpha = system_vals.satellite.alpha_b;
-    system_vals.gyroscope.omega = system_vals.satellite.omega_b;
-    system_vals.gyroscope.theta = system_vals.satellite.theta_b;
+    // The sensors are derived from the new state when they are next read
+    this->sensors.invalidate();
 
     return;
 }
 
-timestamp Simulator::reaction_wheel_update_desired_state(Eigen::Vector3f wheel_position, actuator_state new_target)
+timestamp Simulator::reaction_wheel_update_desired_state(uint32_t wheel_id, actuator_state new_target)
 {
-    // figure out what reaction wheel it is from the position vector
+    // Update the target state (For now just change the acceleration to match,
+    // when it reaches it's target position just change accel to 0)
+    this->system_vals.reaction_wheels.alpha(this->check_wheel_id(wheel_id)) = new_target.acceleration;
 
-    for (sim_reaction_wheel &wheel : system_vals.reaction_wheels) {
-        if (wheel.position.isApprox(wheel_position)) {
-            // Update the target state (For now just change the acceleration to match,
-            // when it reaches it's target position just change accel to 0)
-            wheel.alpha = new_target.acceleration;
-        }
+    return this->simulation_time;
+}
+
+actuator_state Simulator::reaction_wheel_get_current_state(uint32_t wheel_id)
+{
+    this->update_simulation();
+    const Eigen::Index i = this->check_wheel_id(wheel_id);
+
+    // Do some math to convert body-frame values to reaction_wheel_frame
+    actuator_state ret;
+    ret.position     = 0; // this isn't used anyway
+    ret.acceleration = this->system_vals.reaction_wheels.alpha(i);
+    ret.velocity     = this->system_vals.reaction_wheels.omega(i);
+    ret.time         = this->simulation_time;
+
+    return ret;
+}
+
+timestamp Simulator::reaction_wheels_update_desired_states(const Eigen::VectorXf &accelerations)
+{
+    sim_reaction_wheels &wheels = this->system_vals.reaction_wheels;
+    if (accelerations.size() != wheels.alpha.size())
+    {
+        throw invalid_dimensions_error("Number of reaction wheel targets does not match the number of reaction wheels.");
     }
 
-    //this->update_simulation();
+    wheels.alpha = accelerations;
+
     return this->simulation_time;
 }
 
-actuator_state Simulator::reaction_wheel_get_current_state(Eigen::Vector3f position)
+timestamp Simulator::reaction_wheels_get_current_states(Eigen::VectorXf *velocities, Eigen::VectorXf *accelerations)
 {
     this->update_simulation();
-    actuator_state ret;
-    // figure out which reaction wheel it is
-    for (sim_reaction_wheel wheel : system_vals.reaction_wheels) {
-        if (wheel.position.isApprox(position)) {
-            // Do some math to convert body-frame values to reaction_wheel_frame
-            // ret.position     = wheel.position; // this isn't used anyway
-            ret.acceleration = wheel.alpha;
-            ret.velocity     = wheel.omega;
-            ret.time         = this->simulation_time;
-        }
+
+    const sim_reaction_wheels &wheels = this->system_vals.reaction_wheels;
+    if (nullptr != velocities)
+    {
+        *velocities = wheels.omega;
+    }
+    if (nullptr != accelerations)
+    {
+        *accelerations = wheels.alpha;
     }
 
-    return ret;
+    return this->simulation_time;
+}
+
+Eigen::Index Simulator::check_wheel_id(uint32_t wheel_id) const
+{
+    if (this->system_vals.reaction_wheels.omega.size() <= wheel_id)
+    {
+        throw invalid_adcs_param("Reaction wheel id out of range.");
+    }
+
+    return static_cast<Eigen::Index>(wheel_id);
 }
 
 gyro_state Simulator::gyroscope_take_measurement()
@@ -184,18 +644,23 @@ gyro_state Simulator::gyroscope_take_measurement()
     this->update_simulation();
     gyro_state ret;
 
-    ret.acceleration = this->system_vals.gyroscope.alpha;
-    ret.velocity     = this->system_vals.gyroscope.omega;
-    ret.position     = this->system_vals.gyroscope.theta;
+    const sim_gyroscope &gyroscope = this->sensors.gyroscope();
+    ret.acceleration = gyroscope.alpha;
+    ret.velocity     = gyroscope.omega;
+    ret.position     = gyroscope.theta;
     ret.time_taken   = this->simulation_time;
 
+    this->gyroscope_angle_noise.add(&ret.position);
+    this->gyroscope_rate_noise.add(&ret.velocity);
+
     return ret;
 }
 
 timestamp Simulator::accelerometer_take_measurement(Eigen::Vector3f *measurement)
 {
     this->update_simulation();
-    *measurement = this->system_vals.accelerometer.measurement;
+    *measurement = this->sensors.accelerometer().measurement;
+    this->accelerometer_noise.add(measurement);
 
     return this->simulation_time;
 }
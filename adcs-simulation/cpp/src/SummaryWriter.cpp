@@ -0,0 +1,186 @@
+/**
+ * @file    SummaryWriter.cpp
+ *
+ * @details This file implements the SummaryWriter class as defined in SummaryWriter.hpp.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+#include <limits>
+
+#include "SummaryWriter.hpp"
+
+void SummaryWriter::open(const std::string &path, const std::vector<std::string> &column_names)
+{
+    this->output = nullptr;
+    if (this->output_file.is_open())
+    {
+        this->output_file.close();
+    }
+    this->output_buffer.clear();
+    this->output_buffer.str(std::string());
+
+    if (column_names.empty())
+    {
+        throw summary_write_error("Summary needs at least a time column.");
+    }
+
+    if (path.empty())
+    {
+        this->output = &this->output_buffer;
+    }
+    else
+    {
+        this->output_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!this->output_file.is_open())
+        {
+            throw summary_write_error(std::string("Unable to open file " + path).c_str());
+        }
+        this->output = &this->output_file;
+    }
+
+    this->value_columns = column_names.size() - 1;
+
+    bucket empty;
+    empty.rows       = 0;
+    empty.first_time = 0;
+    empty.last_time  = 0;
+    empty.min.assign(this->value_columns, std::numeric_limits<float>::infinity());
+    empty.max.assign(this->value_columns, -std::numeric_limits<float>::infinity());
+    this->levels.assign(num_levels, empty);
+
+    const uint32_t level_count = num_levels;
+    const uint32_t rows        = base_rows;
+    const uint32_t factor      = level_factor;
+    this->output->write(magic, sizeof(magic));
+    this->output->write(reinterpret_cast<const char*>(&format_version), sizeof(format_version));
+    this->output->write(reinterpret_cast<const char*>(&this->value_columns), sizeof(this->value_columns));
+    this->output->write(reinterpret_cast<const char*>(&rows),   sizeof(rows));
+    this->output->write(reinterpret_cast<const char*>(&factor), sizeof(factor));
+    this->output->write(reinterpret_cast<const char*>(&level_count), sizeof(level_count));
+
+    for (uint32_t i = 1; i < column_names.size(); i++)
+    {
+        const uint16_t name_length = std::min<size_t>(column_names.at(i).size(), UINT16_MAX);
+        this->output->write(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+        this->output->write(column_names.at(i).data(), name_length);
+    }
+
+    return;
+}
+
+void SummaryWriter::append_row(double time, const float *values)
+{
+    if (nullptr == this->output)
+    {
+        return;
+    }
+
+    bucket &base = this->levels.front();
+    if (0 == base.rows)
+    {
+        base.first_time = time;
+    }
+    base.last_time = time;
+    base.rows++;
+    for (uint32_t c = 0; c < this->value_columns; c++)
+    {
+        base.min[c] = std::min(base.min[c], values[c]);
+        base.max[c] = std::max(base.max[c], values[c]);
+    }
+
+    /* A full bucket is written and folded into the level above, which may fill it in turn */
+    uint32_t capacity = base_rows;
+    for (uint32_t level = 0; (level < num_levels) && (capacity == this->levels[level].rows); level++)
+    {
+        if (level + 1 < num_levels)
+        {
+            this->merge(this->levels[level], &this->levels[level + 1]);
+        }
+        this->write_bucket(level, &this->levels[level]);
+        capacity *= level_factor;
+    }
+
+    return;
+}
+
+void SummaryWriter::close(const std::string &path)
+{
+    if (nullptr == this->output)
+    {
+        return;
+    }
+
+    /* The unfinished buckets are folded upwards first, so every level covers the whole run */
+    for (uint32_t level = 0; level < num_levels; level++)
+    {
+        if (0 < this->levels[level].rows)
+        {
+            if (level + 1 < num_levels)
+            {
+                this->merge(this->levels[level], &this->levels[level + 1]);
+            }
+            this->write_bucket(level, &this->levels[level]);
+        }
+    }
+
+    if (this->output_file.is_open())
+    {
+        this->output_file.close();
+        if (this->output_file.fail())
+        {
+            this->output = nullptr;
+            throw summary_write_error("Unable to write the output summary.");
+        }
+    }
+    else if (!path.empty())
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            this->output = nullptr;
+            throw summary_write_error(std::string("Unable to open file " + path).c_str());
+        }
+        file << this->output_buffer.rdbuf();
+    }
+
+    this->output = nullptr;
+    this->output_buffer.clear();
+    this->output_buffer.str(std::string());
+
+    return;
+}
+
+void SummaryWriter::merge(const bucket &from, bucket *into)
+{
+    if (0 == into->rows)
+    {
+        into->first_time = from.first_time;
+    }
+    into->last_time = from.last_time;
+    into->rows     += from.rows;
+    for (uint32_t c = 0; c < this->value_columns; c++)
+    {
+        into->min[c] = std::min(into->min[c], from.min[c]);
+        into->max[c] = std::max(into->max[c], from.max[c]);
+    }
+}
+
+void SummaryWriter::write_bucket(uint32_t level, bucket *b)
+{
+    this->output->write(reinterpret_cast<const char*>(&level),         sizeof(level));
+    this->output->write(reinterpret_cast<const char*>(&b->rows),       sizeof(b->rows));
+    this->output->write(reinterpret_cast<const char*>(&b->first_time), sizeof(b->first_time));
+    this->output->write(reinterpret_cast<const char*>(&b->last_time),  sizeof(b->last_time));
+    this->output->write(reinterpret_cast<const char*>(b->min.data()),  sizeof(float) * this->value_columns);
+    this->output->write(reinterpret_cast<const char*>(b->max.data()),  sizeof(float) * this->value_columns);
+
+    b->rows = 0;
+    std::fill(b->min.begin(), b->min.end(), std::numeric_limits<float>::infinity());
+    std::fill(b->max.begin(), b->max.end(), -std::numeric_limits<float>::infinity());
+}
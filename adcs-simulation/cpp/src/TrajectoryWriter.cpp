@@ -0,0 +1,121 @@
+/**
+ * @file    TrajectoryWriter.cpp
+ *
+ * @details This file implements the TrajectoryWriter class as defined in TrajectoryWriter.hpp.
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <algorithm>
+
+#include "TrajectoryWriter.hpp"
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+    try
+    {
+        this->close();
+    }
+    catch (trajectory_write_error &e)
+    {
+        /* Nothing can be done about a failed write this late, the file is closed regardless. */
+    }
+}
+
+void TrajectoryWriter::open(const std::string &path, const std::vector<std::string> &column_names,
+                            uint32_t chunk_rows)
+{
+    this->close();
+
+    if (column_names.empty() || (0 == chunk_rows))
+    {
+        throw trajectory_write_error("Trajectory file needs at least a time column and a chunk size.");
+    }
+
+    this->output_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!this->output_file.is_open())
+    {
+        throw trajectory_write_error(std::string("Unable to open file " + path).c_str());
+    }
+
+    this->value_columns  = column_names.size() - 1;
+    this->chunk_capacity = chunk_rows;
+    this->buffered_rows  = 0;
+    this->time_column.assign(chunk_rows, 0);
+    this->value_columns_data.assign((size_t) chunk_rows * this->value_columns, 0);
+
+    const uint32_t num_columns = column_names.size();
+    this->output_file.write(magic, sizeof(magic));
+    this->output_file.write(reinterpret_cast<const char*>(&format_version), sizeof(format_version));
+    this->output_file.write(reinterpret_cast<const char*>(&num_columns),    sizeof(num_columns));
+    this->output_file.write(reinterpret_cast<const char*>(&chunk_rows),     sizeof(chunk_rows));
+
+    for (uint32_t i = 0; i < num_columns; i++)
+    {
+        const uint8_t  type        = (0 == i) ? 'd' : 'f';
+        const uint16_t name_length = std::min<size_t>(column_names.at(i).size(), UINT16_MAX);
+
+        this->output_file.write(reinterpret_cast<const char*>(&type),        sizeof(type));
+        this->output_file.write(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+        this->output_file.write(column_names.at(i).data(), name_length);
+    }
+
+    return;
+}
+
+void TrajectoryWriter::append_row(double time, const float *values)
+{
+    this->time_column[this->buffered_rows] = time;
+    for (uint32_t c = 0; c < this->value_columns; c++)
+    {
+        this->value_columns_data[(size_t) c * this->chunk_capacity + this->buffered_rows] = values[c];
+    }
+    this->buffered_rows++;
+
+    if (this->chunk_capacity == this->buffered_rows)
+    {
+        this->write_chunk();
+    }
+
+    return;
+}
+
+void TrajectoryWriter::close()
+{
+    if (this->output_file.is_open())
+    {
+        this->write_chunk();
+        this->output_file.close();
+    }
+
+    return;
+}
+
+void TrajectoryWriter::write_chunk()
+{
+    if (0 == this->buffered_rows)
+    {
+        return;
+    }
+
+    this->output_file.write(reinterpret_cast<const char*>(&this->buffered_rows), sizeof(this->buffered_rows));
+    this->output_file.write(reinterpret_cast<const char*>(this->time_column.data()),
+                            sizeof(double) * this->buffered_rows);
+    for (uint32_t c = 0; c < this->value_columns; c++)
+    {
+        this->output_file.write(reinterpret_cast<const char*>(&this->value_columns_data[(size_t) c * this->chunk_capacity]),
+                                sizeof(float) * this->buffered_rows);
+    }
+    this->buffered_rows = 0;
+
+    if (!this->output_file.good())
+    {
+        throw trajectory_write_error("Failed to write trajectory chunk to disk.");
+    }
+
+    return;
+}
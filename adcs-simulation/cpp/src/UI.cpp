@@ -6,7 +6,7 @@
  * @authors Aidan Sheedy, Lily de Loe
  *
  * Last Edited
- * 2022-11-19
+ * 2026-10-14
  *
 **/
 
@@ -18,18 +18,21 @@
 #include <sstream>
 #include <fstream>
 #include <filesystem>
-#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <unistd.h> 
 #include <sys/wait.h>
 
 #include "Python.h"
 #include "UI.hpp"
-#include "Simulator.hpp"
-#include "PointingModeController.hpp"
 #include "ConfigurationSingleton.hpp"
-#include "SensorActuatorFactory.hpp"
-#include "DummyController.hpp"
+#include "SimulationRun.hpp"
+#include "BatchRunner.hpp"
+#include "GainTuner.hpp"
+#include "Benchmark.hpp"
+#include "ValidationSink.hpp"
 
 UI::UI()
 {
@@ -41,6 +44,9 @@ UI::UI()
     allowed_commands["unit_test"]   = std::bind(&UI::run_unit_tests,    this, std::placeholders::_1);
     allowed_commands["perf_test"]   = std::bind(&UI::run_perf_tests,    this, std::placeholders::_1);
     allowed_commands["clean_plots"] = std::bind(&UI::clean_plots,       this, std::placeholders::_1);
+    allowed_commands["batch_sim"]   = std::bind(&UI::run_batch,         this, std::placeholders::_1);
+    allowed_commands["tune_gains"]  = std::bind(&UI::run_tuning,        this, std::placeholders::_1);
+    allowed_commands["build_env"]   = std::bind(&UI::build_environment, this, std::placeholders::_1);
     allowed_commands["help"]        = std::bind(&UI::help,              this, std::placeholders::_1);
 
     /* Aliases */
@@ -51,6 +57,9 @@ UI::UI()
     allowed_commands["ut"] = std::bind(&UI::run_unit_tests,    this, std::placeholders::_1);
     allowed_commands["pt"] = std::bind(&UI::run_perf_tests,    this, std::placeholders::_1);
     allowed_commands["cp"] = std::bind(&UI::clean_plots,       this, std::placeholders::_1);
+    allowed_commands["bs"] = std::bind(&UI::run_batch,         this, std::placeholders::_1);
+    allowed_commands["tg"] = std::bind(&UI::run_tuning,        this, std::placeholders::_1);
+    allowed_commands["be"] = std::bind(&UI::build_environment, this, std::placeholders::_1);
 }
 
 void UI::help(std::vector<std::string> args)
@@ -150,126 +159,39 @@ void UI::run_simulation(std::vector<std::string> args)
 {
     this->parse_run_sim_args(args);
 
-    Configuration &config = Configuration::GetInstance();
+    /**
+     * If 2 yaml paths are provided, run the controller with the exit conditions from the
+     * second yaml. Otherwise, the dummy controller runs until the time runs out.
+    **/
+    std::shared_ptr<const Configuration> config = Configuration::Load(this->config_yaml_path, this->exit_conditions_yaml_path);
 
-    if (!config.Load(this->config_yaml_path))
+    if (!config)
     {
         throw invalid_ui_args("Configuration failed to load");
     }
     else
     {
-        /* Empty simulator */
-        Simulator simulator(&messenger);
-
-        /* Initialize Interface Objects */
-        std::unordered_map<std::string, std::shared_ptr<Sensor>> sensors;
-        std::unordered_map<std::string, std::shared_ptr<Actuator>> actuators;
-
-        /* Get Simulation config info */
-        timestamp timeout(config.getTimeout(),0);
-        timestamp initial_timestep = timestamp(config.GetTimestepInMilliSeconds(),0);
-        if (0 == initial_timestep)
+        SimulationRun run(config, &messenger);
+        run.set_trace_path(this->trace_path);
+        run.set_stop_on_convergence(!this->run_to_timeout);
+        run.set_execution_mode(this->execution_mode, this->real_time_factor, this->tick_path);
+        run.set_checkpoint_output(this->checkpoint_path, this->checkpoint_period);
+        if (!this->resume_checkpoint_path.empty())
         {
-            initial_timestep = timestamp(1,0);
-        }
-
-        bool variableTimestep = config.GetTimestepDecision();
-        timestamp max_timestep = timestamp(0,0);
-        timestamp min_timestamp = timestamp(0,0);
-
-        if (true == variableTimestep)
-        {
-            max_timestep = config.GetMaxTimestep();
-            min_timestamp = config.GetMinTimestep();
-        }
-
-        simulator.init(this->get_sim_config(config), timeout, initial_timestep, variableTimestep, max_timestep, min_timestamp);
-
-        /* Timer used for control code */
-        ADCS_timer timer(&simulator);
-
-        /**
-         * If 2 yaml paths are provided, initialize controller with second yaml. Otherwise,
-         * initialize the dummy controller to run until the time runs out. 
-        **/
-        if ("" == this->exit_conditions_yaml_path)
-        {
-            this->messenger.send_message("No exit yaml supplied for controller. Will run sim with no controller until timeout.");
-
-            DummyController controller(&timer);
-
-            try
-            {
-                controller.begin();
-                messenger.send_message("Simulation timed out before the simulation finished.");
-            }
-            catch (simulation_timeout &e)
-            {
-                messenger.send_message(e.message());
-
-            }
-        }
-        else
-        {
-            for (const auto &sensor : config.GetSensorConfigs())
-            {
-                //first is string, second is data (from map)
-                this->create_sensor(sensor.first, &simulator, &sensors);
-            }
-
-            for (const auto &actuator : config.GetActuatorConfigs()) {
-                //first is string, second is data (from map)
-                this->create_actuator(actuator.first, &simulator, &actuators);
-            }
-
-            // string exit_conditions_yaml = args.at(2);
-            if (!config.load_exit_file(this->exit_conditions_yaml_path))
-            {
-                messenger.send_error("Exit conditions failed to load");
-            }
-            else
-            {
-                Eigen::Vector3f final_sat_position  = config.getDesiredSatellitePosition();
-#if 0
-                // to be implemented later
-                float allowed_jitter                = config.getAllowedJitter();
-                float required_accuracy             = config.getRequiredAccuracy();
-                int required_hold_time              = config.getHoldTime();
-#endif
-
-                /* Start control code */
-                PointingModeController controller(sensors, actuators, &timer);
-
-                try
-                {
-                    timestamp ramp_time(0, 30);
-                    controller.begin(final_sat_position, ramp_time);
-                }
-                catch (simulation_timeout &e)
-                {
-                    messenger.send_message(e.message());
-                }
-            }
+            run.set_resume_checkpoint(std::make_shared<const sim_checkpoint>(Checkpoint::read(this->resume_checkpoint_path)));
         }
+        run.execute();
 
         /* Cleanup After simulation */
         messenger.reset_defaults();
 
-        /**
-         * @todo create final_state_yaml 
-        **/ 
-
-        /* This code should not be deleted - it will be necessary when the final_state_yaml is implemented. */
-        // string final_state_yaml_path;
-
-        // if (!final_state_yaml_path.empty())
-        // {
-        //     /* TODO this could also check if the yaml is a valid path, but race condition again. Still,
-        //      * in this case it is probably worth checking because there's no point in saving it as a
-        //      * variable if it's invalid to start with.
-        //     **/
-        //     this->previous_end_state_yaml = final_state_yaml_path;
-        // }
+        /* Remember the checkpoint so resume_sim can continue this run */
+        if (!this->checkpoint_path.empty())
+        {
+            this->previous_checkpoint  = this->checkpoint_path;
+            this->previous_config_yaml = this->config_yaml_path;
+            this->previous_exit_yaml   = this->exit_conditions_yaml_path;
+        }
 
         //call the python script from inside C++
         if (!silent_plots)
@@ -285,6 +207,14 @@ void UI::run_simulation(std::vector<std::string> args)
 void UI::reset_simulation_argument_defaults()
 {
     this->silent_plots = this->default_silent_plots;
+    this->trace_path   = "";
+    this->run_to_timeout = false;
+    this->execution_mode   = ExecutionMode::AsFastAsPossible;
+    this->real_time_factor = 1;
+    this->tick_path        = "";
+    this->checkpoint_path        = Checkpoint::get_default_path();
+    this->checkpoint_period      = timestamp();
+    this->resume_checkpoint_path = "";
 }
 
 void UI::plot_simulation_results(std::string csv_path_in)
@@ -299,6 +229,9 @@ void UI::plot_simulation_results(std::string csv_path_in)
             if (0 == fork_ret)
             {
                 execv(args[0], args);
+
+                /* Only reached if the plotter could not be started. The child must not return to the terminal. */
+                _exit(EXIT_FAILURE);
             }
             else
             {
@@ -397,6 +330,110 @@ void UI::parse_run_sim_args(std::vector<std::string> args)
                 this->silent_plots = true;
                 args.pop_back();
             }
+            else if ( ("--run_to_timeout" == args.back()) ||
+                      ("-rto"             == args.back()))
+            {
+                this->run_to_timeout = true;
+                args.pop_back();
+            }
+            else if ( ("--binary" == args.back()) ||
+                      ("-b"       == args.back()))
+            {
+                messenger.set_output_format(OutputFormat::Binary);
+                args.pop_back();
+            }
+            else if ( ("--drop_telemetry" == args.back()) ||
+                      ("-dt"              == args.back()))
+            {
+                messenger.set_backpressure_policy(BackpressurePolicy::Drop);
+                args.pop_back();
+            }
+            else if ( ("--shared_memory" == args.back()) ||
+                      ("-shm"            == args.back()))
+            {
+                args.pop_back();
+                if (0 == args.size())
+                {
+                    throw invalid_ui_args("Missing shared memory name.");
+                }
+                messenger.set_shared_memory_output(args.back());
+                args.pop_back();
+            }
+            else if ( ("--trace" == args.back()) ||
+                      ("-tr"     == args.back()))
+            {
+                args.pop_back();
+                if (0 == args.size())
+                {
+                    throw invalid_ui_args("Missing profile trace path.");
+                }
+                this->trace_path = args.back();
+                args.pop_back();
+            }
+            else if ( ("--paced" == args.back()) ||
+                      ("-rt"      == args.back()))
+            {
+                args.pop_back();
+                if (0 == args.size())
+                {
+                    throw invalid_ui_args("Missing real time factor.");
+                }
+                try
+                {
+                    this->real_time_factor = std::stod(args.back());
+                }
+                catch (std::invalid_argument &e)
+                {
+                    throw invalid_ui_args("Invalid real time factor.");
+                }
+                if (!(0 < this->real_time_factor))
+                {
+                    throw invalid_ui_args("The real time factor must be greater than 0.");
+                }
+                this->execution_mode = ExecutionMode::Paced;
+                args.pop_back();
+            }
+            else if ( ("--lockstep" == args.back()) ||
+                      ("-ls"        == args.back()))
+            {
+                args.pop_back();
+                if (0 == args.size())
+                {
+                    throw invalid_ui_args("Missing tick file path.");
+                }
+                this->tick_path      = args.back();
+                this->execution_mode = ExecutionMode::Lockstep;
+                args.pop_back();
+            }
+            else if ( ("--checkpoint" == args.back()) ||
+                      ("-ck"          == args.back()))
+            {
+                args.pop_back();
+                if (0 == args.size())
+                {
+                    throw invalid_ui_args("Missing checkpoint path.");
+                }
+                this->checkpoint_path = ("none" == args.back()) ? "" : args.back();
+                args.pop_back();
+            }
+            else if ( ("--checkpoint_rate" == args.back()) ||
+                      ("-cr"               == args.back()))
+            {
+                args.pop_back();
+                if (0 < args.size())
+                {
+                    try
+                    {
+                        uint32_t checkpoint_rate = std::stoi(args.back());
+                        this->checkpoint_period = timestamp(checkpoint_rate, 0);
+                    }
+                    catch (std::invalid_argument &e)
+                    {
+                        throw invalid_ui_args("Invalid checkpoint rate.");
+                    }
+                    args.pop_back();
+                }
+            }
             else
             {
                 throw invalid_ui_args(std::string("bad parameter: " + args.back()).c_str());
@@ -407,112 +444,118 @@ void UI::parse_run_sim_args(std::vector<std::string> args)
     return;
 }
 
-void UI::create_sensor(const std::string &name, Simulator *sim,
-                       std::unordered_map<std::string, std::shared_ptr<Sensor>> *sensors)
+void UI::run_batch(std::vector<std::string> args)
 {
-    if (name.empty()) {
-        std::cout <<"Device name must be populated. Got " << name << std::endl;
-        return;
+    if (num_batch_args != args.size())
+    {
+        throw invalid_ui_args("Invalid number of arguments.");
     }
 
-    auto sensorPtr = SensorActuatorFactory::GetSensor(name, sim);
-    if (!sensorPtr) {
-        std::cout << "Unknown sensor type: " << name << std::endl;
-        return;
+    BatchRunner batch(args.at(1), &messenger);
+    batch.run();
+
+    return;
+}
+
+void UI::run_tuning(std::vector<std::string> args)
+{
+    if (num_tuning_args != args.size())
+    {
+        throw invalid_ui_args("Invalid number of arguments.");
     }
 
-    (*sensors)[name] = std::move(sensorPtr);
+    GainTuner tuner(args.at(1), &messenger);
+    tuner.run();
+
+    return;
 }
 
-void UI::create_actuator(const std::string &name, Simulator *sim,
-                         std::unordered_map<std::string, std::shared_ptr<Actuator>> *actuators) {
-    if (name.empty()) {
-        std::cout << "Device name must be populated. Got " << name << std::endl;
-        return;
+void UI::build_environment(std::vector<std::string> args)
+{
+    if (num_build_environment_args != args.size())
+    {
+        throw invalid_ui_args("Invalid number of arguments.");
     }
 
-    auto actPtr = SensorActuatorFactory::GetActuator(name, sim);
-    if (!actPtr) {
-        std::cout << "Unknown actuator type: " << name << std::endl;
-        return;
+    std::shared_ptr<const Configuration> config = Configuration::Load(args.at(1));
+    if (!config)
+    {
+        throw invalid_ui_args("Configuration failed to load");
+    }
+    if (!config->GetEnvironment().enabled)
+    {
+        throw invalid_ui_args("The config yaml has no Environment section.");
     }
 
-    (*actuators)[name] = std::move(actPtr);
+    /* The table always evaluates the models, even if the config names a table to map */
+    environment_config environment = config->GetEnvironment();
+    environment.table_path.clear();
+
+    const timestamp duration(config->getTimeout(), 0);
+    std::shared_ptr<const EnvironmentTable> table = EnvironmentTable::build(environment, duration);
+    table->write(args.at(2));
+
+    messenger.send_message("Wrote the environment table to " + args.at(2) + ", covering " + duration.pretty_string());
+
+    return;
 }
 
-sim_config UI::get_sim_config(Configuration &config)
+void UI::resume_simulation(std::vector<std::string> args)
 {
-    sim_config initial_values;
-    Satellite temp;
-    initial_values.satellite.alpha_b   = Eigen::Vector3f::Zero();
-    initial_values.satellite.omega_b   = config.GetSatelliteVelocity();
-    initial_values.satellite.theta_b   = config.GetSatellitePosition();
-    initial_values.satellite.inertia_b = config.GetSatelliteMoment();
-
-    for (const auto &sensor : config.GetSensorConfigs())
+    for (std::string arg : args)
     {
-        const auto & sensor_config = config.GetSensorConfig(sensor.first);
-        switch(sensor_config->type)
+        if (arg.empty())
         {
-            case SensorType::Accelerometer:
-                initial_values.accelerometer.position = sensor_config->position;
-                initial_values.accelerometer.measurement = Eigen::Vector3f::Zero();
-                break;
-            case SensorType::Gyroscope:
-                initial_values.gyroscope.position = sensor_config->position;
-                initial_values.gyroscope.alpha = Eigen::Vector3f::Zero();
-                initial_values.gyroscope.omega = Eigen::Vector3f::Zero();
-                initial_values.gyroscope.theta = Eigen::Vector3f::Zero();
-                break;
+            throw invalid_ui_args("Argument string empty!");
         }
     }
 
-    for (const auto &actuator : config.GetActuatorConfigs()) {
-        const auto & actuator_config = config.GetActuatorConfig(actuator.first);
-        switch(actuator_config->type)
+    /* Rebuild the arguments as a start_sim command, with the yamls the checkpoint was made with. */
+    std::vector<std::string> new_args = {args.at(0)};
+    std::string checkpoint;
+    size_t next_arg = 1;
+
+    if ((next_arg < args.size()) && ('-' != args.at(next_arg).at(0)))
+    {
+        checkpoint = args.at(next_arg++);
+        if ((next_arg >= args.size()) || ('-' == args.at(next_arg).at(0)))
         {
-            case ActuatorType::ReactionWheel:
-            {
-                const ReactionWheelConfig* reaction_config = dynamic_cast<const ReactionWheelConfig*>(actuator_config.get());
-                sim_reaction_wheel initial_reac_values;
-                initial_reac_values.alpha = reaction_config->acceleration;
-                initial_reac_values.omega = reaction_config->velocity;
-                initial_reac_values.inertia  = reaction_config->momentOfInertia;
-                initial_reac_values.position = reaction_config->position;
-                initial_reac_values.axis_of_rotation = reaction_config->axisOfRotation;
-                initial_values.reaction_wheels.push_back(initial_reac_values);
-            }
+            throw invalid_ui_args("A config YAML path must follow the checkpoint path.");
+        }
+        new_args.push_back(args.at(next_arg++));
+        if ((next_arg < args.size()) && ('-' != args.at(next_arg).at(0)))
+        {
+            new_args.push_back(args.at(next_arg++));
         }
     }
-    return initial_values;
-}
-
-void UI::resume_simulation(std::vector<std::string> args)
-{
-    messenger.send_error("Command not implemented.");
-    (void)args; // silences compiler warning about unused parameter
-#if 0
-    if (num_resume_simulation_args != args.size())
+    else if (this->previous_checkpoint.empty())
     {
-        throw invalid_ui_args("Invalid number of arguments.");
+        throw invalid_ui_args("No previous simulation to resume. Provide a checkpoint and config YAML.");
     }
-
-    for (std::string arg : args)
+    else
     {
-        if (arg.empty())
+        checkpoint = this->previous_checkpoint;
+        new_args.push_back(this->previous_config_yaml);
+        if (!this->previous_exit_yaml.empty())
         {
-            throw invalid_ui_args("Argument string empty!");
+            new_args.push_back(this->previous_exit_yaml);
         }
     }
 
-    /* Use previous final state yaml as new initial state**/
-    std::vector<std::string> new_args = {
-        "unused",
-        this->previous_end_state_yaml,
-        args.at(1)
-    };
-    this->run_simulation(new_args);
-#endif
+    new_args.insert(new_args.end(), args.begin() + next_arg, args.end());
+
+    this->resume_checkpoint_path = checkpoint;
+    try
+    {
+        this->run_simulation(new_args);
+    }
+    catch (adcs_exception &)
+    {
+        this->reset_simulation_argument_defaults();
+        throw;
+    }
+
+    return;
 }
 
 void UI::quit(std::vector<std::string> args)
@@ -523,6 +566,7 @@ void UI::quit(std::vector<std::string> args)
     }
 
     messenger.send_message("exiting.");
+    messenger.close_shared_memory();
     exit(0);
 }
 
@@ -572,120 +616,93 @@ void UI::run_no_controller_unit_tests(std::vector<std::string> args)
         throw invalid_ui_args("Invalid number of arguments.");
     }
 
-    /* Generate arguments to pass to the simulation (yaml path is left empty) */
-    std::vector<std::string> sim_args = 
-    {
-        "start_sim",
-        "",
-        "-s",
-        "-sp"
-    };
-
     std::vector<std::string> co_args = {"clean_out"};
 
     messenger.send_message("Controllerless tests", text_colour.cyan);
 
-    for (uint8_t test_num = 1; test_num <= num_no_controller_unit_tests; test_num++)
-    {
-        /* Clean all outputs before running */
-        this->clean_out(co_args);
+    /* Clean all outputs before running */
+    this->clean_out(co_args);
 
-        /* Run Simulation */
-        std::string yaml_path = expected_no_controller_unit_test_dir + unit_test_name + std::to_string(test_num) + yaml_extension;
-        sim_args.at(1) = yaml_path;
+    /* Every test has its own messenger and sink, so the tests can run on separate threads */
+    std::vector<std::unique_ptr<ValidationSink>> sinks(num_no_controller_unit_tests);
+    std::vector<std::string>                     errors(num_no_controller_unit_tests);
+    std::vector<std::function<void()>>           jobs;
 
-        messenger.send_message("Unit Test " + std::to_string(test_num) + ":", text_colour.cyan);
-        this->run_simulation(sim_args);
-
-        /* Parse the results file for accelerations */
-        std::ifstream out_file(messenger.get_default_csv_output_file());
-        if (!out_file.is_open())
+    for (uint8_t test_num = 1; test_num <= num_no_controller_unit_tests; test_num++)
+    {
+        jobs.push_back([this, test_num, &sinks, &errors]()
         {
-            throw invalid_ui_args("Unable to open output path to compare with expected results.");
-        }
+            const size_t i = test_num - 1;
+            try
+            {
+                const std::string yaml_path     = expected_no_controller_unit_test_dir + unit_test_name + std::to_string(test_num) + yaml_extension;
+                const std::string expected_path = expected_results_dir + unit_test_name + std::to_string(test_num) + csv_extension;
 
-        /* Find which columns contain the accelerations*/
-        std::string line;
-        std::string column_name;
+                std::shared_ptr<const Configuration> config = Configuration::Load(yaml_path, "");
+                if (!config)
+                {
+                    throw invalid_ui_args("Configuration failed to load");
+                }
 
-        std::getline(out_file, line);
-        std::stringstream ss(line);
+                Messenger run_messenger;
+                run_messenger.silence_messages();
+                run_messenger.silence_sim_prints();
+                run_messenger.silence_csv();
 
-        bool alpha_column_found = false;
-        int alpha_column_num = 0;
+                sinks.at(i) = std::make_unique<ValidationSink>(ValidationSink::read_expected_alphas(expected_path, num_validated_timesteps),
+                                                               unit_test_relative_tolerance, unit_test_absolute_tolerance,
+                                                               &run_messenger);
+                run_messenger.add_telemetry_sink(sinks.at(i).get());
 
-        while( std::getline(ss, column_name, ',') &&
-               (!alpha_column_found) )
-        {
-            if (std::string::npos != column_name.find("alpha x"))
+                SimulationRun run(config, &run_messenger);
+                run.execute();
+            }
+            catch (adcs_exception &e)
             {
-                alpha_column_found = true;
-                alpha_column_num--;
+                errors.at(i) = e.message();
             }
-            alpha_column_num++;
-        }
-
-        if (!alpha_column_found)
-        {
-            throw invalid_ui_args("Unable to find satellite acceleration column in output file.");
-        }
-
-        /* Extract the first column */
-        Eigen::Vector3f first_timestep_alphas;
-
-        std::getline(out_file, line);
-        ss = std::stringstream(line);
-        std::string contents;
+            catch (std::exception &e)
+            {
+                errors.at(i) = e.what();
+            }
+        });
+    }
 
-        int column;
-        for (column = 0; (column < alpha_column_num)  && std::getline(ss, contents, ','); column++) {}
+    this->run_in_parallel(jobs);
 
-        if (column != (alpha_column_num ))
-        {
-            throw invalid_ui_args("Data corrupted.");
-        }
+    for (uint8_t test_num = 1; test_num <= num_no_controller_unit_tests; test_num++)
+    {
+        const size_t i = test_num - 1;
+        messenger.send_message("Unit Test " + std::to_string(test_num) + ":", text_colour.cyan);
 
-        for (int j = 0; (j < 3)  && std::getline(ss, contents, ','); j++)
+        if (!errors.at(i).empty())
         {
-            first_timestep_alphas[j] = std::stof(contents);
+            messenger.send_message("FAIL", text_colour.red);
+            messenger.send_message(errors.at(i) + "\n", text_colour.yellow);
         }
-
-        out_file.close();
-
-        /* Find expected results */
-        std::ifstream expected_result_file(expected_results_dir + unit_test_name + std::to_string(test_num) + csv_extension);
-
-        /* Ignore header line */
-        std::getline(expected_result_file, line);
-        std::getline(expected_result_file, line);
-        ss = std::stringstream(line);
-
-        Eigen::Vector3f expected_alphas;
-
-        for (int j = 0; (j < 3)  && std::getline(ss, contents, ','); j++)
-        {
-            expected_alphas[j] = std::stof(contents);
-        }
-
-        expected_result_file.close();
-
-        Eigen::Vector3f diff = expected_alphas - first_timestep_alphas;
-        Eigen::Vector3f tollerance = {0.01,0,0};
-
-        if (diff.isMuchSmallerThan(tollerance))
+        else if (sinks.at(i)->passed())
         {
             messenger.send_message("PASS\n", text_colour.green);
         }
-        else
+        else if (sinks.at(i)->failed())
         {
+            const validation_failure &failure = sinks.at(i)->get_failure();
+
             messenger.send_message("FAIL", text_colour.red);
             std::stringstream msg;
-            msg << "Expected: [" << expected_alphas.x() << "," << expected_alphas.y() << "," << expected_alphas.z() << "] ";
-            msg << "Actual: [" << first_timestep_alphas.x() << "," << first_timestep_alphas.y() << "," << first_timestep_alphas.z() << "] ";
+            msg << "Timestep " << failure.timestep << " (" << failure.time.pretty_string() << ") ";
+            msg << "Expected: [" << failure.expected.x() << "," << failure.expected.y() << "," << failure.expected.z() << "] ";
+            msg << "Actual: [" << failure.actual.x() << "," << failure.actual.y() << "," << failure.actual.z() << "] ";
             msg << std::endl;
 
             messenger.send_message(msg.str(), text_colour.yellow);
         }
+        else
+        {
+            messenger.send_message("FAIL", text_colour.red);
+            messenger.send_message("The run ended after " + std::to_string(sinks.at(i)->num_checked()) + " of " +
+                                   std::to_string(num_validated_timesteps) + " expected timesteps.\n", text_colour.yellow);
+        }
     }
 }
 
@@ -703,119 +720,110 @@ void UI::run_controller_unit_tests(std::vector<std::string> args)
     this->clean_out(co_args);
 
     /**
-     * Generate arguments to pass to the simulation (yaml paths left empty) 
-     * csv file is written every 100 milliseconds (sim time)
-     * terminal is written every 100 seconds (sim time)
+     * Every test writes its own csv, every 100 milliseconds (sim time), so the tests can run on
+     * separate threads. The terminal prints of parallel runs would interleave, so they are silenced.
     **/
-    std::vector<std::string> sim_args = 
-    {
-        "start_sim",
-        "",
-        "",
-        "-c",
-        "100",
-        "-p",
-        "100000",
-        "-sp"
-    };
+    std::vector<std::string>           output_paths(num_controller_unit_tests);
+    std::vector<std::string>           errors(num_controller_unit_tests);
+    std::vector<std::function<void()>> jobs;
 
     for (uint8_t test_num = 1; test_num <= num_controller_unit_tests; test_num++)
     {
-        /* setup arguments */
-        std::string config_yaml_path = expected_controller_unit_test_dir + ut_controller_config_name + std::to_string(test_num) + yaml_extension;
-        std::string exit_yaml_path   = expected_controller_unit_test_dir + ut_controller_exit_name   + std::to_string(test_num) + yaml_extension;
-
-        sim_args.at(1) = config_yaml_path;
-        sim_args.at(2) = exit_yaml_path;
+        output_paths.at(test_num - 1) = messenger.get_default_csv_output_path() + controller_test_output_name + std::to_string(test_num) + csv_extension;
 
-        messenger.send_message("\nUnit Test " + std::to_string(test_num) + ":", text_colour.cyan);
-        this->run_simulation(sim_args);
+        jobs.push_back([this, test_num, &output_paths, &errors]()
+        {
+            const size_t i = test_num - 1;
+            try
+            {
+                const std::string config_yaml_path = expected_controller_unit_test_dir + ut_controller_config_name + std::to_string(test_num) + yaml_extension;
+                const std::string exit_yaml_path   = expected_controller_unit_test_dir + ut_controller_exit_name   + std::to_string(test_num) + yaml_extension;
 
-        std::string new_name = (messenger.get_default_csv_output_path() + controller_test_output_name + std::to_string(test_num) + csv_extension);
+                std::shared_ptr<const Configuration> config = Configuration::Load(config_yaml_path, exit_yaml_path);
+                if (!config)
+                {
+                    throw invalid_ui_args("Configuration failed to load");
+                }
 
-        std::filesystem::path output_path     = std::filesystem::current_path() / messenger.get_default_csv_output_file();
-        std::filesystem::path new_output_path = std::filesystem::current_path() / new_name;
+                Messenger run_messenger;
+                run_messenger.silence_messages();
+                run_messenger.silence_sim_prints();
+                run_messenger.set_csv_print_rate(controller_test_csv_rate);
+                run_messenger.set_output_path(output_paths.at(i));
 
-        std::filesystem::rename(output_path, new_output_path);
-        this->plot_simulation_results(new_output_path.string());
+                SimulationRun run(config, &run_messenger);
+                run.execute();
+            }
+            catch (adcs_exception &e)
+            {
+                errors.at(i) = e.message();
+            }
+            catch (std::exception &e)
+            {
+                errors.at(i) = e.what();
+            }
+        });
     }
 
-    return;
-}
+    this->run_in_parallel(jobs);
 
-void UI::run_perf_tests(std::vector<std::string> args)
-{
-    if (num_perf_test_args != args.size())
+    /* The plotter is started one test at a time */
+    for (uint8_t test_num = 1; test_num <= num_controller_unit_tests; test_num++)
     {
-        throw invalid_ui_args("Invalid number of arguments.");
-    }
-
-    messenger.send_message("Running Performance tests", text_colour.cyan);
+        const size_t i = test_num - 1;
+        messenger.send_message("\nUnit Test " + std::to_string(test_num) + ":", text_colour.cyan);
 
-    /* Clean all outputs before running */
-    std::vector<std::string> co_args = {"clean_out"};
-    this->clean_out(co_args);
+        if (!errors.at(i).empty())
+        {
+            messenger.send_error(errors.at(i));
+            continue;
+        }
 
-    /**
-     * Generate arguments to pass to the simulation. Arguments are as follows:
-     * 
-     * args[0] - command to start sim
-     * args[1] - path to config yaml file
-     * args[2] - path to exit yaml file
-     * args[3] - silent operation, no prints to terminal during operation
-     * args[4] - request specific print regularity to the csv
-     * args[5] - print regularity of 1 ms (sim time) - this is changed by some tests.
-    **/
-    std::vector<std::string> test_args = 
-    {
-        "start_sim",
-        "",
-        "",
-        "-s",
-        "-c",
-        "1000",
-        "-sp"
-    };
+        messenger.send_message("Output written to " + output_paths.at(i));
+        this->plot_simulation_results(output_paths.at(i));
+    }
 
-    for (uint8_t test_num = 1; test_num <= 3; test_num++)//num_performance_tests; test_num++)
-    {
-        messenger.send_message("\nPerf Test " + std::to_string(test_num) + ":", text_colour.cyan);
-        messenger.send_message(perf_test_descriptions.at(test_num-1), text_colour.cyan);
-        messenger.send_message("Test will loop 10 times.", text_colour.cyan);
+    return;
+}
 
-        uint32_t duration = 0;
+void UI::run_in_parallel(const std::vector<std::function<void()>> &jobs)
+{
+    const size_t num_threads = std::min<size_t>(jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
 
-        for (uint8_t iteration = 0; iteration < 10; iteration++)
+    std::atomic<size_t> next_job{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < num_threads; t++)
+    {
+        workers.emplace_back([&jobs, &next_job]()
         {
-            // messenger.silence_csv();
-            uint32_t time_start = 0;
-            uint32_t time_end = 0;
-
-            /* Tests greater than three share a yaml file */
-            uint8_t yaml_number = (3 <= test_num) ? 3 : test_num;
-
-            if (4 == test_num)
+            for (size_t j = next_job.fetch_add(1); j < jobs.size(); j = next_job.fetch_add(1))
             {
-                test_args.back() = "1000";
-            }
-            else if (5 == test_num)
-            {
-                test_args.back() = "1";
-                messenger.silence_csv();
+                jobs.at(j)();
             }
+        });
+    }
 
-            test_args.at(1) = perf_test_config_yaml_path + std::to_string(yaml_number) + yaml_extension;
-            test_args.at(2) = perf_test_exit_yaml_path   + std::to_string(yaml_number) + yaml_extension;
+    for (std::thread &w : workers)
+    {
+        w.join();
+    }
 
-            time_start = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-            this->run_simulation(test_args);
-            time_end = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return;
+}
 
-            duration += time_end - time_start;
-        }
-        duration /= 10;
-        messenger.send_message("Average duration (ms): " + std::to_string(duration) + "\n", text_colour.yellow);
+void UI::run_perf_tests(std::vector<std::string> args)
+{
+    if (num_perf_test_args != args.size())
+    {
+        throw invalid_ui_args("Invalid number of arguments.");
     }
 
+    messenger.send_message("Running Performance tests", text_colour.cyan);
+
+    Benchmark benchmark(&messenger, perf_test_warmup_iterations, perf_test_iterations);
+    benchmark.add_perf_tests();
+    benchmark.run();
+    benchmark.write_json(Benchmark::get_default_output_path());
+
     return;
 }
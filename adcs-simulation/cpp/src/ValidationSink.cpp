@@ -0,0 +1,110 @@
+/**
+ * @file    ValidationSink.cpp
+ *
+ * @details This file implements the ValidationSink class as defined in ValidationSink.hpp
+ *
+ * @authors Aidan Sheedy
+ *
+ * Last Edited
+ * 2026-10-14
+ *
+**/
+
+#include <fstream>
+#include <sstream>
+
+#include "ValidationSink.hpp"
+
+void ValidationSink::on_simulation_state(const sim_state_view &state)
+{
+    /* Nothing is left to check once the run is asked to stop */
+    if (this->has_failed || (this->expected_alphas.size() <= this->checked))
+    {
+        return;
+    }
+
+    const Eigen::Vector3f &expected = this->expected_alphas[this->checked];
+    const Eigen::Vector3f &actual   = state.satellite().alpha_b;
+    const Eigen::Array3f  allowed   = this->relative_tolerance * expected.array().abs() + this->absolute_tolerance;
+
+    if (((expected - actual).array().abs() > allowed).any())
+    {
+        this->has_failed       = true;
+        this->failure.timestep = this->checked;
+        this->failure.time     = state.time();
+        this->failure.expected = expected;
+        this->failure.actual   = actual;
+        this->messenger->request_stop("acceleration outside the tolerance.");
+        return;
+    }
+
+    this->checked++;
+    if (this->expected_alphas.size() == this->checked)
+    {
+        this->messenger->request_stop("every expected acceleration matched.");
+    }
+}
+
+std::vector<Eigen::Vector3f> ValidationSink::read_expected_alphas(const std::string &path, size_t max_rows)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        throw invalid_expected_results(std::string("Unable to open expected results " + path).c_str());
+    }
+
+    /* Find which columns contain the accelerations */
+    std::string line;
+    std::string column_name;
+    std::getline(file, line);
+    std::stringstream ss(line);
+
+    size_t alpha_column = 0;
+    bool   alpha_column_found = false;
+    while (!alpha_column_found && std::getline(ss, column_name, ','))
+    {
+        if (std::string::npos != column_name.find("alpha x"))
+        {
+            alpha_column_found = true;
+        }
+        else
+        {
+            alpha_column++;
+        }
+    }
+
+    if (!alpha_column_found)
+    {
+        throw invalid_expected_results(std::string("Unable to find satellite acceleration column in " + path).c_str());
+    }
+
+    std::vector<Eigen::Vector3f> alphas;
+    while ((alphas.size() < max_rows) && std::getline(file, line))
+    {
+        ss = std::stringstream(line);
+        std::string contents;
+
+        size_t column;
+        for (column = 0; (column < alpha_column) && std::getline(ss, contents, ','); column++) {}
+
+        Eigen::Vector3f alpha;
+        int j;
+        for (j = 0; (column == alpha_column) && (j < 3) && std::getline(ss, contents, ','); j++)
+        {
+            alpha[j] = std::stof(contents);
+        }
+
+        if (3 != j)
+        {
+            throw invalid_expected_results(std::string(path + " is corrupted.").c_str());
+        }
+        alphas.push_back(alpha);
+    }
+
+    if (alphas.empty())
+    {
+        throw invalid_expected_results(std::string(path + " has no expected results.").c_str());
+    }
+
+    return alphas;
+}
@@ -6,15 +6,44 @@
  * @authors Lily de Loe, Aidan Sheedy
  *
  * Last Edited
- * 2022-11-07
+ * 2026-10-14
  *
 **/
 
 #include <cstdio>
+#include <string>
 
 #include "UI.hpp"
+#include "BatchRunner.hpp"
+#include "GainTuner.hpp"
+
+int main(int argc, char **argv) {
+    /* ./simulator --batch <sweep_yaml> runs a batch without starting the terminal */
+    if ((3 == argc) && ("--batch" == std::string(argv[1]))) {
+        Messenger messenger;
+        try {
+            BatchRunner batch(argv[2], &messenger);
+            batch.run();
+        } catch (adcs_exception &e) {
+            messenger.send_error(e.message());
+            return 1;
+        }
+        return 0;
+    }
+
+    /* ./simulator --tune <tuning_yaml> tunes the controller gains without starting the terminal */
+    if ((3 == argc) && ("--tune" == std::string(argv[1]))) {
+        Messenger messenger;
+        try {
+            GainTuner tuner(argv[2], &messenger);
+            tuner.run();
+        } catch (adcs_exception &e) {
+            messenger.send_error(e.message());
+            return 1;
+        }
+        return 0;
+    }
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
     UI ui;
     ui.start_ui_loop();
     return 0;